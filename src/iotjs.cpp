@@ -91,16 +91,7 @@ static bool InitIoTjs(JObject* process) {
 }
 
 
-static bool StartIoTjs(JObject* process) {
-
-  // Get jerry global object.
-  JObject global = JObject::Global();
-
-  // Create environtment.
-  Environment env(uv_default_loop());
-
-  // Bind environment to global object.
-  global.SetNative((uintptr_t)(&env), NULL);
+static bool StartIoTjs(Environment* env, JObject* process) {
 
   // Call the entry.
   // load and call iotjs.js
@@ -108,10 +99,10 @@ static bool StartIoTjs(JObject* process) {
 
   bool more;
   do {
-    more = uv_run(env.loop(), UV_RUN_ONCE);
+    more = uv_run(env->loop(), UV_RUN_ONCE);
     more |= ProcessNextTick();
     if (more == false) {
-      more = uv_loop_alive(env.loop());
+      more = uv_loop_alive(env->loop());
     }
   } while (more);
 
@@ -121,28 +112,36 @@ static bool StartIoTjs(JObject* process) {
 }
 
 
-int Start(char* src) {
+int Start(int argc, char** argv) {
   if (!InitJerry()) {
     DLOG("InitJerry failed");
     return 1;
   }
 
-  JObject* process = InitModules();
-
-  // FIXME: this should be moved to seperate function
   {
-    JObject argv;
-    JObject user_filename(src);
-    argv.SetProperty("1", user_filename);
-    process->SetProperty("argv", argv);
-  }
+    // Create environtment, modules are kept in it.
+    Environment env(uv_default_loop());
+
+    JObject* process = InitModules();
+
+    // FIXME: this should be moved to seperate function
+    {
+      // The command line, the script and its arguments start at index 1.
+      JObject jargv(JObject::Array());
+      for (int i = 0; i < argc; ++i) {
+        JObject jarg(argv[i]);
+        jargv.SetElement(i, jarg);
+      }
+      process->SetProperty("argv", jargv);
+    }
 
-  if (!StartIoTjs(process)) {
-    DLOG("StartIoTJs failed");
-    return 1;
-  }
+    if (!StartIoTjs(&env, process)) {
+      DLOG("StartIoTJs failed");
+      return 1;
+    }
 
-  CleanupModules();
+    CleanupModules();
+  }
 
   ReleaseJerry();
 
@@ -160,7 +159,7 @@ extern "C" int iotjs_entry(int argc, char** argv) {
   }
   iotjs::InitDebugSettings();
 
-  int res = iotjs::Start(argv[1]);
+  int res = iotjs::Start(argc, argv);
 
   iotjs::ReleaseDebugSettings();
 
@@ -16,6 +16,7 @@
 #include "iotjs_def.h"
 #include "iotjs_binding.h"
 
+#include <stdio.h>
 #include <string.h>
 
 
@@ -148,6 +149,14 @@ JObject JObject::Global() {
 }
 
 
+JObject JObject::Array() {
+  JObject jglobal(GetGlobal());
+  JObject jarray(jglobal.GetProperty("Array"));
+  IOTJS_ASSERT(jarray.IsFunction());
+  return jarray.CallOk(JObject::Null(), JArgList::Empty());
+}
+
+
 JObject JObject::Error(const char* message) {
   return JObject(jerry_api_create_error(JERRY_API_ERROR_COMMON, message));
 }
@@ -234,6 +243,20 @@ JObject JObject::GetProperty(const char* name) {
 }
 
 
+void JObject::SetElement(uint32_t index, JObject& val) {
+  char name[16];
+  snprintf(name, sizeof(name), "%u", index);
+  SetProperty(name, val);
+}
+
+
+JObject JObject::GetElement(uint32_t index) {
+  char name[16];
+  snprintf(name, sizeof(name), "%u", index);
+  return GetProperty(name);
+}
+
+
 void JObject::Ref() {
   if (JVAL_IS_STRING(&_obj_val)) {
     jerry_api_acquire_string(_obj_val.v_string);
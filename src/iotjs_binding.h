@@ -86,6 +86,9 @@ class JObject {
   // Get the javascript global object.
   static JObject Global();
 
+  // Create a javascript array object.
+  static JObject Array();
+
   // Create a javascript error object.
   static JObject Error(const char* message = NULL);
   static JObject EvalError(const char* message = NULL);
@@ -131,6 +134,10 @@ class JObject {
   void SetProperty(const char* name, JRawValueType val);
   JObject GetProperty(const char* name);
 
+  // Sets & gets element for the javascript array object.
+  void SetElement(uint32_t index, JObject& val);
+  JObject GetElement(uint32_t index);
+
   // Sets & gets native data for the javascript object.
   void SetNative(uintptr_t ptr, JFreeHandlerType free_handler);
   uintptr_t GetNative();
@@ -0,0 +1,174 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "iotjs_def.h"
+#include "iotjs_buffer_pool.h"
+
+#include "iotjs_module_buffer.h"
+
+
+namespace iotjs {
+
+
+// Buffers cut from a slab start at this alignment.
+#define SLAB_ALIGN 8
+
+
+BufferSlab::BufferSlab(BufferPool* pool, size_t size)
+    : _pool(pool)
+    , _data(NULL)
+    , _size(size)
+    , _used(0)
+    , _refs(0)
+    , _retired(false) {
+  _data = AllocBuffer(size);
+  IOTJS_ASSERT(_data != NULL);
+}
+
+
+BufferSlab::~BufferSlab() {
+  IOTJS_ASSERT(_refs == 0);
+  ReleaseBuffer(_data);
+}
+
+
+void BufferSlab::Ref() {
+  _refs += 1;
+}
+
+
+void BufferSlab::Unref() {
+  IOTJS_ASSERT(_refs > 0);
+  _refs -= 1;
+
+  if (_refs == 0 && _retired) {
+    if (_pool != NULL) {
+      _pool->Recycle(this);
+    } else {
+      // The pool is gone.
+      delete this;
+    }
+  }
+}
+
+
+BufferPool::BufferPool(size_t slab_size, int max_free_slabs)
+    : _slab_size(slab_size)
+    , _max_free_slabs(max_free_slabs)
+    , _current(NULL) {
+}
+
+
+BufferPool::~BufferPool() {
+  if (_current != NULL) {
+    Retire(_current);
+    _current = NULL;
+  }
+  while (!_free_slabs.IsEmpty()) {
+    delete _free_slabs.head()->data;
+    _free_slabs.RemoveHead();
+  }
+  // Slabs still referred by Buffer objects delete themselves later.
+  while (!_busy_slabs.IsEmpty()) {
+    _busy_slabs.head()->data->_pool = NULL;
+    _busy_slabs.RemoveHead();
+  }
+}
+
+
+void BufferPool::Alloc(size_t size, size_t min_size, uv_buf_t* buf) {
+  IOTJS_ASSERT(min_size <= size);
+
+  if (_current != NULL && _current->available() < min_size) {
+    Retire(_current);
+    _current = NULL;
+  }
+
+  if (_current == NULL) {
+    if (size > _slab_size) {
+      _current = new BufferSlab(this, size);
+    } else if (!_free_slabs.IsEmpty()) {
+      _current = _free_slabs.head()->data;
+      _free_slabs.RemoveHead();
+    } else {
+      _current = new BufferSlab(this, _slab_size);
+    }
+  }
+
+  size_t available = _current->available();
+
+  buf->base = _current->_data + _current->_used;
+  buf->len = size < available ? size : available;
+}
+
+
+JObject BufferPool::Take(const uv_buf_t* buf, size_t nread) {
+  BufferSlab* slab = _current;
+  IOTJS_ASSERT(slab != NULL);
+  IOTJS_ASSERT(buf->base == slab->_data + slab->_used);
+  IOTJS_ASSERT(nread > 0 && nread <= buf->len);
+
+  size_t used = (nread + SLAB_ALIGN - 1) & ~(SLAB_ALIGN - 1);
+  slab->_used += used < slab->available() ? used : slab->available();
+
+  JObject jbuffer(CreateBuffer(0));
+  Buffer::FromJBuffer(jbuffer)->Adopt(slab, buf->base, nread);
+
+  return jbuffer;
+}
+
+
+void BufferPool::Retire(BufferSlab* slab) {
+  IOTJS_ASSERT(!slab->_retired);
+  slab->_retired = true;
+
+  if (slab->_refs == 0) {
+    Recycle(slab);
+  } else {
+    _busy_slabs.InsertTail(slab);
+  }
+}
+
+
+void BufferPool::Recycle(BufferSlab* slab) {
+  IOTJS_ASSERT(slab->_retired && slab->_refs == 0);
+
+  for (LinkedListItem<BufferSlab*>* item = _busy_slabs.head();
+       item != NULL;
+       item = item->next) {
+    if (item->data == slab) {
+      _busy_slabs.RemoveItem(item);
+      break;
+    }
+  }
+
+  if (slab->_size != _slab_size ||
+      _free_slabs.size() >= static_cast<size_t>(_max_free_slabs)) {
+    delete slab;
+    return;
+  }
+
+  slab->_used = 0;
+  slab->_retired = false;
+  _free_slabs.InsertHead(slab);
+}
+
+
+BufferPool* GetReadBufferPool() {
+  return Environment::GetEnv()->read_buffer_pool();
+}
+
+
+} // namespace iotjs
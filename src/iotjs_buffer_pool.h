@@ -0,0 +1,95 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IOTJS_BUFFER_POOL_H
+#define IOTJS_BUFFER_POOL_H
+
+
+#include <uv.h>
+
+#include "iotjs_binding.h"
+#include "iotjs_util.h"
+
+
+namespace iotjs {
+
+
+class BufferPool;
+
+
+// Chunk of memory that read buffers are cut from.
+// Every Buffer object referring part of the slab holds a reference to it. The
+// slab goes back to its pool when the last of them is freed by GC.
+class BufferSlab {
+ public:
+  BufferSlab(BufferPool* pool, size_t size);
+  ~BufferSlab();
+
+  char* data() { return _data; }
+  size_t size() { return _size; }
+  size_t available() { return _size - _used; }
+
+  void Ref();
+  void Unref();
+
+ private:
+  friend class BufferPool;
+
+  BufferPool* _pool;
+  char* _data;
+  size_t _size;
+  size_t _used;
+  int _refs;
+  bool _retired;
+};
+
+
+// Read buffer allocator shared by socket handles.
+// Reads are done into the free area of the current slab and the filled part is
+// handed over to javascript as a Buffer object without copying.
+class BufferPool {
+ public:
+  BufferPool(size_t slab_size, int max_free_slabs);
+  ~BufferPool();
+
+  // Provides memory for reading up to `size` bytes, not less than `min_size`.
+  void Alloc(size_t size, size_t min_size, uv_buf_t* buf);
+
+  // Creates a Buffer object on the first `nread` bytes of `buf` given by the
+  // last `Alloc()`.
+  JObject Take(const uv_buf_t* buf, size_t nread);
+
+  // Called when no Buffer object refers `slab` anymore.
+  void Recycle(BufferSlab* slab);
+
+ private:
+  void Retire(BufferSlab* slab);
+
+  size_t _slab_size;
+  int _max_free_slabs;
+  BufferSlab* _current;
+  LinkedList<BufferSlab*> _free_slabs;
+  LinkedList<BufferSlab*> _busy_slabs;
+};
+
+
+// Pool for socket read buffers.
+BufferPool* GetReadBufferPool();
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_BUFFER_POOL_H */
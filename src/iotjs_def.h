@@ -27,6 +27,113 @@
 #endif
 
 
+// Size of the memory chunks that socket read buffers are cut from, and number
+// of unused chunks kept for reuse.
+#ifndef IOTJS_BUFFER_SLAB_SIZE
+ #ifdef __NUTTX__
+  #define IOTJS_BUFFER_SLAB_SIZE (2 * IOTJS_MAX_READ_BUFFER_SIZE)
+ #else
+  #define IOTJS_BUFFER_SLAB_SIZE (128 * 1024)
+ #endif
+#endif
+
+#ifndef IOTJS_BUFFER_POOL_MAX_FREE
+ #ifdef __NUTTX__
+  #define IOTJS_BUFFER_POOL_MAX_FREE 1
+ #else
+  #define IOTJS_BUFFER_POOL_MAX_FREE 2
+ #endif
+#endif
+
+// Maximum number of datagrams delivered to javascript with a single callback.
+#ifndef IOTJS_UDP_MAX_BATCH
+ #define IOTJS_UDP_MAX_BATCH 32
+#endif
+
+
+// Longest period in milliseconds of the timer checking stream idle timeouts.
+#ifndef IOTJS_IDLE_SWEEP_INTERVAL
+ #define IOTJS_IDLE_SWEEP_INTERVAL 1000
+#endif
+
+
+// Deepest nesting of arrays and objects the JSON parser and serializer handle.
+#ifndef IOTJS_JSON_MAX_DEPTH
+ #ifdef __NUTTX__
+  #define IOTJS_JSON_MAX_DEPTH 32
+ #else
+  #define IOTJS_JSON_MAX_DEPTH 256
+ #endif
+#endif
+
+
+// Largest start line and header section of an HTTP message accepted.
+#ifndef IOTJS_HTTP_MAX_HEADER_SIZE
+ #ifdef __NUTTX__
+  #define IOTJS_HTTP_MAX_HEADER_SIZE (8 * 1024)
+ #else
+  #define IOTJS_HTTP_MAX_HEADER_SIZE (80 * 1024)
+ #endif
+#endif
+
+
+// Largest number of fields of a header template written to a stream.
+#ifndef IOTJS_TEMPLATE_MAX_FIELDS
+ #define IOTJS_TEMPLATE_MAX_FIELDS 8
+#endif
+
+
+// Size of the blocks data is compressed in, at most 64 KB. Each block is
+// compressed independently.
+#ifndef IOTJS_COMPRESS_BLOCK_SIZE
+ #ifdef __NUTTX__
+  #define IOTJS_COMPRESS_BLOCK_SIZE (16 * 1024)
+ #else
+  #define IOTJS_COMPRESS_BLOCK_SIZE (64 * 1024)
+ #endif
+#endif
+
+// Largest data size of a frame decompressed at once into a single buffer.
+#ifndef IOTJS_DECOMPRESS_MAX_SIZE
+ #ifdef __NUTTX__
+  #define IOTJS_DECOMPRESS_MAX_SIZE (256 * 1024)
+ #else
+  #define IOTJS_DECOMPRESS_MAX_SIZE (64 * 1024 * 1024)
+ #endif
+#endif
+
+
+// Maximum number of file system requests dispatched to the threadpool at a
+// time, and maximum number of those that may target the same file descriptor.
+#ifndef IOTJS_FS_MAX_INFLIGHT
+ #ifdef __NUTTX__
+  #define IOTJS_FS_MAX_INFLIGHT 1
+ #else
+  #define IOTJS_FS_MAX_INFLIGHT 4
+ #endif
+#endif
+
+#ifndef IOTJS_FS_MAX_INFLIGHT_PER_FD
+ #define IOTJS_FS_MAX_INFLIGHT_PER_FD 1
+#endif
+
+// Maximum number of queued writes merged into a single vectored write.
+#ifndef IOTJS_FS_MAX_COALESCE
+ #define IOTJS_FS_MAX_COALESCE 16
+#endif
+
+
+// Largest message a worker and its parent may send each other, a larger size
+// in a message header is taken for a corrupt channel.
+#ifndef IOTJS_WORKER_MAX_MESSAGE
+ #ifdef __NUTTX__
+  #define IOTJS_WORKER_MAX_MESSAGE (1024 * 1024)
+ #else
+  #define IOTJS_WORKER_MAX_MESSAGE (64 * 1024 * 1024)
+ #endif
+#endif
+
+
 #ifndef IOTJS_ASSERT
  #ifdef NDEBUG
   #define IOTJS_ASSERT(x) ((void)(x))
@@ -13,20 +13,163 @@
  * limitations under the License.
  */
 
-#include "iotjs_binding.h"
-
+#include "iotjs_def.h"
 #include "iotjs_env.h"
 
+#include "iotjs_buffer_pool.h"
+#include "iotjs_fs_scheduler.h"
+#include "iotjs_streamwrap.h"
+
 
 namespace iotjs {
 
+
+Environment* Environment::_current = NULL;
+
+
 Environment::Environment(uv_loop_t* loop)
-  : _loop(loop) {
+  : _loop(loop)
+  , _read_buffer_pool(NULL)
+  , _fs_scheduler(NULL)
+  , _idle_interval(0) {
+  for (int i = 0; i < MODULE_COUNT; ++i) {
+    _modules[i].kind = static_cast<ModuleKind>(i);
+    _modules[i].module = NULL;
+    _modules[i].fn_register = NULL;
+    _modules[i].state = NULL;
+  }
+
+  _idle_timer = new uv_timer_t;
+  uv_timer_init(_loop, _idle_timer);
+  uv_unref(reinterpret_cast<uv_handle_t*>(_idle_timer));
+  _idle_timer->data = this;
+
+  _current = this;
+}
+
+
+static void AfterIdleTimerClose(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_timer_t*>(handle);
+}
+
+
+Environment::~Environment() {
+  // Streams still watched are freed later.
+  while (!_idle_streams.IsEmpty()) {
+    _idle_streams.head()->data->SetIdleTimeout(0);
+  }
+
+  // The loop may still refer the timer, it is freed once the close completes.
+  uv_close(reinterpret_cast<uv_handle_t*>(_idle_timer), AfterIdleTimerClose);
+
+  // Buffers still referring the pool release their memory by themselves.
+  if (_read_buffer_pool != NULL) {
+    delete _read_buffer_pool;
+  }
+
+  if (_fs_scheduler != NULL) {
+    delete _fs_scheduler;
+  }
+
+  if (_current == this) {
+    _current = NULL;
+  }
+}
+
+
+BufferPool* Environment::read_buffer_pool() {
+  if (_read_buffer_pool == NULL) {
+    _read_buffer_pool = new BufferPool(IOTJS_BUFFER_SLAB_SIZE,
+                                       IOTJS_BUFFER_POOL_MAX_FREE);
+  }
+  return _read_buffer_pool;
+}
+
+
+static void OnIdleTimer(uv_timer_t* handle) {
+  Environment* env = reinterpret_cast<Environment*>(handle->data);
+  env->SweepIdle();
 }
 
-Environment* Environment::GetEnv() {
-  JObject global = JObject::Global();
-  return (Environment*)global.GetNative();
+
+// Timeouts fire at most a quarter late.
+static uint64_t IdleInterval(uint64_t timeout) {
+  uint64_t interval = timeout / 4;
+  if (interval < 1) {
+    interval = 1;
+  } else if (interval > IOTJS_IDLE_SWEEP_INTERVAL) {
+    interval = IOTJS_IDLE_SWEEP_INTERVAL;
+  }
+  return interval;
 }
 
+
+LinkedListItem<StreamWrap*>* Environment::WatchIdle(StreamWrap* stream,
+                                                    uint64_t timeout) {
+  uint64_t interval = IdleInterval(timeout);
+
+  if (_idle_streams.IsEmpty() || interval < _idle_interval) {
+    _idle_interval = interval;
+    uv_timer_start(_idle_timer, OnIdleTimer, interval, interval);
+  }
+
+  return _idle_streams.InsertTail(stream);
+}
+
+
+void Environment::UnwatchIdle(LinkedListItem<StreamWrap*>* item) {
+  _idle_streams.RemoveItem(item);
+  if (_idle_streams.IsEmpty()) {
+    uv_timer_stop(_idle_timer);
+    return;
+  }
+
+  // The stream may have had the shortest timeout, sweep less often then.
+  uint64_t interval = IOTJS_IDLE_SWEEP_INTERVAL;
+  for (LinkedListItem<StreamWrap*>* it = _idle_streams.head();
+       it != NULL;
+       it = it->next) {
+    uint64_t stream_interval = IdleInterval(it->data->idle_timeout());
+    if (stream_interval < interval) {
+      interval = stream_interval;
+    }
+  }
+
+  if (interval != _idle_interval) {
+    _idle_interval = interval;
+    uv_timer_start(_idle_timer, OnIdleTimer, interval, interval);
+  }
+}
+
+
+void Environment::SweepIdle() {
+  uint64_t now = uv_now(_loop);
+
+  // Callbacks may close or unwatch any stream, collect the idle ones first.
+  // The array also keeps them from being freed meanwhile.
+  JObject* jidle = NULL;
+  int count = 0;
+
+  for (LinkedListItem<StreamWrap*>* item = _idle_streams.head();
+       item != NULL;
+       item = item->next) {
+    if (item->data->IsIdle(now)) {
+      if (jidle == NULL) {
+        jidle = new JObject(JObject::Array());
+      }
+      jidle->SetElement(count++, item->data->jnative());
+    }
+  }
+
+  for (int i = 0; i < count; ++i) {
+    JObject jstream = jidle->GetElement(i);
+    StreamWrap::FromJObject(&jstream)->OnIdleTimeout(now);
+  }
+
+  if (jidle != NULL) {
+    delete jidle;
+  }
+}
+
+
 } // namespace iotjs
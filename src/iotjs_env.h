@@ -24,18 +24,58 @@
 
 namespace iotjs {
 
+class BufferPool;
+class FsScheduler;
 class ReqWrap;
+class StreamWrap;
 
+// State of a running instance: the event loop, builtin modules and resources
+// shared by handles.
 class Environment {
  public:
+  // The environment becomes the current one until destroyed.
   Environment(uv_loop_t* loop);
+  ~Environment();
 
-  static Environment* GetEnv();
+  static Environment* GetEnv() {
+    IOTJS_ASSERT(_current != NULL);
+    return _current;
+  }
 
   uv_loop_t* loop() { return _loop; }
 
+  Module* GetModule(ModuleKind kind) {
+    IOTJS_ASSERT(kind < MODULE_COUNT);
+    return &_modules[kind];
+  }
+  Module* modules() { return _modules; }
+
+  // Pool for socket read buffers.
+  BufferPool* read_buffer_pool();
+
+  // Scheduler of fs requests, created by the fs module.
+  FsScheduler* fs_scheduler() { return _fs_scheduler; }
+  void set_fs_scheduler(FsScheduler* scheduler) { _fs_scheduler = scheduler; }
+
+  // Streams with an idle timeout, checked together by a single timer.
+  LinkedListItem<StreamWrap*>* WatchIdle(StreamWrap* stream, uint64_t timeout);
+  void UnwatchIdle(LinkedListItem<StreamWrap*>* item);
+
+  // Calls back streams idle for longer than their timeout.
+  void SweepIdle();
+
  private:
+  static Environment* _current;
+
   uv_loop_t* _loop;
+
+  Module _modules[MODULE_COUNT];
+  BufferPool* _read_buffer_pool;
+  FsScheduler* _fs_scheduler;
+
+  uv_timer_t* _idle_timer;
+  uint64_t _idle_interval;
+  LinkedList<StreamWrap*> _idle_streams;
 }; // class Environment
 
 } // namespace iotjs
@@ -0,0 +1,398 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "iotjs_def.h"
+#include "iotjs_fs_scheduler.h"
+
+#include <string.h>
+
+
+namespace iotjs {
+
+
+FsReqWrap::FsReqWrap(JObject& jcallback)
+    : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data))
+    , _type(UV_FS_UNKNOWN)
+    , _path(NULL)
+    , _fd(-1)
+    , _flags(0)
+    , _mode(0)
+    , _bufs(&_buf)
+    , _nbufs(0)
+    , _position(-1)
+    , _queued_time(0) {
+}
+
+
+FsReqWrap::~FsReqWrap() {
+  uv_fs_req_cleanup(&_data);
+  if (_path != NULL) {
+    ReleaseBuffer(_path);
+  }
+  if (_bufs != &_buf) {
+    delete [] _bufs;
+  }
+}
+
+
+size_t FsReqWrap::length() {
+  size_t len = 0;
+  for (unsigned int i = 0; i < _nbufs; ++i) {
+    len += _bufs[i].len;
+  }
+  return len;
+}
+
+
+void FsReqWrap::set_open_args(const char* path, int flags, int mode) {
+  IOTJS_ASSERT(_path == NULL);
+  _type = UV_FS_OPEN;
+  _path = AllocBuffer(strlen(path) + 1);
+  strcpy(_path, path);
+  _flags = flags;
+  _mode = mode;
+}
+
+
+void FsReqWrap::set_close_args(int fd) {
+  _type = UV_FS_CLOSE;
+  _fd = fd;
+}
+
+
+void FsReqWrap::set_read_args(int fd,
+                              const uv_buf_t bufs[],
+                              unsigned int nbufs,
+                              int64_t position) {
+  _type = UV_FS_READ;
+  _fd = fd;
+  _position = position;
+  SetBufs(bufs, nbufs);
+}
+
+
+void FsReqWrap::set_write_args(int fd,
+                               const uv_buf_t bufs[],
+                               unsigned int nbufs,
+                               int64_t position) {
+  _type = UV_FS_WRITE;
+  _fd = fd;
+  _position = position;
+  SetBufs(bufs, nbufs);
+}
+
+
+void FsReqWrap::set_stat_args(const char* path) {
+  IOTJS_ASSERT(_path == NULL);
+  _type = UV_FS_STAT;
+  _path = AllocBuffer(strlen(path) + 1);
+  strcpy(_path, path);
+}
+
+
+void FsReqWrap::SetBufs(const uv_buf_t bufs[], unsigned int nbufs) {
+  IOTJS_ASSERT(_bufs == &_buf && _nbufs == 0);
+  if (nbufs > 1) {
+    _bufs = new uv_buf_t[nbufs];
+  }
+  for (unsigned int i = 0; i < nbufs; ++i) {
+    _bufs[i] = bufs[i];
+  }
+  _nbufs = nbufs;
+}
+
+
+bool FsReqWrap::CanCoalesce(FsReqWrap* next) {
+  if (_type != UV_FS_WRITE || next->_type != UV_FS_WRITE) {
+    return false;
+  }
+  if (_fd != next->_fd) {
+    return false;
+  }
+  if (_coalesced.size() + 1 >= IOTJS_FS_MAX_COALESCE) {
+    return false;
+  }
+  if (_position < 0) {
+    // Writing at the current position, next one should do the same.
+    return next->_position < 0;
+  }
+  return next->_position == _position + static_cast<int64_t>(length());
+}
+
+
+void FsReqWrap::Coalesce(FsReqWrap* next) {
+  IOTJS_ASSERT(CanCoalesce(next));
+
+  uv_buf_t* bufs = new uv_buf_t[_nbufs + next->_nbufs];
+  memcpy(bufs, _bufs, sizeof(uv_buf_t) * _nbufs);
+  memcpy(bufs + _nbufs, next->_bufs, sizeof(uv_buf_t) * next->_nbufs);
+
+  if (_bufs != &_buf) {
+    delete [] _bufs;
+  }
+  _bufs = bufs;
+  _nbufs += next->_nbufs;
+
+  _coalesced.InsertTail(next);
+}
+
+
+int FsReqWrap::Dispatch(uv_loop_t* loop, uv_fs_cb cb) {
+  switch (_type) {
+    case UV_FS_OPEN:
+      return uv_fs_open(loop, &_data, _path, _flags, _mode, cb);
+    case UV_FS_CLOSE:
+      return uv_fs_close(loop, &_data, _fd, cb);
+    case UV_FS_READ:
+      return uv_fs_read(loop, &_data, _fd, _bufs, _nbufs, _position, cb);
+    case UV_FS_WRITE:
+      return uv_fs_write(loop, &_data, _fd, _bufs, _nbufs, _position, cb);
+    case UV_FS_STAT:
+      return uv_fs_stat(loop, &_data, _path, cb);
+    default:
+      IOTJS_ASSERT(!"Unknown fs request type");
+      return UV_EINVAL;
+  }
+}
+
+
+FsScheduler::FsScheduler(uv_loop_t* loop, uv_fs_cb after)
+    : _loop(loop)
+    , _after(after)
+    , _dispatching(false) {
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+
+FsScheduler::~FsScheduler() {
+  for (int i = 0; i < FS_PRIORITY_COUNT; ++i) {
+    IOTJS_ASSERT(_lanes[i].IsEmpty());
+  }
+  while (!_fd_states.IsEmpty()) {
+    delete _fd_states.head()->data;
+    _fd_states.RemoveHead();
+  }
+}
+
+
+FsFdState* FsScheduler::GetFdState(int fd, bool create) {
+  for (LinkedListItem<FsFdState*>* item = _fd_states.head();
+       item != NULL;
+       item = item->next) {
+    if (item->data->fd == fd) {
+      return item->data;
+    }
+  }
+
+  if (!create) {
+    return NULL;
+  }
+
+  FsFdState* state = new FsFdState;
+  state->fd = fd;
+  state->inflight = 0;
+  state->pending = 0;
+  state->priority = FS_PRIORITY_NORMAL;
+  _fd_states.InsertHead(state);
+
+  return state;
+}
+
+
+// Forget about the file descriptor if nothing is left to remember.
+void FsScheduler::MaybeReleaseFdState(FsFdState* state) {
+  if (state->inflight > 0 ||
+      state->pending > 0 ||
+      state->priority != FS_PRIORITY_NORMAL) {
+    return;
+  }
+
+  for (LinkedListItem<FsFdState*>* item = _fd_states.head();
+       item != NULL;
+       item = item->next) {
+    if (item->data == state) {
+      _fd_states.RemoveItem(item);
+      break;
+    }
+  }
+  delete state;
+}
+
+
+void FsScheduler::Enqueue(FsReqWrap* req_wrap) {
+  // Requests made with a path, open and stat, are not bound to a descriptor
+  // yet and always go to the normal lane.
+  FsPriority priority = FS_PRIORITY_NORMAL;
+
+  if (req_wrap->fd() >= 0) {
+    FsFdState* state = GetFdState(req_wrap->fd(), true);
+    state->pending += 1;
+    priority = state->priority;
+  }
+
+  req_wrap->set_queued_time(uv_hrtime());
+  _lanes[priority].InsertTail(req_wrap);
+  _stats.queued[priority] += 1;
+
+  DispatchPending();
+}
+
+
+void FsScheduler::Complete(FsReqWrap* req_wrap) {
+  IOTJS_ASSERT(_stats.inflight > 0);
+  _stats.inflight -= 1;
+
+  if (req_wrap->fd() >= 0) {
+    FsFdState* state = GetFdState(req_wrap->fd(), false);
+    IOTJS_ASSERT(state != NULL && state->inflight > 0);
+    state->inflight -= 1;
+    if (req_wrap->type() == UV_FS_CLOSE && req_wrap->data()->result == 0) {
+      // The descriptor could be reused for another file.
+      state->priority = FS_PRIORITY_NORMAL;
+    }
+    MaybeReleaseFdState(state);
+  }
+
+  DispatchPending();
+}
+
+
+void FsScheduler::SetPriority(int fd, FsPriority priority) {
+  IOTJS_ASSERT(priority < FS_PRIORITY_COUNT);
+  FsFdState* state = GetFdState(fd, true);
+  state->priority = priority;
+  MaybeReleaseFdState(state);
+}
+
+
+void FsScheduler::Closed(int fd) {
+  FsFdState* state = GetFdState(fd, false);
+  if (state != NULL) {
+    state->priority = FS_PRIORITY_NORMAL;
+    MaybeReleaseFdState(state);
+  }
+}
+
+
+bool FsScheduler::IsDispatchable(FsReqWrap* req_wrap) {
+  if (req_wrap->fd() < 0) {
+    return true;
+  }
+  FsFdState* state = GetFdState(req_wrap->fd(), false);
+  IOTJS_ASSERT(state != NULL);
+  return state->inflight < IOTJS_FS_MAX_INFLIGHT_PER_FD;
+}
+
+
+// Takes the first dispatchable request, high priority lane first, merging
+// writes queued right behind it.
+FsReqWrap* FsScheduler::TakeNext() {
+  for (int i = FS_PRIORITY_COUNT - 1; i >= 0; --i) {
+    LinkedList<FsReqWrap*>& lane = _lanes[i];
+
+    for (LinkedListItem<FsReqWrap*>* item = lane.head();
+         item != NULL;
+         item = item->next) {
+      FsReqWrap* req_wrap = item->data;
+      if (!IsDispatchable(req_wrap)) {
+        continue;
+      }
+
+      LinkedListItem<FsReqWrap*>* next = item->next;
+      lane.RemoveItem(item);
+      _stats.queued[i] -= 1;
+
+      while (next != NULL) {
+        FsReqWrap* next_req = next->data;
+        if (next_req->fd() != req_wrap->fd()) {
+          next = next->next;
+          continue;
+        }
+        if (!req_wrap->CanCoalesce(next_req)) {
+          break;
+        }
+        LinkedListItem<FsReqWrap*>* following = next->next;
+        lane.RemoveItem(next);
+        _stats.queued[i] -= 1;
+        req_wrap->Coalesce(next_req);
+        next = following;
+      }
+
+      return req_wrap;
+    }
+  }
+
+  return NULL;
+}
+
+
+void FsScheduler::DispatchPending() {
+  // `Dispatch()` may complete a request synchronously on failure, which
+  // brings us here again.
+  if (_dispatching) {
+    return;
+  }
+  _dispatching = true;
+
+  while (_stats.inflight < IOTJS_FS_MAX_INFLIGHT) {
+    FsReqWrap* req_wrap = TakeNext();
+    if (req_wrap == NULL) {
+      break;
+    }
+    Dispatch(req_wrap);
+  }
+
+  _dispatching = false;
+}
+
+
+void FsScheduler::Dispatch(FsReqWrap* req_wrap) {
+  uint64_t now = uv_hrtime();
+  int count = 1 + req_wrap->coalesced().size();
+
+  double wait = static_cast<double>(now - req_wrap->queued_time());
+  for (LinkedListItem<FsReqWrap*>* item = req_wrap->coalesced().head();
+       item != NULL;
+       item = item->next) {
+    wait += static_cast<double>(now - item->data->queued_time());
+  }
+  double max_wait = static_cast<double>(now - req_wrap->queued_time());
+  if (max_wait > _stats.max_wait) {
+    _stats.max_wait = max_wait;
+  }
+
+  _stats.total_wait += wait;
+  _stats.dispatched += count;
+  _stats.coalesced += count - 1;
+  _stats.inflight += 1;
+
+  if (req_wrap->fd() >= 0) {
+    FsFdState* state = GetFdState(req_wrap->fd(), false);
+    IOTJS_ASSERT(state != NULL);
+    state->pending -= count;
+    state->inflight += 1;
+  }
+
+  req_wrap->Dispatched();
+
+  int err = req_wrap->Dispatch(_loop, _after);
+  if (err < 0) {
+    req_wrap->data()->result = err;
+    _after(req_wrap->data());
+  }
+}
+
+
+} // namespace iotjs
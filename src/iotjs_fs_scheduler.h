@@ -0,0 +1,163 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IOTJS_FS_SCHEDULER_H
+#define IOTJS_FS_SCHEDULER_H
+
+
+#include <uv.h>
+
+#include "iotjs_binding.h"
+#include "iotjs_reqwrap.h"
+#include "iotjs_util.h"
+
+
+namespace iotjs {
+
+
+enum FsPriority {
+  FS_PRIORITY_NORMAL,
+  FS_PRIORITY_HIGH,
+  FS_PRIORITY_COUNT
+};
+
+
+// File system request wrapper.
+// Arguments of the operation are kept in the wrapper so that the request can
+// be dispatched to the threadpool later than it was made.
+class FsReqWrap : public ReqWrap {
+ public:
+  explicit FsReqWrap(JObject& jcallback);
+  virtual ~FsReqWrap();
+
+  uv_fs_t* data() { return &_data; }
+
+  uv_fs_type type() { return _type; }
+  int fd() { return _fd; }
+  int64_t position() { return _position; }
+  size_t length();
+
+  void set_open_args(const char* path, int flags, int mode);
+  void set_close_args(int fd);
+  void set_read_args(int fd,
+                     const uv_buf_t bufs[],
+                     unsigned int nbufs,
+                     int64_t position);
+  void set_write_args(int fd,
+                      const uv_buf_t bufs[],
+                      unsigned int nbufs,
+                      int64_t position);
+  void set_stat_args(const char* path);
+
+  // Returns true if `next` writes right after this request so that both can
+  // be done with a single vectored write.
+  bool CanCoalesce(FsReqWrap* next);
+
+  // Appends buffers of `next` to this request. `next` will be completed
+  // together with this request.
+  void Coalesce(FsReqWrap* next);
+
+  // Requests merged into this one.
+  LinkedList<FsReqWrap*>& coalesced() { return _coalesced; }
+
+  // Starts the operation on the threadpool.
+  int Dispatch(uv_loop_t* loop, uv_fs_cb cb);
+
+  uint64_t queued_time() { return _queued_time; }
+  void set_queued_time(uint64_t time) { _queued_time = time; }
+
+ private:
+  void SetBufs(const uv_buf_t bufs[], unsigned int nbufs);
+
+  uv_fs_t _data;
+  uv_fs_type _type;
+  char* _path;
+  int _fd;
+  int _flags;
+  int _mode;
+  uv_buf_t _buf;
+  uv_buf_t* _bufs;
+  unsigned int _nbufs;
+  int64_t _position;
+  uint64_t _queued_time;
+  LinkedList<FsReqWrap*> _coalesced;
+};
+
+
+// Scheduling state of a file descriptor.
+struct FsFdState {
+  int fd;
+  int inflight;
+  int pending;
+  FsPriority priority;
+};
+
+
+// Counters of the scheduler.
+struct FsSchedulerStats {
+  uint32_t queued[FS_PRIORITY_COUNT];
+  uint32_t inflight;
+  double dispatched;
+  double coalesced;
+  double total_wait;  // nanoseconds
+  double max_wait;  // nanoseconds
+};
+
+
+// Scheduler placed in front of `uv_fs_*` asynchronous calls.
+// Limits the number of requests in the threadpool - in total and per file
+// descriptor - serves the high priority lane first, and merges adjacent
+// writes to the same file descriptor queued meanwhile.
+class FsScheduler {
+ public:
+  FsScheduler(uv_loop_t* loop, uv_fs_cb after);
+  ~FsScheduler();
+
+  void Enqueue(FsReqWrap* req_wrap);
+
+  // Must be called when the request dispatched by this scheduler completed,
+  // before calling back.
+  void Complete(FsReqWrap* req_wrap);
+
+  void SetPriority(int fd, FsPriority priority);
+
+  // Must be called when the file descriptor was closed without going through
+  // this scheduler, the descriptor could be reused for another file.
+  void Closed(int fd);
+
+  FsSchedulerStats& stats() { return _stats; }
+
+ private:
+  FsFdState* GetFdState(int fd, bool create);
+  void MaybeReleaseFdState(FsFdState* state);
+
+  bool IsDispatchable(FsReqWrap* req_wrap);
+  FsReqWrap* TakeNext();
+  void DispatchPending();
+  void Dispatch(FsReqWrap* req_wrap);
+
+  uv_loop_t* _loop;
+  uv_fs_cb _after;
+  bool _dispatching;
+  LinkedList<FsReqWrap*> _lanes[FS_PRIORITY_COUNT];
+  LinkedList<FsFdState*> _fd_states;
+  FsSchedulerStats _stats;
+};
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_FS_SCHEDULER_H */
@@ -45,6 +45,7 @@ class HandleWrap : public JObjectWrap {
   // Javascript object that holds the native object.
   JObject& jholder();
   void set_jholder(JObject& jholder);
+  bool has_jholder() { return _jholder != NULL; }
 
   typedef void (*OnCloseHandler)(uv_handle_t*);
 
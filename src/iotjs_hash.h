@@ -0,0 +1,84 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IOTJS_HASH_H
+#define IOTJS_HASH_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+namespace iotjs {
+
+
+enum HashAlgorithm {
+  HASH_CRC32,
+  HASH_MD5,
+  HASH_SHA1,
+  HASH_SHA256,
+  HASH_INVALID,
+};
+
+
+// Largest digest and block sizes of the supported algorithms.
+#define HASH_MAX_DIGEST_SIZE 32
+#define HASH_MAX_BLOCK_SIZE 64
+
+
+// Incremental message digest. Data is hashed straight from the memory given
+// to `Update()`, only the tail of a block is kept between calls.
+// SHA-1 and SHA-256 use the SHA extensions of x86 processors when available,
+// CRC32 uses the CRC32 instructions of ARMv8 processors built with them.
+class HashContext {
+ public:
+  explicit HashContext(HashAlgorithm algorithm);
+
+  // Returns the algorithm of `name`, like "sha256", or `HASH_INVALID`.
+  static HashAlgorithm FindAlgorithm(const char* name);
+
+  static size_t DigestSize(HashAlgorithm algorithm);
+  static size_t BlockSize(HashAlgorithm algorithm);
+
+  HashAlgorithm algorithm() { return _algorithm; }
+
+  // Starts a new message.
+  void Reset();
+
+  void Update(const uint8_t* data, size_t length);
+
+  // Writes the digest of the message to `out`, `DigestSize()` bytes.
+  // CRC32 is written in big endian order.
+  void Final(uint8_t* out);
+
+ private:
+  void ProcessBlocks(const uint8_t* blocks, size_t count);
+
+  HashAlgorithm _algorithm;
+  uint32_t _state[8];
+  uint64_t _length;
+  uint8_t _block[HASH_MAX_BLOCK_SIZE];
+  size_t _block_length;
+};
+
+
+// Updates `crc` with `length` bytes of `data`. Start with zero.
+uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t length);
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_HASH_H */
@@ -0,0 +1,380 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "iotjs_lz.h"
+
+#include <string.h>
+
+
+namespace iotjs {
+
+
+// Number of bits of the hash of four bytes, the table of positions takes
+// two bytes per entry on the stack.
+#ifndef IOTJS_LZ_HASH_LOG
+ #ifdef __NUTTX__
+  #define IOTJS_LZ_HASH_LOG 10
+ #else
+  #define IOTJS_LZ_HASH_LOG 12
+ #endif
+#endif
+
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+
+// The last five bytes are always literals, and the last match starts at
+// least twelve bytes before the end.
+#define LZ_LAST_LITERALS 5
+#define LZ_MATCH_LIMIT 12
+
+#define LZ_STORED_FLAG 0x80000000u
+
+
+static inline uint32_t Load32(const uint8_t* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+
+static inline uint32_t LoadLE32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) |
+         (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+
+static inline void StoreLE32(uint8_t* p, uint32_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+
+static inline uint32_t Hash4(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - IOTJS_LZ_HASH_LOG);
+}
+
+
+// Writes the part of a length that does not fit in the token.
+static inline uint8_t* WriteLength(uint8_t* op, size_t length) {
+  for (; length >= 255; length -= 255) {
+    *op++ = 255;
+  }
+  *op++ = static_cast<uint8_t>(length);
+  return op;
+}
+
+
+static inline uint8_t* WriteLiterals(uint8_t* op,
+                                     uint8_t* token,
+                                     const uint8_t* literals,
+                                     size_t length) {
+  if (length >= 15) {
+    *token = 15 << 4;
+    op = WriteLength(op, length - 15);
+  } else {
+    *token = static_cast<uint8_t>(length << 4);
+  }
+  memcpy(op, literals, length);
+  return op + length;
+}
+
+
+// Reads the part of a length that does not fit in the token.
+static inline bool ReadLength(const uint8_t** ip,
+                              const uint8_t* end,
+                              size_t* length) {
+  uint8_t byte;
+  do {
+    if (*ip >= end) {
+      return false;
+    }
+    byte = *(*ip)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+
+size_t LzCompressBound(size_t length) {
+  return length + length / 255 + 16;
+}
+
+
+size_t LzCompress(const uint8_t* src, size_t length, uint8_t* dst) {
+  const uint8_t* end = src + length;
+  const uint8_t* anchor = src;
+  uint8_t* op = dst;
+
+  if (length > LZ_MATCH_LIMIT) {
+    // Positions are relative to `src`, blocks are at most 64 KB.
+    uint16_t table[1 << IOTJS_LZ_HASH_LOG];
+    memset(table, 0, sizeof(table));
+
+    const uint8_t* match_limit = end - LZ_MATCH_LIMIT;
+    const uint8_t* extend_limit = end - LZ_LAST_LITERALS;
+    const uint8_t* ip = src + 1;
+
+    while (ip < match_limit) {
+      uint32_t sequence = Load32(ip);
+      uint32_t hash = Hash4(sequence);
+      const uint8_t* ref = src + table[hash];
+      table[hash] = static_cast<uint16_t>(ip - src);
+
+      if (ip - ref > LZ_MAX_OFFSET || Load32(ref) != sequence) {
+        // Step faster over data that does not compress.
+        ip += 1 + ((ip - anchor) >> 6);
+        continue;
+      }
+
+      while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+        --ip;
+        --ref;
+      }
+
+      const uint8_t* match_end = ip + LZ_MIN_MATCH;
+      const uint8_t* ref_end = ref + LZ_MIN_MATCH;
+      while (match_end < extend_limit && *match_end == *ref_end) {
+        ++match_end;
+        ++ref_end;
+      }
+
+      uint8_t* token = op++;
+      op = WriteLiterals(op, token, anchor, ip - anchor);
+
+      size_t offset = ip - ref;
+      *op++ = static_cast<uint8_t>(offset);
+      *op++ = static_cast<uint8_t>(offset >> 8);
+
+      size_t match_length = match_end - ip - LZ_MIN_MATCH;
+      if (match_length >= 15) {
+        *token |= 15;
+        op = WriteLength(op, match_length - 15);
+      } else {
+        *token |= static_cast<uint8_t>(match_length);
+      }
+
+      ip = match_end;
+      anchor = ip;
+
+      if (ip < match_limit) {
+        table[Hash4(Load32(ip - 2))] = static_cast<uint16_t>(ip - 2 - src);
+      }
+    }
+  }
+
+  uint8_t* token = op++;
+  op = WriteLiterals(op, token, anchor, end - anchor);
+
+  return op - dst;
+}
+
+
+int LzDecompress(const uint8_t* src,
+                 size_t length,
+                 uint8_t* dst,
+                 size_t capacity) {
+  const uint8_t* ip = src;
+  const uint8_t* end = src + length;
+  uint8_t* op = dst;
+  uint8_t* op_end = dst + capacity;
+
+  while (ip < end) {
+    uint8_t token = *ip++;
+
+    size_t literals = token >> 4;
+    if (literals == 15 && !ReadLength(&ip, end, &literals)) {
+      return -1;
+    }
+    if (literals > static_cast<size_t>(end - ip) ||
+        literals > static_cast<size_t>(op_end - op)) {
+      return -1;
+    }
+    memcpy(op, ip, literals);
+    ip += literals;
+    op += literals;
+
+    // The last sequence has no match.
+    if (ip == end) {
+      break;
+    }
+
+    if (end - ip < 2) {
+      return -1;
+    }
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+      return -1;
+    }
+
+    size_t match_length = token & 15;
+    if (match_length == 15 && !ReadLength(&ip, end, &match_length)) {
+      return -1;
+    }
+    match_length += LZ_MIN_MATCH;
+    if (match_length > static_cast<size_t>(op_end - op)) {
+      return -1;
+    }
+
+    const uint8_t* match = op - offset;
+    if (offset >= match_length) {
+      memcpy(op, match, match_length);
+      op += match_length;
+    } else {
+      // Overlapping match repeats the last `offset` bytes.
+      for (size_t i = 0; i < match_length; ++i) {
+        *op++ = *match++;
+      }
+    }
+  }
+
+  return static_cast<int>(op - dst);
+}
+
+
+size_t LzFrameBound(size_t length, size_t block_size) {
+  size_t blocks = length / block_size;
+  size_t rest = length % block_size;
+
+  size_t bound = blocks * (LZ_BLOCK_HEADER_SIZE + LzCompressBound(block_size));
+  if (rest > 0) {
+    bound += LZ_BLOCK_HEADER_SIZE + LzCompressBound(rest);
+  }
+  return bound;
+}
+
+
+size_t LzCompressFrame(const uint8_t* src,
+                       size_t length,
+                       size_t block_size,
+                       uint8_t* dst) {
+  uint8_t* op = dst;
+
+  while (length > 0) {
+    size_t data_size = length < block_size ? length : block_size;
+
+    uint32_t frame_size = LzCompress(src, data_size, op + LZ_BLOCK_HEADER_SIZE);
+    if (frame_size >= data_size) {
+      // Data that does not compress is stored as it is.
+      memcpy(op + LZ_BLOCK_HEADER_SIZE, src, data_size);
+      frame_size = data_size | LZ_STORED_FLAG;
+    }
+
+    StoreLE32(op, frame_size);
+    StoreLE32(op + 4, data_size);
+    op += LZ_BLOCK_HEADER_SIZE + (frame_size & ~LZ_STORED_FLAG);
+
+    src += data_size;
+    length -= data_size;
+  }
+
+  return op - dst;
+}
+
+
+bool LzReadBlockHeader(const uint8_t* src,
+                       size_t* frame_size,
+                       size_t* data_size) {
+  uint32_t first = LoadLE32(src);
+  uint32_t second = LoadLE32(src + 4);
+
+  if (second == 0 || second > LZ_MAX_BLOCK_SIZE) {
+    return false;
+  }
+
+  if (first & LZ_STORED_FLAG) {
+    first &= ~LZ_STORED_FLAG;
+    if (first != second) {
+      return false;
+    }
+  } else if (first == 0 || first > LzCompressBound(second)) {
+    return false;
+  } else if (second > static_cast<size_t>(first) * 255 + 16) {
+    // A byte of a block decodes to at most 255 bytes, match lengths grow by
+    // 255 per byte. More data than that can not be right.
+    return false;
+  }
+
+  *frame_size = first;
+  *data_size = second;
+  return true;
+}
+
+
+bool LzDecompressBlock(const uint8_t* src, uint8_t* dst) {
+  size_t frame_size;
+  size_t data_size;
+  if (!LzReadBlockHeader(src, &frame_size, &data_size)) {
+    return false;
+  }
+
+  const uint8_t* data = src + LZ_BLOCK_HEADER_SIZE;
+  if (LoadLE32(src) & LZ_STORED_FLAG) {
+    memcpy(dst, data, data_size);
+    return true;
+  }
+
+  int size = LzDecompress(data, frame_size, dst, data_size);
+  return size == static_cast<int>(data_size);
+}
+
+
+int64_t LzFrameDataSize(const uint8_t* src, size_t length) {
+  int64_t total = 0;
+
+  while (length > 0) {
+    size_t frame_size;
+    size_t data_size;
+    if (length < LZ_BLOCK_HEADER_SIZE ||
+        !LzReadBlockHeader(src, &frame_size, &data_size) ||
+        length - LZ_BLOCK_HEADER_SIZE < frame_size) {
+      return -1;
+    }
+
+    total += data_size;
+    src += LZ_BLOCK_HEADER_SIZE + frame_size;
+    length -= LZ_BLOCK_HEADER_SIZE + frame_size;
+  }
+
+  return total;
+}
+
+
+bool LzDecompressFrame(const uint8_t* src, size_t length, uint8_t* dst) {
+  const uint8_t* end = src + length;
+
+  while (src < end) {
+    size_t frame_size;
+    size_t data_size;
+    LzReadBlockHeader(src, &frame_size, &data_size);
+
+    if (!LzDecompressBlock(src, dst)) {
+      return false;
+    }
+
+    src += LZ_BLOCK_HEADER_SIZE + frame_size;
+    dst += data_size;
+  }
+
+  return true;
+}
+
+
+} // namespace iotjs
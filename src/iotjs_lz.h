@@ -0,0 +1,92 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef IOTJS_LZ_H
+#define IOTJS_LZ_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+namespace iotjs {
+
+
+// LZ77 codec producing the LZ4 block format: sequences of literals and
+// matches of at least four bytes within the last 64 KB, found with a hash
+// table of recent positions. Favours speed over ratio.
+
+
+// Largest uncompressed size of a block of the frame format.
+#define LZ_MAX_BLOCK_SIZE (64 * 1024)
+
+// Size of the header of a frame block.
+#define LZ_BLOCK_HEADER_SIZE 8
+
+
+// Returns the largest compressed size of `length` bytes.
+size_t LzCompressBound(size_t length);
+
+// Compresses `length` bytes of `src` to `dst`, which must hold
+// `LzCompressBound(length)` bytes. Returns the compressed size.
+size_t LzCompress(const uint8_t* src, size_t length, uint8_t* dst);
+
+// Decompresses a block of `length` bytes of `src` to at most `capacity` bytes
+// of `dst`. Returns the decompressed size, or -1 if the block is corrupt.
+int LzDecompress(const uint8_t* src,
+                 size_t length,
+                 uint8_t* dst,
+                 size_t capacity);
+
+
+// Frame format: a sequence of independent blocks of at most
+// `LZ_MAX_BLOCK_SIZE` bytes of data, each preceded by a header of two 32 bit
+// little endian words, the size of the block in the frame and the size of
+// its data. The top bit of the first word marks a block stored uncompressed.
+// Concatenated frames are a frame of the concatenated data.
+
+// Returns the largest frame size of `length` bytes in blocks of `block_size`.
+size_t LzFrameBound(size_t length, size_t block_size);
+
+// Writes a frame of `length` bytes of `src` in blocks of `block_size` to
+// `dst`, which must hold `LzFrameBound()` bytes. Returns the frame size.
+size_t LzCompressFrame(const uint8_t* src,
+                       size_t length,
+                       size_t block_size,
+                       uint8_t* dst);
+
+// Parses the block header at `src`. Returns false if it is not valid.
+bool LzReadBlockHeader(const uint8_t* src,
+                       size_t* frame_size,
+                       size_t* data_size);
+
+// Decompresses a frame block whose header is at `src` to `dst`, which must
+// hold the data size of the block. Returns false if the block is corrupt.
+bool LzDecompressBlock(const uint8_t* src, uint8_t* dst);
+
+// Returns the data size of a frame of `length` bytes, or -1 if the frame is
+// not complete or its headers are not valid. Blocks are not decompressed.
+int64_t LzFrameDataSize(const uint8_t* src, size_t length);
+
+// Decompresses a frame checked by `LzFrameDataSize()` to `dst`.
+// Returns false if a block is corrupt.
+bool LzDecompressFrame(const uint8_t* src, size_t length, uint8_t* dst);
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_LZ_H */
@@ -18,27 +18,35 @@
 #include "iotjs_module.h"
 
 #include "iotjs_module_buffer.h"
+#include "iotjs_module_compress.h"
 #include "iotjs_module_console.h"
 #include "iotjs_module_constants.h"
+#include "iotjs_module_crypto.h"
 #include "iotjs_module_fs.h"
+#include "iotjs_module_fsevent.h"
+#include "iotjs_module_httpparser.h"
+#include "iotjs_module_json.h"
+#include "iotjs_module_pipe.h"
 #include "iotjs_module_process.h"
+#include "iotjs_module_processwrap.h"
 #include "iotjs_module_stream.h"
 #include "iotjs_module_tcp.h"
 #include "iotjs_module_timer.h"
+#include "iotjs_module_udp.h"
+#include "iotjs_module_worker.h"
 
 
 namespace iotjs {
 
 
-static Module _modules[MODULE_COUNT];
-
-
 #define INIT_MODULE_LIST(upper, Camel, lower) \
   _modules[MODULE_ ## upper].kind = MODULE_ ## upper; \
   _modules[MODULE_ ## upper].module = NULL; \
-  _modules[MODULE_ ## upper].fn_register = Init ## Camel;
+  _modules[MODULE_ ## upper].fn_register = Init ## Camel; \
+  _modules[MODULE_ ## upper].state = NULL;
 
 void InitModuleList() {
+  Module* _modules = Environment::GetEnv()->modules();
   MAP_MODULE_LIST(INIT_MODULE_LIST)
 }
 
@@ -48,9 +56,13 @@ void InitModuleList() {
 #define CLENUP_MODULE_LIST(upper, Camel, lower) \
   if (_modules[MODULE_ ## upper].module) \
     delete _modules[MODULE_ ## upper].module; \
-  _modules[MODULE_ ## upper].module = NULL;
+  _modules[MODULE_ ## upper].module = NULL; \
+  if (_modules[MODULE_ ## upper].state) \
+    delete _modules[MODULE_ ## upper].state; \
+  _modules[MODULE_ ## upper].state = NULL;
 
 void CleanupModuleList() {
+  Module* _modules = Environment::GetEnv()->modules();
   MAP_MODULE_LIST(CLENUP_MODULE_LIST)
 }
 
@@ -58,8 +70,7 @@ void CleanupModuleList() {
 
 
 Module* GetBuiltinModule(ModuleKind kind) {
-  IOTJS_ASSERT(kind < MODULE_COUNT);
-  return &_modules[kind];
+  return Environment::GetEnv()->GetModule(kind);
 }
 
 
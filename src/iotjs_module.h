@@ -28,13 +28,22 @@ typedef JObject* (*register_func)();
 // List of builtin modules
 #define MAP_MODULE_LIST(F) \
   F(BUFFER, Buffer, buffer) \
+  F(COMPRESS, Compress, compress) \
   F(CONSOLE, Console, console) \
   F(CONSTANTS, Constants, constants) \
+  F(CRYPTO, Crypto, crypto) \
   F(FS, Fs, fs) \
+  F(FSEVENT, FsEvent, fsevent) \
+  F(HTTPPARSER, HttpParser, httpparser) \
+  F(JSON, Json, json) \
+  F(PIPE, Pipe, pipe) \
   F(PROCESS, Process, process) \
+  F(PROCESSWRAP, ProcessWrap, processwrap) \
   F(STREAM, Stream, stream) \
   F(TCP, Tcp, tcp) \
-  F(TIMER, Timer, timer)
+  F(TIMER, Timer, timer) \
+  F(UDP, Udp, udp) \
+  F(WORKER, Worker, worker)
 
 
 #define ENUMDEF_MODULE_LIST(upper, Camel, lower) \
@@ -48,10 +57,18 @@ enum ModuleKind {
 #undef ENUMDEF_MODULE_LIST
 
 
+// Native state a module keeps per instance, deleted with the modules.
+class ModuleState {
+ public:
+  virtual ~ModuleState() {}
+};
+
+
 struct Module {
   ModuleKind kind;
   JObject* module;
   register_func fn_register;
+  ModuleState* state;
 };
 
 
@@ -16,6 +16,8 @@
 #include "iotjs_def.h"
 #include "iotjs_module_buffer.h"
 
+#include "iotjs_buffer_pool.h"
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -135,7 +137,7 @@ JHANDLER_FUNCTION(Alloc, handler) {
   int length = handler.GetArg(1)->GetInt32();
   Buffer* buffer = new Buffer(*jbuffer, length);
   IOTJS_ASSERT(buffer == reinterpret_cast<Buffer*>(jbuffer->GetNative()));
-  IOTJS_ASSERT(buffer->buffer() != NULL);
+  IOTJS_ASSERT(length == 0 || buffer->buffer() != NULL);
 
   JObject ret(length);
   handler.Return(ret);
@@ -181,14 +183,19 @@ JObject CreateBuffer(size_t len) {
 Buffer::Buffer(JObject& jbuffer, size_t length)
     : JObjectWrap(jbuffer)
     , _buffer(NULL)
-    , _length(length) {
-  _buffer = AllocBuffer(length);
-  IOTJS_ASSERT(_buffer != NULL);
+    , _length(length)
+    , _slab(NULL) {
+  if (length > 0) {
+    _buffer = AllocBuffer(length);
+    IOTJS_ASSERT(_buffer != NULL);
+  }
 }
 
 
 Buffer::~Buffer() {
-  if (_buffer != NULL) {
+  if (_slab != NULL) {
+    _slab->Unref();
+  } else if (_buffer != NULL) {
     ReleaseBuffer(_buffer);
   }
 }
@@ -241,4 +248,27 @@ size_t Buffer::Copy(char* src, size_t len, size_t src_from, size_t dst_from) {
   return copied;
 }
 
+
+void Buffer::Adopt(BufferSlab* slab, char* data, size_t len) {
+  IOTJS_ASSERT(_buffer == NULL && _length == 0 && _slab == NULL);
+  IOTJS_ASSERT(slab != NULL && data != NULL);
+
+  slab->Ref();
+  _slab = slab;
+  _buffer = data;
+  _length = len;
+
+  jbuffer().SetProperty("length", JVal::Number(static_cast<int>(len)));
+}
+
+
+void Buffer::Own(char* data, size_t len) {
+  IOTJS_ASSERT(_buffer == NULL && _length == 0 && _slab == NULL);
+
+  _buffer = data;
+  _length = len;
+
+  jbuffer().SetProperty("length", JVal::Number(static_cast<int>(len)));
+}
+
 } // namespace iotjs
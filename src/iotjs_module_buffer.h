@@ -23,6 +23,9 @@
 namespace iotjs {
 
 
+class BufferSlab;
+
+
 JObject* InitBuffer();
 
 
@@ -45,9 +48,18 @@ class Buffer : public JObjectWrap {
   size_t Copy(char* src, size_t len);
   size_t Copy(char* src, size_t len, size_t src_from , size_t dst_from);
 
+  // Makes this empty buffer refer `len` bytes of `data` cut from `slab`
+  // instead of owning its memory.
+  void Adopt(BufferSlab* slab, char* data, size_t len);
+
+  // Makes this empty buffer own `len` bytes at `data`, allocated with
+  // `AllocBuffer()`.
+  void Own(char* data, size_t len);
+
  protected:
   char* _buffer;
   size_t _length;
+  BufferSlab* _slab;
 };
 
 
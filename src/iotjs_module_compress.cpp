@@ -0,0 +1,506 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "iotjs_def.h"
+#include "iotjs_module_compress.h"
+#include "iotjs_lz.h"
+#include "iotjs_module_buffer.h"
+#include "iotjs_reqwrap.h"
+
+#include <string.h>
+
+
+namespace iotjs {
+
+
+static inline uint8_t* BufferData(Buffer* buffer) {
+  return reinterpret_cast<uint8_t*>(buffer->buffer());
+}
+
+
+// Returns a new buffer holding `length` bytes of `data`.
+static JObject CopyToBuffer(const uint8_t* data, size_t length) {
+  JObject jbuffer = CreateBuffer(length);
+  memcpy(BufferData(Buffer::FromJBuffer(jbuffer)), data, length);
+  return jbuffer;
+}
+
+
+static void PushElement(JObject& jarray, JObject& jvalue) {
+  uint32_t index = jarray.GetProperty("length").GetInt32();
+  jarray.SetElement(index, jvalue);
+}
+
+
+Compressor::Compressor(JObject& jcompressor)
+    : JObjectWrap(jcompressor)
+    , _pending_length(0) {
+  _pending = reinterpret_cast<uint8_t*>(
+      AllocBuffer(IOTJS_COMPRESS_BLOCK_SIZE));
+  _scratch = reinterpret_cast<uint8_t*>(
+      AllocBuffer(LzFrameBound(IOTJS_COMPRESS_BLOCK_SIZE,
+                               IOTJS_COMPRESS_BLOCK_SIZE)));
+}
+
+
+Compressor::~Compressor() {
+  ReleaseBuffer(reinterpret_cast<char*>(_pending));
+  ReleaseBuffer(reinterpret_cast<char*>(_scratch));
+}
+
+
+Compressor* Compressor::FromJObject(JObject* jcompressor) {
+  Compressor* compressor =
+      reinterpret_cast<Compressor*>(jcompressor->GetNative());
+  IOTJS_ASSERT(compressor != NULL);
+  return compressor;
+}
+
+
+void Compressor::PushBlock(const uint8_t* data,
+                           size_t length,
+                           JObject& jblocks) {
+  size_t size = LzCompressFrame(data, length, length, _scratch);
+  JObject jblock = CopyToBuffer(_scratch, size);
+  PushElement(jblocks, jblock);
+}
+
+
+void Compressor::Feed(const uint8_t* data, size_t length, JObject& jblocks) {
+  const size_t block_size = IOTJS_COMPRESS_BLOCK_SIZE;
+
+  if (_pending_length > 0) {
+    size_t fill = block_size - _pending_length;
+    if (fill > length) {
+      fill = length;
+    }
+    memcpy(_pending + _pending_length, data, fill);
+    _pending_length += fill;
+    data += fill;
+    length -= fill;
+
+    if (_pending_length < block_size) {
+      return;
+    }
+    PushBlock(_pending, block_size, jblocks);
+    _pending_length = 0;
+  }
+
+  for (; length >= block_size; data += block_size, length -= block_size) {
+    PushBlock(data, block_size, jblocks);
+  }
+
+  memcpy(_pending, data, length);
+  _pending_length = length;
+}
+
+
+void Compressor::Flush(JObject& jblocks) {
+  if (_pending_length > 0) {
+    PushBlock(_pending, _pending_length, jblocks);
+    _pending_length = 0;
+  }
+}
+
+
+Decompressor::Decompressor(JObject& jdecompressor)
+    : JObjectWrap(jdecompressor) {
+}
+
+
+Decompressor* Decompressor::FromJObject(JObject* jdecompressor) {
+  Decompressor* decompressor =
+      reinterpret_cast<Decompressor*>(jdecompressor->GetNative());
+  IOTJS_ASSERT(decompressor != NULL);
+  return decompressor;
+}
+
+
+// Returns the number of bytes of the block starting at `data`, or of its
+// header until `available` covers it. Zero if the header is not valid.
+static size_t BlockLength(const uint8_t* data, size_t available) {
+  if (available < LZ_BLOCK_HEADER_SIZE) {
+    return LZ_BLOCK_HEADER_SIZE;
+  }
+
+  size_t frame_size;
+  size_t data_size;
+  if (!LzReadBlockHeader(data, &frame_size, &data_size)) {
+    return 0;
+  }
+  return LZ_BLOCK_HEADER_SIZE + frame_size;
+}
+
+
+bool Decompressor::PushBlock(const uint8_t* block, JObject& jchunks) {
+  size_t frame_size;
+  size_t data_size;
+  LzReadBlockHeader(block, &frame_size, &data_size);
+
+  JObject jchunk = CreateBuffer(data_size);
+  if (!LzDecompressBlock(block, BufferData(Buffer::FromJBuffer(jchunk)))) {
+    return false;
+  }
+
+  PushElement(jchunks, jchunk);
+  return true;
+}
+
+
+bool Decompressor::Feed(const uint8_t* data,
+                        size_t length,
+                        JObject& jchunks) {
+  const uint8_t* end = data + length;
+
+  while (data < end) {
+    size_t available = end - data;
+
+    if (_partial.length() > 0) {
+      // Complete the header first, then the block it tells the size of.
+      const uint8_t* partial = reinterpret_cast<uint8_t*>(_partial.data());
+      size_t want = BlockLength(partial, _partial.length());
+      if (want == 0) {
+        return false;
+      }
+
+      size_t take = want - _partial.length();
+      if (take > available) {
+        take = available;
+      }
+      _partial.Append(reinterpret_cast<const char*>(data), take);
+      data += take;
+
+      if (_partial.length() == want && want > LZ_BLOCK_HEADER_SIZE) {
+        partial = reinterpret_cast<uint8_t*>(_partial.data());
+        if (!PushBlock(partial, jchunks)) {
+          return false;
+        }
+        _partial.Truncate(0);
+      }
+      continue;
+    }
+
+    size_t want = BlockLength(data, available);
+    if (want == 0) {
+      return false;
+    }
+    if (want > available) {
+      _partial.Append(reinterpret_cast<const char*>(data), available);
+      break;
+    }
+
+    if (!PushBlock(data, jchunks)) {
+      return false;
+    }
+    data += want;
+  }
+
+  return true;
+}
+
+
+bool Decompressor::Flush() {
+  bool complete = _partial.length() == 0;
+  _partial.Truncate(0);
+  return complete;
+}
+
+
+// Compression of a whole buffer on the threadpool.
+class CompressReqWrap : public WorkReqWrap {
+ public:
+  CompressReqWrap(JObject& jcallback, JObject& jinput)
+      : WorkReqWrap(jcallback)
+      , _input_length(Buffer::FromJBuffer(jinput)->length())
+      , _frame(NULL)
+      , _frame_length(0) {
+    _input = PinBuffer(jinput);
+  }
+
+  virtual ~CompressReqWrap() {
+    if (_frame != NULL) {
+      ReleaseBuffer(reinterpret_cast<char*>(_frame));
+    }
+  }
+
+ protected:
+  virtual void Run() {
+    size_t bound = LzFrameBound(_input_length, IOTJS_COMPRESS_BLOCK_SIZE);
+    _frame = reinterpret_cast<uint8_t*>(AllocBuffer(bound));
+    _frame_length = LzCompressFrame(_input,
+                                    _input_length,
+                                    IOTJS_COMPRESS_BLOCK_SIZE,
+                                    _frame);
+  }
+
+  virtual void Complete(JArgList& args) {
+    JObject jframe = CopyToBuffer(_frame, _frame_length);
+    args.Add(JObject::Null());
+    args.Add(jframe);
+  }
+
+ private:
+  const uint8_t* _input;
+  size_t _input_length;
+  uint8_t* _frame;
+  size_t _frame_length;
+};
+
+
+// Decompression of a whole frame on the threadpool, straight to a buffer
+// created beforehand.
+class DecompressReqWrap : public WorkReqWrap {
+ public:
+  DecompressReqWrap(JObject& jcallback, JObject& jinput, JObject& joutput)
+      : WorkReqWrap(jcallback)
+      , _input_length(Buffer::FromJBuffer(jinput)->length())
+      , _joutput(joutput)
+      , _failed(false) {
+    _input = PinBuffer(jinput);
+    _output = BufferData(Buffer::FromJBuffer(_joutput));
+  }
+
+ protected:
+  virtual void Run() {
+    _failed = !LzDecompressFrame(_input, _input_length, _output);
+  }
+
+  virtual void Complete(JArgList& args) {
+    if (_failed) {
+      JObject jerror(JObject::Error("Invalid compressed data"));
+      args.Add(jerror);
+    } else {
+      args.Add(JObject::Null());
+      args.Add(_joutput);
+    }
+  }
+
+ private:
+  const uint8_t* _input;
+  size_t _input_length;
+  uint8_t* _output;
+  JObject _joutput;
+  bool _failed;
+};
+
+
+// Compress a buffer to a frame.
+// [0] buffer
+// [1] callback, called with (err, frame) when the work is done on the
+//     threadpool. Without it the frame is returned.
+JHANDLER_FUNCTION(Compress, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() >= 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  JObject* jinput = handler.GetArg(0);
+
+  if (handler.GetArgLength() > 1 && handler.GetArg(1)->IsFunction()) {
+    CompressReqWrap* req_wrap = new CompressReqWrap(*handler.GetArg(1),
+                                                    *jinput);
+    handler.Return(JVal::Number(req_wrap->Queue()));
+    return true;
+  }
+
+  Buffer* input = Buffer::FromJBuffer(*jinput);
+  size_t bound = LzFrameBound(input->length(), IOTJS_COMPRESS_BLOCK_SIZE);
+  uint8_t* scratch = reinterpret_cast<uint8_t*>(AllocBuffer(bound));
+
+  size_t size = LzCompressFrame(BufferData(input),
+                                input->length(),
+                                IOTJS_COMPRESS_BLOCK_SIZE,
+                                scratch);
+  JObject jframe = CopyToBuffer(scratch, size);
+  ReleaseBuffer(reinterpret_cast<char*>(scratch));
+
+  handler.Return(jframe);
+
+  return true;
+}
+
+
+// Decompress a frame. The size of the data is found from the block headers
+// first, blocks are decompressed straight to the resulting buffer. Frames of
+// more than `IOTJS_DECOMPRESS_MAX_SIZE` bytes of data are refused, they can
+// be decompressed with a stream.
+// [0] buffer
+// [1] callback, called with (err, data) when the work is done on the
+//     threadpool. Without it the data is returned.
+JHANDLER_FUNCTION(Decompress, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() >= 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  JObject* jinput = handler.GetArg(0);
+  Buffer* input = Buffer::FromJBuffer(*jinput);
+
+  int64_t size = LzFrameDataSize(BufferData(input), input->length());
+  if (size < 0) {
+    JHANDLER_THROW_RETURN(handler, Error, "Invalid compressed data");
+  }
+  if (size > IOTJS_DECOMPRESS_MAX_SIZE) {
+    JHANDLER_THROW_RETURN(handler, RangeError, "Decompressed data too large");
+  }
+
+  JObject joutput = CreateBuffer(size);
+
+  if (handler.GetArgLength() > 1 && handler.GetArg(1)->IsFunction()) {
+    DecompressReqWrap* req_wrap = new DecompressReqWrap(*handler.GetArg(1),
+                                                        *jinput,
+                                                        joutput);
+    handler.Return(JVal::Number(req_wrap->Queue()));
+    return true;
+  }
+
+  uint8_t* output = BufferData(Buffer::FromJBuffer(joutput));
+  if (!LzDecompressFrame(BufferData(input), input->length(), output)) {
+    JHANDLER_THROW_RETURN(handler, Error, "Invalid compressed data");
+  }
+
+  handler.Return(joutput);
+
+  return true;
+}
+
+
+// new Compressor()
+JHANDLER_FUNCTION(CompressorConstructor, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  JObject* jcompressor = handler.GetThis();
+  Compressor* compressor = new Compressor(*jcompressor);
+  IOTJS_ASSERT(compressor == Compressor::FromJObject(jcompressor));
+
+  return true;
+}
+
+
+// Returns an array of buffers of the blocks completed by a chunk.
+// [0] buffer
+JHANDLER_FUNCTION(CompressorFeed, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  Compressor* compressor = Compressor::FromJObject(handler.GetThis());
+  Buffer* buffer = Buffer::FromJBuffer(*handler.GetArg(0));
+
+  JObject jblocks(JObject::Array());
+  compressor->Feed(BufferData(buffer), buffer->length(), jblocks);
+  handler.Return(jblocks);
+
+  return true;
+}
+
+
+// Returns an array with the buffer of the last block, if any.
+JHANDLER_FUNCTION(CompressorFlush, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  Compressor* compressor = Compressor::FromJObject(handler.GetThis());
+
+  JObject jblocks(JObject::Array());
+  compressor->Flush(jblocks);
+  handler.Return(jblocks);
+
+  return true;
+}
+
+
+// new Decompressor()
+JHANDLER_FUNCTION(DecompressorConstructor, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  JObject* jdecompressor = handler.GetThis();
+  Decompressor* decompressor = new Decompressor(*jdecompressor);
+  IOTJS_ASSERT(decompressor == Decompressor::FromJObject(jdecompressor));
+
+  return true;
+}
+
+
+// Returns an array of buffers of the data of the blocks completed by a chunk,
+// or an Error if the frame is corrupt.
+// [0] buffer
+JHANDLER_FUNCTION(DecompressorFeed, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  Decompressor* decompressor = Decompressor::FromJObject(handler.GetThis());
+  Buffer* buffer = Buffer::FromJBuffer(*handler.GetArg(0));
+
+  JObject jchunks(JObject::Array());
+  if (decompressor->Feed(BufferData(buffer), buffer->length(), jchunks)) {
+    handler.Return(jchunks);
+  } else {
+    JObject jerror(JObject::Error("Invalid compressed data"));
+    handler.Return(jerror);
+  }
+
+  return true;
+}
+
+
+// Returns an Error if the frame ended in the middle of a block, else null.
+JHANDLER_FUNCTION(DecompressorFlush, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  Decompressor* decompressor = Decompressor::FromJObject(handler.GetThis());
+
+  if (decompressor->Flush()) {
+    handler.Return(JObject::Null());
+  } else {
+    JObject jerror(JObject::Error("Unexpected end of compressed data"));
+    handler.Return(jerror);
+  }
+
+  return true;
+}
+
+
+JObject* InitCompress() {
+  Module* module = GetBuiltinModule(MODULE_COMPRESS);
+  JObject* compress = module->module;
+
+  if (compress == NULL) {
+    compress = new JObject();
+    compress->SetMethod("compress", Compress);
+    compress->SetMethod("decompress", Decompress);
+
+    JObject compressor(CompressorConstructor);
+    JObject compressor_prototype;
+    compressor.SetProperty("prototype", compressor_prototype);
+    compressor_prototype.SetMethod("feed", CompressorFeed);
+    compressor_prototype.SetMethod("flush", CompressorFlush);
+    compress->SetProperty("Compressor", compressor);
+
+    JObject decompressor(DecompressorConstructor);
+    JObject decompressor_prototype;
+    decompressor.SetProperty("prototype", decompressor_prototype);
+    decompressor_prototype.SetMethod("feed", DecompressorFeed);
+    decompressor_prototype.SetMethod("flush", DecompressorFlush);
+    compress->SetProperty("Decompressor", decompressor);
+
+    compress->SetProperty("BLOCK_SIZE",
+                          JVal::Number(IOTJS_COMPRESS_BLOCK_SIZE));
+
+    module->module = compress;
+  }
+
+  return compress;
+}
+
+
+} // namespace iotjs
@@ -0,0 +1,80 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef IOTJS_MODULE_COMPRESS_H
+#define IOTJS_MODULE_COMPRESS_H
+
+#include "iotjs_binding.h"
+#include "iotjs_objectwrap.h"
+
+
+namespace iotjs {
+
+
+// Compressor of data arriving in chunks to the frame format of `iotjs_lz.h`.
+// Full blocks are compressed straight from the chunk, only the unfinished
+// block at the end of a chunk is kept until the next one.
+class Compressor : public JObjectWrap {
+ public:
+  explicit Compressor(JObject& jcompressor);
+  virtual ~Compressor();
+
+  static Compressor* FromJObject(JObject* jcompressor);
+
+  // Appends buffers of the blocks completed by `data` to `jblocks`.
+  void Feed(const uint8_t* data, size_t length, JObject& jblocks);
+
+  // Compresses the unfinished block.
+  void Flush(JObject& jblocks);
+
+ private:
+  void PushBlock(const uint8_t* data, size_t length, JObject& jblocks);
+
+  uint8_t* _pending;
+  size_t _pending_length;
+  uint8_t* _scratch;
+};
+
+
+// Decompressor of a frame arriving in chunks. Complete blocks are
+// decompressed straight from the chunk into the buffers handed out.
+class Decompressor : public JObjectWrap {
+ public:
+  explicit Decompressor(JObject& jdecompressor);
+
+  static Decompressor* FromJObject(JObject* jdecompressor);
+
+  // Appends buffers of the data of blocks completed by `data` to `jchunks`.
+  // Returns false if the frame is corrupt.
+  bool Feed(const uint8_t* data, size_t length, JObject& jchunks);
+
+  // Returns false if the frame ended in the middle of a block.
+  bool Flush();
+
+ private:
+  bool PushBlock(const uint8_t* block, JObject& jchunks);
+
+  StringBuilder _partial;
+};
+
+
+JObject* InitCompress();
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_MODULE_COMPRESS_H */
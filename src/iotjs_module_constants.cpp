@@ -47,6 +47,10 @@ JObject* InitConstants() {
     SET_CONSTANT(constants, O_WRONLY);
     SET_CONSTANT(constants, S_IFMT);
     SET_CONSTANT(constants, S_IFDIR);
+    SET_CONSTANT(constants, SIGHUP);
+    SET_CONSTANT(constants, SIGINT);
+    SET_CONSTANT(constants, SIGKILL);
+    SET_CONSTANT(constants, SIGTERM);
 
     module->module = constants;
   }
@@ -0,0 +1,279 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "iotjs_def.h"
+#include "iotjs_module_crypto.h"
+#include "iotjs_module_buffer.h"
+#include "iotjs_reqwrap.h"
+
+#include <string.h>
+
+
+namespace iotjs {
+
+
+HashWrap::HashWrap(JObject& jhash, HashAlgorithm algorithm)
+    : JObjectWrap(jhash)
+    , _hash(algorithm)
+    , _outer(algorithm)
+    , _hmac(false) {
+}
+
+
+HashWrap* HashWrap::FromJObject(JObject* jhash) {
+  HashWrap* hash = reinterpret_cast<HashWrap*>(jhash->GetNative());
+  IOTJS_ASSERT(hash != NULL);
+  return hash;
+}
+
+
+// HMAC, RFC 2104. The inner hash starts with the key xor ipad, the outer one
+// with the key xor opad.
+void HashWrap::SetKey(const uint8_t* key, size_t length) {
+  size_t block_size = HashContext::BlockSize(_hash.algorithm());
+  uint8_t block[HASH_MAX_BLOCK_SIZE];
+  memset(block, 0, sizeof(block));
+
+  if (length > block_size) {
+    _hash.Update(key, length);
+    _hash.Final(block);
+  } else {
+    memcpy(block, key, length);
+  }
+
+  uint8_t pad[HASH_MAX_BLOCK_SIZE];
+  for (size_t i = 0; i < block_size; ++i) {
+    pad[i] = block[i] ^ 0x36;
+  }
+  _hash.Update(pad, block_size);
+
+  for (size_t i = 0; i < block_size; ++i) {
+    pad[i] = block[i] ^ 0x5c;
+  }
+  _outer.Update(pad, block_size);
+
+  _hmac = true;
+}
+
+
+void HashWrap::Update(const uint8_t* data, size_t length) {
+  _hash.Update(data, length);
+}
+
+
+void HashWrap::Final(uint8_t* out) {
+  _hash.Final(out);
+
+  if (_hmac) {
+    _outer.Update(out, digest_size());
+    _outer.Final(out);
+  }
+}
+
+
+// new Hash(algorithm[, key])
+// Creates an HMAC if `key` buffer is given.
+JHANDLER_FUNCTION(Hash, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() >= 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsString());
+
+  char* name = handler.GetArg(0)->GetCString();
+  HashAlgorithm algorithm = HashContext::FindAlgorithm(name);
+  JObject::ReleaseCString(name);
+
+  bool hmac = handler.GetArgLength() > 1 && handler.GetArg(1)->IsObject();
+  if (algorithm == HASH_INVALID || (hmac && algorithm == HASH_CRC32)) {
+    JHANDLER_THROW_RETURN(handler, Error, "Digest method not supported");
+  }
+
+  JObject* jhash = handler.GetThis();
+  HashWrap* hash = new HashWrap(*jhash, algorithm);
+  IOTJS_ASSERT(hash == HashWrap::FromJObject(jhash));
+
+  if (hmac) {
+    Buffer* key = Buffer::FromJBuffer(*handler.GetArg(1));
+    hash->SetKey(reinterpret_cast<uint8_t*>(key->buffer()), key->length());
+  }
+
+  return true;
+}
+
+
+// Hashes the contents of a buffer.
+// [0] buffer
+JHANDLER_FUNCTION(Update, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  HashWrap* hash = HashWrap::FromJObject(handler.GetThis());
+  Buffer* buffer = Buffer::FromJBuffer(*handler.GetArg(0));
+
+  hash->Update(reinterpret_cast<uint8_t*>(buffer->buffer()), buffer->length());
+
+  return true;
+}
+
+
+// Returns a digest as a buffer, or as a hex string.
+static JObject DigestValue(const uint8_t* digest, size_t size, bool hex) {
+  if (hex) {
+    static const char kHexDigits[] = "0123456789abcdef";
+    char text[HASH_MAX_DIGEST_SIZE * 2 + 1];
+    for (size_t i = 0; i < size; ++i) {
+      text[i * 2] = kHexDigits[digest[i] >> 4];
+      text[i * 2 + 1] = kHexDigits[digest[i] & 15];
+    }
+    text[size * 2] = '\0';
+
+    return JObject(text);
+  }
+
+  JObject jbuffer = CreateBuffer(size);
+  memcpy(Buffer::FromJBuffer(jbuffer)->buffer(), digest, size);
+  return jbuffer;
+}
+
+
+// Returns the digest as a buffer, or as a hex string if the argument is true.
+JHANDLER_FUNCTION(Digest, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+
+  HashWrap* hash = HashWrap::FromJObject(handler.GetThis());
+
+  uint8_t digest[HASH_MAX_DIGEST_SIZE];
+  size_t size = hash->digest_size();
+  hash->Final(digest);
+
+  JObject jdigest = DigestValue(digest, size, handler.GetArg(0)->GetBoolean());
+  handler.Return(jdigest);
+
+  return true;
+}
+
+
+// Digest of a whole buffer computed on the threadpool.
+class DigestReqWrap : public WorkReqWrap {
+ public:
+  DigestReqWrap(JObject& jcallback,
+                HashAlgorithm algorithm,
+                JObject& jdata,
+                bool hex)
+      : WorkReqWrap(jcallback)
+      , _hash(algorithm)
+      , _length(Buffer::FromJBuffer(jdata)->length())
+      , _hex(hex) {
+    _data = PinBuffer(jdata);
+  }
+
+ protected:
+  virtual void Run() {
+    _hash.Update(_data, _length);
+    _hash.Final(_digest);
+  }
+
+  virtual void Complete(JArgList& args) {
+    size_t size = HashContext::DigestSize(_hash.algorithm());
+    JObject jdigest = DigestValue(_digest, size, _hex);
+    args.Add(JObject::Null());
+    args.Add(jdigest);
+  }
+
+ private:
+  HashContext _hash;
+  const uint8_t* _data;
+  size_t _length;
+  bool _hex;
+  uint8_t _digest[HASH_MAX_DIGEST_SIZE];
+};
+
+
+// Computes the digest of a whole buffer on the threadpool.
+// [0] algorithm
+// [1] buffer
+// [2] true for a hex string, else a buffer
+// [3] callback, called with (err, digest)
+JHANDLER_FUNCTION(DigestAsync, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 4);
+  IOTJS_ASSERT(handler.GetArg(0)->IsString());
+  IOTJS_ASSERT(handler.GetArg(1)->IsObject());
+  IOTJS_ASSERT(handler.GetArg(3)->IsFunction());
+
+  char* name = handler.GetArg(0)->GetCString();
+  HashAlgorithm algorithm = HashContext::FindAlgorithm(name);
+  JObject::ReleaseCString(name);
+
+  if (algorithm == HASH_INVALID) {
+    JHANDLER_THROW_RETURN(handler, Error, "Digest method not supported");
+  }
+
+  DigestReqWrap* req_wrap = new DigestReqWrap(*handler.GetArg(3),
+                                              algorithm,
+                                              *handler.GetArg(1),
+                                              handler.GetArg(2)->GetBoolean());
+  handler.Return(JVal::Number(req_wrap->Queue()));
+
+  return true;
+}
+
+
+// Returns CRC32 of a buffer.
+// [0] buffer
+// [1] CRC32 of the preceding data, zero to start
+JHANDLER_FUNCTION(Crc, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+  IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
+
+  Buffer* buffer = Buffer::FromJBuffer(*handler.GetArg(0));
+  uint32_t crc = static_cast<uint32_t>(handler.GetArg(1)->GetNumber());
+
+  crc = Crc32(crc,
+              reinterpret_cast<uint8_t*>(buffer->buffer()),
+              buffer->length());
+
+  handler.Return(JVal::Number(static_cast<double>(crc)));
+
+  return true;
+}
+
+
+JObject* InitCrypto() {
+  Module* module = GetBuiltinModule(MODULE_CRYPTO);
+  JObject* crypto = module->module;
+
+  if (crypto == NULL) {
+    crypto = new JObject();
+    crypto->SetMethod("crc32", Crc);
+    crypto->SetMethod("digest", DigestAsync);
+
+    JObject hash(Hash);
+    JObject prototype;
+    hash.SetProperty("prototype", prototype);
+    prototype.SetMethod("update", Update);
+    prototype.SetMethod("digest", Digest);
+    crypto->SetProperty("Hash", hash);
+
+    module->module = crypto;
+  }
+
+  return crypto;
+}
+
+
+} // namespace iotjs
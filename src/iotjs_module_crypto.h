@@ -0,0 +1,58 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef IOTJS_MODULE_CRYPTO_H
+#define IOTJS_MODULE_CRYPTO_H
+
+#include "iotjs_binding.h"
+#include "iotjs_hash.h"
+#include "iotjs_objectwrap.h"
+
+
+namespace iotjs {
+
+
+// Message digest object, or HMAC when created with a key.
+class HashWrap : public JObjectWrap {
+ public:
+  HashWrap(JObject& jhash, HashAlgorithm algorithm);
+
+  static HashWrap* FromJObject(JObject* jhash);
+
+  // Makes this an HMAC of `key`.
+  void SetKey(const uint8_t* key, size_t length);
+
+  void Update(const uint8_t* data, size_t length);
+
+  // Writes the digest to `out`, `digest_size()` bytes.
+  void Final(uint8_t* out);
+
+  size_t digest_size() { return HashContext::DigestSize(_hash.algorithm()); }
+
+ private:
+  HashContext _hash;
+  HashContext _outer;
+  bool _hmac;
+};
+
+
+JObject* InitCrypto();
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_MODULE_CRYPTO_H */
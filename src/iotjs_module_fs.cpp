@@ -18,46 +18,44 @@
 
 #include "iotjs_module_buffer.h"
 #include "iotjs_exception.h"
-#include "iotjs_reqwrap.h"
+#include "iotjs_fs_scheduler.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 namespace iotjs {
 
 
-class FsReqWrap : public ReqWrap {
- public:
-  explicit FsReqWrap(JObject& jcallback)
-      : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data)) {
-  }
+static void After(uv_fs_t* req);
 
-  ~FsReqWrap() {
-    uv_fs_req_cleanup(&_data);
-  }
 
-  uv_fs_t* data() {
-    return &_data;
+static FsScheduler* GetFsScheduler(Environment* env) {
+  FsScheduler* scheduler = env->fs_scheduler();
+  if (scheduler == NULL) {
+    scheduler = new FsScheduler(env->loop(), After);
+    env->set_fs_scheduler(scheduler);
   }
-
- private:
-  uv_fs_t _data;
-};
+  return scheduler;
+}
 
 
-static void After(uv_fs_t* req) {
-  FsReqWrap* req_wrap = static_cast<FsReqWrap*>(req->data);
-  IOTJS_ASSERT(req_wrap != NULL);
-  IOTJS_ASSERT(req_wrap->data() == req);
-
+static void CallbackResult(FsReqWrap* req_wrap, ssize_t result) {
   JObject cb = req_wrap->jcallback();
   IOTJS_ASSERT(cb.IsFunction());
 
+  uv_fs_t* req = req_wrap->data();
+
   JArgList jarg(2);
-  if (req->result < 0) {
-    JObject jerror(CreateUVException(req->result, "open"));
+  if (result < 0) {
+    JObject jerror(CreateUVException(result, "open"));
     jarg.Add(jerror);
   } else {
     jarg.Add(JObject::Null());
-    switch (req->fs_type) {
+    switch (req_wrap->type()) {
       case UV_FS_CLOSE:
       {
         break;
@@ -66,7 +64,7 @@ static void After(uv_fs_t* req) {
       case UV_FS_READ:
       case UV_FS_WRITE:
       {
-        JObject arg1(static_cast<int32_t>(req->result));
+        JObject arg1(static_cast<int32_t>(result));
         jarg.Add(arg1);
         break;
       }
@@ -82,6 +80,53 @@ static void After(uv_fs_t* req) {
   }
 
   JObject res = MakeCallback(cb, JObject::Null(), jarg);
+}
+
+
+// Takes share of a merged write for a request of `length` bytes.
+static ssize_t TakeWritten(ssize_t* remain, size_t length) {
+  if (*remain < 0) {
+    return *remain;
+  }
+  ssize_t written = *remain < static_cast<ssize_t>(length)
+                    ? *remain
+                    : static_cast<ssize_t>(length);
+  *remain -= written;
+  return written;
+}
+
+
+static void After(uv_fs_t* req) {
+  FsReqWrap* req_wrap = static_cast<FsReqWrap*>(req->data);
+  IOTJS_ASSERT(req_wrap != NULL);
+  IOTJS_ASSERT(req_wrap->data() == req);
+
+  // Let the scheduler dispatch queued requests before calling back.
+  GetFsScheduler(Environment::GetEnv())->Complete(req_wrap);
+
+  LinkedList<FsReqWrap*>& coalesced = req_wrap->coalesced();
+
+  if (coalesced.IsEmpty()) {
+    CallbackResult(req_wrap, req->result);
+  } else {
+    // Share out the result of the merged write to the requests in order.
+    size_t length = req_wrap->length();
+    for (LinkedListItem<FsReqWrap*>* item = coalesced.head();
+         item != NULL;
+         item = item->next) {
+      length -= item->data->length();
+    }
+
+    ssize_t remain = req->result;
+    CallbackResult(req_wrap, TakeWritten(&remain, length));
+
+    while (!coalesced.IsEmpty()) {
+      FsReqWrap* next = coalesced.head()->data;
+      coalesced.RemoveHead();
+      CallbackResult(next, TakeWritten(&remain, next->length()));
+      delete next;
+    }
+  }
 
   uv_fs_req_cleanup(req);
 
@@ -89,29 +134,83 @@ static void After(uv_fs_t* req) {
 }
 
 
-#define FS_ASYNC(env, syscall, pcallback, ...) \
+#define FS_ASYNC(syscall, pcallback, ...) \
   FsReqWrap* req_wrap = new FsReqWrap(*pcallback); \
-  uv_fs_t* fs_req = req_wrap->data(); \
-  int err = uv_fs_ ## syscall(env->loop(), \
-                              fs_req, \
-                              __VA_ARGS__, \
-                              After); \
-  req_wrap->Dispatched(); \
-  if (err < 0) { \
-    fs_req->result = err; \
-    After(fs_req); \
-  } \
+  req_wrap->set_ ## syscall ## _args(__VA_ARGS__); \
+  GetFsScheduler(Environment::GetEnv())->Enqueue(req_wrap); \
   handler.Return(JObject::Null()); \
 
 
-#define FS_SYNC(env, syscall, ...) \
-  FsReqWrap req_wrap(JObject::Null()); \
-  int err = uv_fs_ ## syscall(env->loop(), \
-                              req_wrap.data(), \
-                              __VA_ARGS__, \
-                              NULL); \
+// Synchronous operations do not go through the loop. The system calls are
+// made directly with states kept on the stack, and return negated errno on
+// failure as uv does.
+
+#ifndef O_CLOEXEC
+ #define O_CLOEXEC 0
+#endif
+
+
+static int SyncOpen(const char* path, int flags, int mode) {
+  int fd = open(path, flags | O_CLOEXEC, mode);
+  return fd < 0 ? -errno : fd;
+}
+
+
+static int SyncClose(int fd) {
+  return close(fd) < 0 ? -errno : 0;
+}
+
+
+static int SyncRead(int fd, char* buf, size_t len, int64_t position) {
+  ssize_t res;
+  do {
+    if (position < 0) {
+      res = read(fd, buf, len);
+    } else {
+      res = pread(fd, buf, len, position);
+    }
+  } while (res < 0 && errno == EINTR);
+  return res < 0 ? -errno : static_cast<int>(res);
+}
+
+
+static int SyncWrite(int fd, const char* buf, size_t len, int64_t position) {
+  ssize_t res;
+  do {
+    if (position < 0) {
+      res = write(fd, buf, len);
+    } else {
+      res = pwrite(fd, buf, len, position);
+    }
+  } while (res < 0 && errno == EINTR);
+  return res < 0 ? -errno : static_cast<int>(res);
+}
+
+
+static int SyncStat(const char* path, uv_stat_t* statbuf) {
+  struct stat st;
+  if (stat(path, &st) < 0) {
+    return -errno;
+  }
+  memset(statbuf, 0, sizeof(*statbuf));
+  statbuf->st_dev = st.st_dev;
+  statbuf->st_mode = st.st_mode;
+  statbuf->st_nlink = st.st_nlink;
+  statbuf->st_uid = st.st_uid;
+  statbuf->st_gid = st.st_gid;
+  statbuf->st_rdev = st.st_rdev;
+  statbuf->st_blksize = st.st_blksize;
+  statbuf->st_ino = st.st_ino;
+  statbuf->st_size = st.st_size;
+  statbuf->st_blocks = st.st_blocks;
+  return 0;
+}
+
+
+#define FS_SYNC(Camel, lower, ...) \
+  int err = Sync ## Camel(__VA_ARGS__); \
   if (err < 0) { \
-    JObject jerror(CreateUVException(err, #syscall)); \
+    JObject jerror(CreateUVException(err, #lower)); \
     handler.Throw(jerror); \
     return false; \
   } \
@@ -122,14 +221,17 @@ JHANDLER_FUNCTION(Close, handler) {
   IOTJS_ASSERT(handler.GetArgLength() >= 1);
   IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
 
-  Environment* env = Environment::GetEnv();
-
   int fd = handler.GetArg(0)->GetInt32();
 
   if (handler.GetArgLength() > 1 && handler.GetArg(1)->IsFunction()) {
-    FS_ASYNC(env, close, handler.GetArg(1), fd);
+    FS_ASYNC(close, handler.GetArg(1), fd);
   } else {
-    FS_SYNC(env, close, fd);
+    FS_SYNC(Close, close, fd);
+    // Asynchronous close resets the descriptor when it completes.
+    FsScheduler* scheduler = Environment::GetEnv()->fs_scheduler();
+    if (scheduler != NULL) {
+      scheduler->Closed(fd);
+    }
   }
 
   return !handler.HasThrown();
@@ -143,16 +245,14 @@ JHANDLER_FUNCTION(Open, handler) {
   IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
   IOTJS_ASSERT(handler.GetArg(2)->IsNumber());
 
-  Environment* env = Environment::GetEnv();
-
   LocalString path(handler.GetArg(0)->GetCString());
   int flags = handler.GetArg(1)->GetInt32();
   int mode = handler.GetArg(2)->GetInt32();
 
   if (handler.GetArgLength() > 3 && handler.GetArg(3)->IsFunction()) {
-    FS_ASYNC(env, open, handler.GetArg(3), path, flags, mode);
+    FS_ASYNC(open, handler.GetArg(3), path, flags, mode);
   } else {
-    FS_SYNC(env, open, path, flags, mode);
+    FS_SYNC(Open, open, path, flags, mode);
     handler.Return(JVal::Number(err));
   }
 
@@ -169,8 +269,6 @@ JHANDLER_FUNCTION(Read, handler) {
   IOTJS_ASSERT(handler.GetArg(3)->IsNumber());
   IOTJS_ASSERT(handler.GetArg(4)->IsNumber());
 
-  Environment* env = Environment::GetEnv();
-
   int fd = handler.GetArg(0)->GetInt32();
   int offset = handler.GetArg(2)->GetInt32();
   int length = handler.GetArg(3)->GetInt32();
@@ -191,9 +289,9 @@ JHANDLER_FUNCTION(Read, handler) {
   uv_buf_t uvbuf = uv_buf_init(buffer + offset, length);
 
   if (handler.GetArgLength() > 5 && handler.GetArg(5)->IsFunction()) {
-    FS_ASYNC(env, read, handler.GetArg(5), fd, &uvbuf, 1, position);
+    FS_ASYNC(read, handler.GetArg(5), fd, &uvbuf, 1, position);
   } else {
-    FS_SYNC(env, read, fd, &uvbuf, 1, position);
+    FS_SYNC(Read, read, fd, buffer + offset, length, position);
     handler.Return(JVal::Number(err));
   }
 
@@ -210,8 +308,6 @@ JHANDLER_FUNCTION(Write, handler) {
   IOTJS_ASSERT(handler.GetArg(3)->IsNumber());
   IOTJS_ASSERT(handler.GetArg(4)->IsNumber());
 
-  Environment* env = Environment::GetEnv();
-
   int fd = handler.GetArg(0)->GetInt32();
   int offset = handler.GetArg(2)->GetInt32();
   int length = handler.GetArg(3)->GetInt32();
@@ -232,9 +328,9 @@ JHANDLER_FUNCTION(Write, handler) {
   uv_buf_t uvbuf = uv_buf_init(buffer + offset, length);
 
   if (handler.GetArgLength() > 5 && handler.GetArg(5)->IsFunction()) {
-    FS_ASYNC(env, write, handler.GetArg(5), fd, &uvbuf, 1, position);
+    FS_ASYNC(write, handler.GetArg(5), fd, &uvbuf, 1, position);
   } else {
-    FS_SYNC(env, write, fd, &uvbuf, 1, position);
+    FS_SYNC(Write, write, fd, buffer + offset, length, position);
     handler.Return(JVal::Number(err));
   }
 
@@ -301,16 +397,14 @@ JHANDLER_FUNCTION(Stat, handler) {
     JHANDLER_THROW_RETURN(handler, TypeError, "path must be a string");
   }
 
-  Environment* env = Environment::GetEnv();
-
   LocalString path(handler.GetArg(0)->GetCString());
 
   if (argc > 1 && handler.GetArg(1)->IsFunction()) {
-    FS_ASYNC(env, stat, handler.GetArg(1), path);
+    FS_ASYNC(stat, handler.GetArg(1), path);
   } else {
-    FS_SYNC(env, stat, path);
-    uv_stat_t* s = &(req_wrap.data()->statbuf);
-    JObject ret(MakeStatObject(s));
+    uv_stat_t statbuf;
+    FS_SYNC(Stat, stat, path, &statbuf);
+    JObject ret(MakeStatObject(&statbuf));
     handler.Return(ret);
   }
 
@@ -318,6 +412,55 @@ JHANDLER_FUNCTION(Stat, handler) {
 }
 
 
+// Sets priority class of requests on the file descriptor.
+// [0] fd
+// [1] priority
+JHANDLER_FUNCTION(SetPriority, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+  IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
+
+  int fd = handler.GetArg(0)->GetInt32();
+  int priority = handler.GetArg(1)->GetInt32();
+
+  if (priority < 0 || priority >= FS_PRIORITY_COUNT) {
+    JHANDLER_THROW_RETURN(handler, RangeError, "invalid priority");
+  }
+
+  Environment* env = Environment::GetEnv();
+  GetFsScheduler(env)->SetPriority(fd, static_cast<FsPriority>(priority));
+
+  return true;
+}
+
+
+// Returns counters of the request scheduler.
+JHANDLER_FUNCTION(SchedulerStats, handler) {
+  Environment* env = Environment::GetEnv();
+  FsSchedulerStats& stats = GetFsScheduler(env)->stats();
+
+  // Wait times are reported in milliseconds.
+  JObject jstats;
+  jstats.SetProperty("queued",
+                     JVal::Number(static_cast<int>(
+                         stats.queued[FS_PRIORITY_NORMAL] +
+                         stats.queued[FS_PRIORITY_HIGH])));
+  jstats.SetProperty("queuedHigh",
+                     JVal::Number(static_cast<int>(
+                         stats.queued[FS_PRIORITY_HIGH])));
+  jstats.SetProperty("inflight",
+                     JVal::Number(static_cast<int>(stats.inflight)));
+  jstats.SetProperty("dispatched", JVal::Number(stats.dispatched));
+  jstats.SetProperty("coalesced", JVal::Number(stats.coalesced));
+  jstats.SetProperty("totalWait", JVal::Number(stats.total_wait / 1e6));
+  jstats.SetProperty("maxWait", JVal::Number(stats.max_wait / 1e6));
+
+  handler.Return(jstats);
+
+  return true;
+}
+
+
 JObject* InitFs() {
   Module* module = GetBuiltinModule(MODULE_FS);
   JObject* fs = module->module;
@@ -329,6 +472,11 @@ JObject* InitFs() {
     fs->SetMethod("read", Read);
     fs->SetMethod("write", Write);
     fs->SetMethod("stat", Stat);
+    fs->SetMethod("setPriority", SetPriority);
+    fs->SetMethod("schedulerStats", SchedulerStats);
+
+    fs->SetProperty("PRIORITY_NORMAL", JVal::Number(FS_PRIORITY_NORMAL));
+    fs->SetProperty("PRIORITY_HIGH", JVal::Number(FS_PRIORITY_HIGH));
 
     module->module = fs;
   }
@@ -0,0 +1,309 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "iotjs_def.h"
+#include "iotjs_module_fsevent.h"
+
+#include "iotjs_handlewrap.h"
+
+#include <string.h>
+
+
+namespace iotjs {
+
+
+// File system event watcher.
+// Events arriving within the debounce window are merged and reported with a
+// single callback when the window closes.
+class FsEventWrap : public HandleWrap {
+ public:
+  explicit FsEventWrap(Environment* env,
+                       JObject& jfsevent,
+                       JObject& jholder)
+      : HandleWrap(jfsevent,
+                   jholder,
+                   reinterpret_cast<uv_handle_t*>(&_handle))
+      , _debounce(0)
+      , _events(0)
+      , _count(0)
+      , _filename(NULL)
+      , _multiple(false) {
+    uv_fs_event_init(env->loop(), &_handle);
+    uv_timer_init(env->loop(), &_timer);
+    _timer.data = this;
+  }
+
+  virtual ~FsEventWrap() {
+    ResetEvents();
+  }
+
+  static FsEventWrap* FromJObject(JObject* jfsevent) {
+    FsEventWrap* wrap = reinterpret_cast<FsEventWrap*>(jfsevent->GetNative());
+    IOTJS_ASSERT(wrap != NULL);
+    return wrap;
+  }
+
+  uv_fs_event_t* fs_event_handle() {
+    return &_handle;
+  }
+
+  uv_timer_t* timer_handle() {
+    return &_timer;
+  }
+
+  void set_debounce(uint64_t debounce) {
+    _debounce = debounce;
+  }
+
+  void OnEvent(const char* filename, int events, int status);
+  void Flush();
+
+ protected:
+  void Accumulate(const char* filename, int events);
+  void ResetEvents();
+
+  uv_fs_event_t _handle;
+  uv_timer_t _timer;
+  uint64_t _debounce;
+
+  // Events merged during the window.
+  int _events;
+  int _count;
+  char* _filename;
+  bool _multiple;
+};
+
+
+static void MakeChangeCallback(FsEventWrap* wrap,
+                               int status,
+                               int events,
+                               const char* filename,
+                               int count) {
+  JObject jwatcher = wrap->jholder();
+  IOTJS_ASSERT(jwatcher.IsObject());
+
+  JObject jonchange = jwatcher.GetProperty("_onchange");
+  IOTJS_ASSERT(jonchange.IsFunction());
+
+  // FSWatcher.prototype._onchange = function(status, events, filename, count)
+  JArgList args(4);
+  args.Add(JVal::Number(status));
+  args.Add(JVal::Number(events));
+  if (filename != NULL) {
+    JObject jfilename(filename);
+    args.Add(jfilename);
+  } else {
+    args.Add(JVal::Null());
+  }
+  args.Add(JVal::Number(count));
+
+  MakeCallback(jonchange, jwatcher, args);
+}
+
+
+static void OnDebounceTimeout(uv_timer_t* handle) {
+  FsEventWrap* wrap = reinterpret_cast<FsEventWrap*>(handle->data);
+  IOTJS_ASSERT(wrap != NULL);
+  wrap->Flush();
+}
+
+
+void FsEventWrap::OnEvent(const char* filename, int events, int status) {
+  if (status < 0) {
+    MakeChangeCallback(this, status, 0, NULL, 0);
+    return;
+  }
+
+  if (_debounce == 0) {
+    MakeChangeCallback(this, 0, events, filename, 1);
+    return;
+  }
+
+  // The first event of a burst opens the window. It is not extended by
+  // following events so that changes are reported no later than `_debounce`.
+  if (_count == 0) {
+    uv_timer_start(&_timer, OnDebounceTimeout, _debounce, 0);
+  }
+  Accumulate(filename, events);
+}
+
+
+void FsEventWrap::Accumulate(const char* filename, int events) {
+  _events |= events;
+  _count += 1;
+
+  if (_multiple) {
+    return;
+  }
+  if (_filename == NULL && filename != NULL && _count == 1) {
+    _filename = AllocBuffer(strlen(filename) + 1);
+    strcpy(_filename, filename);
+  } else if (_filename == NULL ||
+             filename == NULL ||
+             strcmp(_filename, filename) != 0) {
+    // Burst involves more than one file, report the watched path itself.
+    _multiple = true;
+  }
+}
+
+
+void FsEventWrap::Flush() {
+  if (_count == 0) {
+    return;
+  }
+
+  int events = _events;
+  int count = _count;
+  const char* filename = _multiple ? NULL : _filename;
+
+  // Keep the name alive during the callback, which may start a new burst.
+  char* name = _filename;
+  _filename = NULL;
+  _events = 0;
+  _count = 0;
+  _multiple = false;
+
+  MakeChangeCallback(this, 0, events, filename, count);
+
+  if (name != NULL) {
+    ReleaseBuffer(name);
+  }
+}
+
+
+void FsEventWrap::ResetEvents() {
+  if (_filename != NULL) {
+    ReleaseBuffer(_filename);
+    _filename = NULL;
+  }
+  _events = 0;
+  _count = 0;
+  _multiple = false;
+}
+
+
+JHANDLER_FUNCTION(FsEvent, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  Environment* env = Environment::GetEnv();
+  JObject* jfsevent = handler.GetThis();
+  JObject* jholder = handler.GetArg(0);
+
+  FsEventWrap* wrap = new FsEventWrap(env, *jfsevent, *jholder);
+  IOTJS_ASSERT(wrap->jnative().IsObject());
+  IOTJS_ASSERT(jfsevent->GetNative() != 0);
+
+  return true;
+}
+
+
+static void OnFsEvent(uv_fs_event_t* handle,
+                      const char* filename,
+                      int events,
+                      int status) {
+  FsEventWrap* wrap = reinterpret_cast<FsEventWrap*>(handle->data);
+  IOTJS_ASSERT(wrap != NULL);
+  IOTJS_ASSERT(wrap->fs_event_handle() == handle);
+
+  wrap->OnEvent(filename, events, status);
+}
+
+
+// Start watching.
+// [0] path
+// [1] recursive
+// [2] debounce window in milliseconds, 0 for reporting every event.
+JHANDLER_FUNCTION(Start, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 3);
+  IOTJS_ASSERT(handler.GetArg(0)->IsString());
+  IOTJS_ASSERT(handler.GetArg(1)->IsBoolean());
+  IOTJS_ASSERT(handler.GetArg(2)->IsNumber());
+
+  FsEventWrap* wrap = FsEventWrap::FromJObject(handler.GetThis());
+
+  LocalString path(handler.GetArg(0)->GetCString());
+  unsigned int flags = handler.GetArg(1)->GetBoolean()
+                       ? UV_FS_EVENT_RECURSIVE
+                       : 0;
+  int64_t debounce = handler.GetArg(2)->GetInt64();
+
+  wrap->set_debounce(debounce > 0 ? debounce : 0);
+
+  int err = uv_fs_event_start(wrap->fs_event_handle(), OnFsEvent, path, flags);
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+static void AfterClose(uv_handle_t* handle) {
+  HandleWrap* wrap = HandleWrap::FromHandle(handle);
+  IOTJS_ASSERT(wrap != NULL);
+
+  JObject jwatcher = wrap->jholder();
+  IOTJS_ASSERT(jwatcher.IsObject());
+
+  JObject jonclose = jwatcher.GetProperty("_onclose");
+  IOTJS_ASSERT(jonclose.IsFunction());
+
+  MakeCallback(jonclose, jwatcher, JArgList::Empty());
+}
+
+
+// Stop watching. Events pending in the debounce window are dropped.
+JHANDLER_FUNCTION(Close, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  FsEventWrap* wrap = FsEventWrap::FromJObject(handler.GetThis());
+
+  uv_handle_t* timer = reinterpret_cast<uv_handle_t*>(wrap->timer_handle());
+  if (!uv_is_closing(timer)) {
+    uv_close(timer, NULL);
+  }
+  wrap->Close(AfterClose);
+
+  return true;
+}
+
+
+JObject* InitFsEvent() {
+  Module* module = GetBuiltinModule(MODULE_FSEVENT);
+  JObject* fsevent = module->module;
+
+  if (fsevent == NULL) {
+    fsevent = new JObject(FsEvent);
+
+    JObject prototype;
+    fsevent->SetProperty("prototype", prototype);
+
+    prototype.SetMethod("start", Start);
+    prototype.SetMethod("close", Close);
+
+    fsevent->SetProperty("RENAME", JVal::Number(UV_RENAME));
+    fsevent->SetProperty("CHANGE", JVal::Number(UV_CHANGE));
+
+    module->module = fsevent;
+  }
+
+  return fsevent;
+}
+
+
+} // namespace iotjs
@@ -0,0 +1,742 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "iotjs_def.h"
+#include "iotjs_module_httpparser.h"
+#include "iotjs_module_buffer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+
+namespace iotjs {
+
+
+// Longest chunk size line, with extensions, accepted.
+#define HTTP_MAX_CHUNK_SIZE_LINE 1024
+
+
+static inline bool IsSpace(char c) {
+  return c == ' ' || c == '\t';
+}
+
+
+static inline bool MatchName(const char* name, size_t length,
+                             const char* expected, size_t expected_length) {
+  return length == expected_length &&
+         strncasecmp(name, expected, length) == 0;
+}
+
+
+HttpParser::HttpParser(JObject& jparser, Type type)
+    : JObjectWrap(jparser)
+    , _type(type)
+    , _error(NULL)
+    , _exception(NULL)
+    , _header_lines(0)
+    , _line_length(0) {
+  StartMessage();
+}
+
+
+HttpParser::~HttpParser() {
+  if (_exception != NULL) {
+    delete _exception;
+  }
+}
+
+
+HttpParser* HttpParser::FromJObject(JObject* jparser) {
+  HttpParser* parser = reinterpret_cast<HttpParser*>(jparser->GetNative());
+  IOTJS_ASSERT(parser != NULL);
+  return parser;
+}
+
+
+void HttpParser::Reinitialize(Type type) {
+  _type = type;
+  _error = NULL;
+  if (_exception != NULL) {
+    delete _exception;
+    _exception = NULL;
+  }
+  _header.Truncate(0);
+  _header_lines = 0;
+  _line_length = 0;
+  StartMessage();
+}
+
+
+void HttpParser::StartMessage() {
+  _state = STATE_HEADER;
+  _remaining = 0;
+  _content_length = -1;
+  _chunked = false;
+  _has_transfer_encoding = false;
+  _connection_close = false;
+  _connection_keep_alive = false;
+  _connection_upgrade = false;
+  _has_upgrade = false;
+  _version_major = 0;
+  _version_minor = 0;
+  _status_code = 0;
+  _connect_method = false;
+}
+
+
+void HttpParser::Fail(const char* error) {
+  _error = error;
+  _state = STATE_ERROR;
+}
+
+
+int HttpParser::Execute(const char* data, size_t length) {
+  const char* p = data;
+  const char* end = data + length;
+
+  while (p < end && _state != STATE_ERROR && _state != STATE_UPGRADED) {
+    size_t available = end - p;
+
+    switch (_state) {
+      case STATE_HEADER:
+        p += ScanHeader(p, available);
+        break;
+
+      case STATE_BODY_IDENTITY:
+      case STATE_CHUNK_DATA: {
+        size_t len = available < _remaining ? available
+                                             : static_cast<size_t>(_remaining);
+        _remaining -= len;
+        if (!OnBody(p, len)) {
+          break;
+        }
+        p += len;
+        if (_remaining == 0) {
+          if (_state == STATE_CHUNK_DATA) {
+            _state = STATE_CHUNK_DATA_END;
+          } else {
+            OnMessageComplete();
+          }
+        }
+        break;
+      }
+
+      case STATE_BODY_EOF:
+        if (OnBody(p, available)) {
+          p = end;
+        }
+        break;
+
+      case STATE_CHUNK_SIZE:
+        p += ScanChunkSize(p, available);
+        break;
+
+      case STATE_CHUNK_DATA_END:
+        // CRLF following the chunk data.
+        if (*p == '\n') {
+          _state = STATE_CHUNK_SIZE;
+        } else if (*p != '\r') {
+          Fail("invalid chunk");
+        }
+        ++p;
+        break;
+
+      case STATE_TRAILERS:
+        p += ScanTrailers(p, available);
+        break;
+
+      default:
+        IOTJS_ASSERT(!"unreachable");
+        break;
+    }
+  }
+
+  if (_state == STATE_ERROR) {
+    return _exception != NULL ? -2 : -1;
+  }
+
+  return p - data;
+}
+
+
+int HttpParser::Finish() {
+  switch (_state) {
+    case STATE_ERROR:
+      return _exception != NULL ? -2 : -1;
+
+    case STATE_BODY_EOF:
+      return OnMessageComplete() ? 0 : -2;
+
+    case STATE_UPGRADED:
+      return 0;
+
+    case STATE_HEADER:
+      if (_header_lines == 0 && _line_length == 0) {
+        return 0;
+      }
+      // Fall through.
+
+    default:
+      Fail("unexpected end of message");
+      return -1;
+  }
+}
+
+
+size_t HttpParser::ScanHeader(const char* data, size_t length) {
+  // Bytes of this chunk belonging to the header, not yet in `_header`.
+  const char* start = data;
+  const char* p = data;
+  const char* end = data + length;
+
+  while (p < end) {
+    char c = *p++;
+
+    if (c != '\n') {
+      if (c != '\r') {
+        ++_line_length;
+      }
+      continue;
+    }
+
+    if (_line_length > 0) {
+      ++_header_lines;
+      _line_length = 0;
+      continue;
+    }
+
+    if (_header_lines == 0) {
+      // Empty lines before the start line are ignored.
+      _header.Truncate(0);
+      start = p;
+      continue;
+    }
+
+    // Empty line, the header section is complete.
+    _header_lines = 0;
+
+    if (_header.length() + (p - start) > IOTJS_HTTP_MAX_HEADER_SIZE) {
+      Fail("header overflow");
+    } else if (_header.length() == 0) {
+      // Complete within the chunk, parsed in place.
+      ParseHeader(start, p - start);
+    } else {
+      _header.Append(start, p - start);
+      ParseHeader(_header.data(), _header.length());
+    }
+    _header.Truncate(0);
+
+    return p - data;
+  }
+
+  if (_header.length() + (p - start) > IOTJS_HTTP_MAX_HEADER_SIZE) {
+    Fail("header overflow");
+  } else {
+    _header.Append(start, p - start);
+  }
+
+  return length;
+}
+
+
+bool HttpParser::ParseHeader(const char* data, size_t length) {
+  JObject jinfo;
+  JObject jheaders(JObject::Array());
+
+  const char* p = data;
+  const char* end = data + length;
+  bool start_line = true;
+
+  while (p < end) {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    IOTJS_ASSERT(eol != NULL);
+
+    size_t len = eol - p;
+    if (len > 0 && p[len - 1] == '\r') {
+      --len;
+    }
+    if (len == 0) {
+      break;
+    }
+
+    bool ok = start_line ? ParseStartLine(p, len, jinfo)
+                         : ParseHeaderField(p, len, jheaders);
+    if (!ok) {
+      return false;
+    }
+
+    start_line = false;
+    p = eol + 1;
+  }
+
+  // Ambiguous framing is a way of smuggling requests (RFC 7230 3.3.3).
+  if (_has_transfer_encoding && _content_length >= 0) {
+    Fail("both content-length and transfer-encoding");
+    return false;
+  }
+  // A response not ending in chunked is read until the connection closes.
+  if (_type == REQUEST && _has_transfer_encoding && !_chunked) {
+    Fail("unsupported transfer-encoding");
+    return false;
+  }
+
+  bool keep_alive;
+  if (_version_major > 1 || (_version_major == 1 && _version_minor >= 1)) {
+    keep_alive = !_connection_close;
+  } else {
+    keep_alive = _connection_keep_alive;
+  }
+
+  bool upgrade;
+  bool no_body = false;
+  if (_type == REQUEST) {
+    upgrade = (_connection_upgrade && _has_upgrade) || _connect_method;
+  } else {
+    upgrade = _status_code == 101;
+    no_body = (_status_code >= 100 && _status_code < 200) ||
+              _status_code == 204 || _status_code == 304;
+  }
+
+  // Responses delimited by closing the connection.
+  bool eof_body = _type == RESPONSE && !no_body && !_chunked &&
+                  _content_length < 0;
+  if (eof_body) {
+    keep_alive = false;
+  }
+
+  jinfo.SetProperty("headers", jheaders);
+  jinfo.SetProperty("shouldKeepAlive", JVal::Bool(keep_alive));
+  jinfo.SetProperty("upgrade", JVal::Bool(upgrade));
+
+  bool skip_body = false;
+  if (!OnHeadersComplete(jinfo, &skip_body)) {
+    return false;
+  }
+
+  if (upgrade) {
+    // The rest of the data belongs to the other protocol.
+    _state = STATE_UPGRADED;
+  } else if (skip_body || no_body || _content_length == 0) {
+    return OnMessageComplete();
+  } else if (_chunked) {
+    _state = STATE_CHUNK_SIZE;
+  } else if (_content_length > 0) {
+    _remaining = _content_length;
+    _state = STATE_BODY_IDENTITY;
+  } else if (eof_body) {
+    _state = STATE_BODY_EOF;
+  } else {
+    // Requests without length have no body.
+    return OnMessageComplete();
+  }
+
+  return true;
+}
+
+
+static bool ParseVersion(const char* str, size_t length,
+                         int* major, int* minor) {
+  if (length != 8 || strncmp(str, "HTTP/", 5) != 0 ||
+      str[5] < '0' || str[5] > '9' || str[6] != '.' ||
+      str[7] < '0' || str[7] > '9') {
+    return false;
+  }
+  *major = str[5] - '0';
+  *minor = str[7] - '0';
+  return true;
+}
+
+
+bool HttpParser::ParseStartLine(const char* line,
+                                size_t length,
+                                JObject& jinfo) {
+  const char* end = line + length;
+
+  if (_type == REQUEST) {
+    // METHOD SP request-target SP HTTP-version
+    const char* sp1 = static_cast<const char*>(memchr(line, ' ', length));
+    const char* sp2 = NULL;
+    for (const char* p = end; p > line; --p) {
+      if (*(p - 1) == ' ') {
+        sp2 = p - 1;
+        break;
+      }
+    }
+    if (sp1 == NULL || sp1 == line || sp2 == NULL || sp2 <= sp1 + 1 ||
+        !ParseVersion(sp2 + 1, end - sp2 - 1,
+                      &_version_major, &_version_minor)) {
+      Fail("invalid request line");
+      return false;
+    }
+
+    _connect_method = MatchName(line, sp1 - line, "CONNECT", 7);
+
+    JObject jmethod(CreateString(line, sp1 - line));
+    JObject jurl(CreateString(sp1 + 1, sp2 - sp1 - 1));
+    jinfo.SetProperty("method", jmethod);
+    jinfo.SetProperty("url", jurl);
+  } else {
+    // HTTP-version SP status-code SP reason-phrase
+    if (length < 12 ||
+        !ParseVersion(line, 8, &_version_major, &_version_minor) ||
+        line[8] != ' ' ||
+        line[9] < '0' || line[9] > '9' ||
+        line[10] < '0' || line[10] > '9' ||
+        line[11] < '0' || line[11] > '9' ||
+        (length > 12 && line[12] != ' ')) {
+      Fail("invalid status line");
+      return false;
+    }
+
+    _status_code = (line[9] - '0') * 100 + (line[10] - '0') * 10 +
+                   (line[11] - '0');
+
+    const char* reason = length > 12 ? line + 13 : end;
+    JObject jreason(CreateString(reason, end - reason));
+    jinfo.SetProperty("statusCode", JVal::Number(_status_code));
+    jinfo.SetProperty("statusMessage", jreason);
+  }
+
+  jinfo.SetProperty("versionMajor", JVal::Number(_version_major));
+  jinfo.SetProperty("versionMinor", JVal::Number(_version_minor));
+
+  return true;
+}
+
+
+bool HttpParser::ParseHeaderField(const char* line,
+                                  size_t length,
+                                  JObject& jheaders) {
+  const char* end = line + length;
+  const char* colon = static_cast<const char*>(memchr(line, ':', length));
+  if (colon == NULL || colon == line) {
+    Fail("invalid header");
+    return false;
+  }
+
+  // No whitespace is allowed in names, this also rejects obsolete line
+  // folding.
+  for (const char* p = line; p < colon; ++p) {
+    if (IsSpace(*p)) {
+      Fail("invalid header");
+      return false;
+    }
+  }
+
+  const char* value = colon + 1;
+  while (value < end && IsSpace(*value)) {
+    ++value;
+  }
+  const char* value_end = end;
+  while (value_end > value && IsSpace(*(value_end - 1))) {
+    --value_end;
+  }
+
+  size_t name_len = colon - line;
+  size_t value_len = value_end - value;
+
+  if (MatchName(line, name_len, "content-length", 14)) {
+    int64_t content_length = 0;
+    if (value_len == 0 || value_len > 15) {
+      Fail("invalid content-length");
+      return false;
+    }
+    for (const char* p = value; p < value_end; ++p) {
+      if (*p < '0' || *p > '9') {
+        Fail("invalid content-length");
+        return false;
+      }
+      content_length = content_length * 10 + (*p - '0');
+    }
+    if (_content_length >= 0 && _content_length != content_length) {
+      Fail("conflicting content-length");
+      return false;
+    }
+    _content_length = content_length;
+  } else if (MatchName(line, name_len, "transfer-encoding", 17)) {
+    // Codings must be listed in a single header.
+    if (_has_transfer_encoding) {
+      Fail("duplicate transfer-encoding");
+      return false;
+    }
+    _has_transfer_encoding = true;
+    // Chunked must be the last coding applied.
+    _chunked = value_len >= 7 &&
+               strncasecmp(value_end - 7, "chunked", 7) == 0 &&
+               (value_len == 7 || *(value_end - 8) == ',' ||
+                IsSpace(*(value_end - 8)));
+  } else if (MatchName(line, name_len, "connection", 10)) {
+    const char* token = value;
+    while (token < value_end) {
+      const char* token_end = token;
+      while (token_end < value_end && *token_end != ',') {
+        ++token_end;
+      }
+      const char* t = token;
+      const char* e = token_end;
+      while (t < e && IsSpace(*t)) {
+        ++t;
+      }
+      while (e > t && IsSpace(*(e - 1))) {
+        --e;
+      }
+      if (MatchName(t, e - t, "close", 5)) {
+        _connection_close = true;
+      } else if (MatchName(t, e - t, "keep-alive", 10)) {
+        _connection_keep_alive = true;
+      } else if (MatchName(t, e - t, "upgrade", 7)) {
+        _connection_upgrade = true;
+      }
+      token = token_end + 1;
+    }
+  } else if (MatchName(line, name_len, "upgrade", 7)) {
+    _has_upgrade = true;
+  }
+
+  uint32_t index = jheaders.GetProperty("length").GetInt32();
+  JObject jname(CreateString(line, name_len));
+  JObject jvalue(CreateString(value, value_len));
+  jheaders.SetElement(index, jname);
+  jheaders.SetElement(index + 1, jvalue);
+
+  return true;
+}
+
+
+size_t HttpParser::ScanChunkSize(const char* data, size_t length) {
+  const char* eol = static_cast<const char*>(memchr(data, '\n', length));
+  size_t len = eol != NULL ? eol - data : length;
+
+  if (_header.length() + len > HTTP_MAX_CHUNK_SIZE_LINE) {
+    Fail("invalid chunk size");
+    return length;
+  }
+  _header.Append(data, len);
+  if (eol == NULL) {
+    return length;
+  }
+
+  // Hex size, optionally followed by extensions which are ignored.
+  const char* p = _header.data();
+  const char* end = p + _header.length();
+  uint64_t size = 0;
+  int digits = 0;
+  for (; p < end; ++p, ++digits) {
+    char c = *p;
+    int value;
+    if (c >= '0' && c <= '9') {
+      value = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      value = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      value = c - 'A' + 10;
+    } else {
+      break;
+    }
+    if (digits >= 15) {
+      break;
+    }
+    size = size * 16 + value;
+  }
+  bool valid = digits > 0 && digits < 15 &&
+               (p == end || *p == ';' || *p == '\r' || IsSpace(*p));
+  _header.Truncate(0);
+
+  if (!valid) {
+    Fail("invalid chunk size");
+  } else if (size == 0) {
+    _line_length = 0;
+    _state = STATE_TRAILERS;
+  } else {
+    _remaining = size;
+    _state = STATE_CHUNK_DATA;
+  }
+
+  return len + 1;
+}
+
+
+size_t HttpParser::ScanTrailers(const char* data, size_t length) {
+  // Trailer fields are skipped up to the empty line.
+  for (size_t i = 0; i < length; ++i) {
+    char c = data[i];
+    if (c == '\n') {
+      if (_line_length == 0) {
+        OnMessageComplete();
+        return i + 1;
+      }
+      _line_length = 0;
+    } else if (c != '\r') {
+      ++_line_length;
+    }
+  }
+  return length;
+}
+
+
+JObject HttpParser::CreateString(const char* data, size_t length) {
+  _scratch.Truncate(0);
+  _scratch.Append(data, length);
+  return JObject(_scratch.CString());
+}
+
+
+bool HttpParser::MakeCallback(const char* name, JArgList& args, bool* ret) {
+  JObject& jparser = jobject();
+  JObject jfunc(jparser.GetProperty(name));
+  if (!jfunc.IsFunction()) {
+    return true;
+  }
+
+  JResult jres(jfunc.Call(jparser, args));
+  if (jres.IsException()) {
+    _exception = new JObject(jres.value());
+    _state = STATE_ERROR;
+    return false;
+  }
+
+  if (ret != NULL) {
+    *ret = jres.value().IsBoolean() && jres.value().GetBoolean();
+  }
+
+  return true;
+}
+
+
+bool HttpParser::OnHeadersComplete(JObject& jinfo, bool* skip_body) {
+  JArgList args(1);
+  args.Add(jinfo);
+  return MakeCallback("_onheaders", args, skip_body);
+}
+
+
+bool HttpParser::OnBody(const char* data, size_t length) {
+  if (length == 0) {
+    return true;
+  }
+
+  JObject jbuffer(CreateBuffer(length));
+  Buffer::FromJBuffer(jbuffer)->Copy(const_cast<char*>(data), length);
+
+  JArgList args(1);
+  args.Add(jbuffer);
+  return MakeCallback("_onbody", args, NULL);
+}
+
+
+bool HttpParser::OnMessageComplete() {
+  // Ready for the next message before javascript can see the parser.
+  StartMessage();
+  return MakeCallback("_onmessagecomplete", JArgList::Empty(), NULL);
+}
+
+
+static bool ReturnResult(JHandlerInfo& handler, HttpParser* parser, int ret) {
+  if (ret == -2) {
+    handler.Throw(parser->exception());
+    return false;
+  }
+
+  if (ret == -1) {
+    char message[128];
+    snprintf(message, sizeof(message), "Parse Error: %s", parser->error());
+    JObject error(JObject::Error(message));
+    handler.Return(error);
+  } else {
+    handler.Return(JVal::Number(ret));
+  }
+
+  return true;
+}
+
+
+// new HTTPParser(type)
+JHANDLER_FUNCTION(HTTPParser, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+
+  JObject* jparser = handler.GetThis();
+  HttpParser::Type type =
+      static_cast<HttpParser::Type>(handler.GetArg(0)->GetInt32());
+
+  HttpParser* parser = new HttpParser(*jparser, type);
+  IOTJS_ASSERT(parser == HttpParser::FromJObject(jparser));
+
+  return true;
+}
+
+
+// execute(buffer)
+//  Returns the number of bytes parsed, or an Error if the data is not valid.
+JHANDLER_FUNCTION(Execute, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  HttpParser* parser = HttpParser::FromJObject(handler.GetThis());
+  Buffer* buffer = Buffer::FromJBuffer(*handler.GetArg(0));
+
+  int ret = parser->Execute(buffer->buffer(), buffer->length());
+
+  return ReturnResult(handler, parser, ret);
+}
+
+
+// finish()
+//  Returns 0, or an Error if a message was left incomplete.
+JHANDLER_FUNCTION(Finish, handler) {
+  HttpParser* parser = HttpParser::FromJObject(handler.GetThis());
+  return ReturnResult(handler, parser, parser->Finish());
+}
+
+
+// reinitialize(type)
+JHANDLER_FUNCTION(Reinitialize, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+
+  HttpParser* parser = HttpParser::FromJObject(handler.GetThis());
+  parser->Reinitialize(
+      static_cast<HttpParser::Type>(handler.GetArg(0)->GetInt32()));
+
+  return true;
+}
+
+
+JObject* InitHttpParser() {
+  Module* module = GetBuiltinModule(MODULE_HTTPPARSER);
+  JObject* httpparser = module->module;
+
+  if (httpparser == NULL) {
+    httpparser = new JObject(HTTPParser);
+
+    JObject prototype;
+    httpparser->SetProperty("prototype", prototype);
+    prototype.SetMethod("execute", Execute);
+    prototype.SetMethod("finish", Finish);
+    prototype.SetMethod("reinitialize", Reinitialize);
+
+    httpparser->SetProperty("REQUEST", JVal::Number(HttpParser::REQUEST));
+    httpparser->SetProperty("RESPONSE", JVal::Number(HttpParser::RESPONSE));
+
+    module->module = httpparser;
+  }
+
+  return httpparser;
+}
+
+
+} // namespace iotjs
@@ -0,0 +1,139 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef IOTJS_MODULE_HTTPPARSER_H
+#define IOTJS_MODULE_HTTPPARSER_H
+
+#include "iotjs_binding.h"
+#include "iotjs_objectwrap.h"
+
+
+namespace iotjs {
+
+
+// Incremental HTTP/1.x request or response parser.
+// Data is fed in chunks as it arrives, parsing resumes where the previous
+// chunk ended. These methods of the parser object are called back:
+//  _onheaders(info) - start line and headers are complete. Returning true
+//                     means the message has no body, e.g. response to HEAD.
+//  _onbody(buffer)  - part of the body, chunked encoding removed.
+//  _onmessagecomplete() - the message is complete.
+class HttpParser : public JObjectWrap {
+ public:
+  enum Type {
+    REQUEST,
+    RESPONSE
+  };
+
+  HttpParser(JObject& jparser, Type type);
+  virtual ~HttpParser();
+
+  static HttpParser* FromJObject(JObject* jparser);
+
+  // Starts over to parse messages of `type`.
+  void Reinitialize(Type type);
+
+  // Parses `length` bytes of `data`. Returns the number of bytes consumed,
+  // less than `length` only when the connection is upgraded to another
+  // protocol. Returns -1 with `error()` set if the data is not valid, or -2
+  // with `exception()` set if a callback threw.
+  int Execute(const char* data, size_t length);
+
+  // Called at the end of the stream. Completes a message whose body lasts
+  // until the end. Returns -1 if a message is left incomplete.
+  int Finish();
+
+  const char* error() { return _error; }
+  JObject& exception() { return *_exception; }
+
+ private:
+  enum State {
+    STATE_HEADER,
+    STATE_BODY_IDENTITY,
+    STATE_BODY_EOF,
+    STATE_CHUNK_SIZE,
+    STATE_CHUNK_DATA,
+    STATE_CHUNK_DATA_END,
+    STATE_TRAILERS,
+    STATE_UPGRADED,
+    STATE_ERROR
+  };
+
+  // Scans for the empty line ending the header section. Returns the number of
+  // bytes consumed.
+  size_t ScanHeader(const char* data, size_t length);
+
+  // Parses a complete start line and header section.
+  bool ParseHeader(const char* data, size_t length);
+  bool ParseStartLine(const char* line, size_t length, JObject& jinfo);
+  bool ParseHeaderField(const char* line, size_t length, JObject& jheaders);
+
+  size_t ScanChunkSize(const char* data, size_t length);
+  size_t ScanTrailers(const char* data, size_t length);
+
+  bool OnHeadersComplete(JObject& jinfo, bool* skip_body);
+  bool OnBody(const char* data, size_t length);
+  bool OnMessageComplete();
+
+  // Calls method `name` of the parser object. Returns false if it threw.
+  // `*ret` is set if it returned true.
+  bool MakeCallback(const char* name, JArgList& args, bool* ret);
+
+  // Creates a javascript string of `length` bytes of `data`. Common header
+  // names and values are external magic strings, those are not allocated.
+  JObject CreateString(const char* data, size_t length);
+
+  void StartMessage();
+  void Fail(const char* error);
+
+  Type _type;
+  State _state;
+  const char* _error;
+  JObject* _exception;
+
+  // Start line and headers not complete in the chunks seen so far.
+  StringBuilder _header;
+  int _header_lines;
+  size_t _line_length;
+
+  // Copies of strings being handed to javascript.
+  StringBuilder _scratch;
+
+  // Bytes left of the body or of the current chunk.
+  uint64_t _remaining;
+
+  // Headers of the current message.
+  int64_t _content_length;
+  bool _chunked;
+  bool _has_transfer_encoding;
+  bool _connection_close;
+  bool _connection_keep_alive;
+  bool _connection_upgrade;
+  bool _has_upgrade;
+  int _version_major;
+  int _version_minor;
+  int _status_code;
+  bool _connect_method;
+};
+
+
+JObject* InitHttpParser();
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_MODULE_HTTPPARSER_H */
@@ -0,0 +1,927 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "iotjs_def.h"
+#include "iotjs_module_json.h"
+#include "iotjs_module_buffer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+namespace iotjs {
+
+
+// Recursive descent parser creating javascript values as it goes, without
+// an intermediate representation.
+class JsonParser {
+ public:
+  JsonParser(const char* text, size_t length)
+      : _text(text)
+      , _pos(text)
+      , _end(text + length)
+      , _failed(false) {
+  }
+
+  JResult Parse();
+
+ private:
+  JObject ParseValue(int depth);
+  JObject ParseObject(int depth);
+  JObject ParseArray(int depth);
+  JObject ParseNumber();
+
+  // Decodes a string at `_pos` to the end of `_scratch` with a terminating
+  // null. `*start` is set to the offset of the decoded string.
+  bool ParseString(size_t* start);
+  bool ParseHex4(unsigned* code);
+
+  bool Literal(const char* word, size_t len);
+  void SkipSpace();
+  JObject Fail();
+
+  const char* _text;
+  const char* _pos;
+  const char* _end;
+  bool _failed;
+
+  // Strings being decoded. Object keys stay here while their value is parsed.
+  StringBuilder _scratch;
+};
+
+
+JResult JsonParser::Parse() {
+  SkipSpace();
+  JObject value(ParseValue(0));
+  if (!_failed) {
+    SkipSpace();
+    if (_pos != _end) {
+      Fail();
+    }
+  }
+
+  if (_failed) {
+    char message[64];
+    if (_pos >= _end) {
+      snprintf(message, sizeof(message), "Unexpected end of JSON input");
+    } else {
+      snprintf(message, sizeof(message),
+               "Unexpected token in JSON at position %u",
+               static_cast<unsigned>(_pos - _text));
+    }
+    return JResult(JObject::SyntaxError(message), JRESULT_EXCEPTION);
+  }
+
+  return JResult(value, JRESULT_OK);
+}
+
+
+JObject JsonParser::ParseValue(int depth) {
+  if (_pos >= _end) {
+    return Fail();
+  }
+
+  switch (*_pos) {
+    case '{':
+      return ParseObject(depth + 1);
+    case '[':
+      return ParseArray(depth + 1);
+    case '"': {
+      size_t start;
+      if (!ParseString(&start)) {
+        return Fail();
+      }
+      JObject str(_scratch.data() + start);
+      _scratch.Truncate(start);
+      return str;
+    }
+    case 't':
+      if (Literal("true", 4)) {
+        return JObject(true);
+      }
+      return Fail();
+    case 'f':
+      if (Literal("false", 5)) {
+        return JObject(false);
+      }
+      return Fail();
+    case 'n':
+      if (Literal("null", 4)) {
+        return JObject::Null();
+      }
+      return Fail();
+    default:
+      return ParseNumber();
+  }
+}
+
+
+JObject JsonParser::ParseObject(int depth) {
+  if (depth > IOTJS_JSON_MAX_DEPTH) {
+    return Fail();
+  }
+
+  JObject object;
+
+  // Skip '{'.
+  ++_pos;
+  SkipSpace();
+  if (_pos < _end && *_pos == '}') {
+    ++_pos;
+    return object;
+  }
+
+  while (true) {
+    size_t key;
+    if (_pos >= _end || *_pos != '"' || !ParseString(&key)) {
+      return Fail();
+    }
+
+    SkipSpace();
+    if (_pos >= _end || *_pos != ':') {
+      return Fail();
+    }
+    ++_pos;
+    SkipSpace();
+
+    JObject value(ParseValue(depth));
+    if (_failed) {
+      return value;
+    }
+    object.SetProperty(_scratch.data() + key, value);
+    _scratch.Truncate(key);
+
+    SkipSpace();
+    if (_pos >= _end) {
+      return Fail();
+    }
+    if (*_pos == '}') {
+      ++_pos;
+      return object;
+    }
+    if (*_pos != ',') {
+      return Fail();
+    }
+    ++_pos;
+    SkipSpace();
+  }
+}
+
+
+JObject JsonParser::ParseArray(int depth) {
+  if (depth > IOTJS_JSON_MAX_DEPTH) {
+    return Fail();
+  }
+
+  JObject array(JObject::Array());
+
+  // Skip '['.
+  ++_pos;
+  SkipSpace();
+  if (_pos < _end && *_pos == ']') {
+    ++_pos;
+    return array;
+  }
+
+  for (uint32_t index = 0; ; ++index) {
+    JObject value(ParseValue(depth));
+    if (_failed) {
+      return value;
+    }
+    array.SetElement(index, value);
+
+    SkipSpace();
+    if (_pos >= _end) {
+      return Fail();
+    }
+    if (*_pos == ']') {
+      ++_pos;
+      return array;
+    }
+    if (*_pos != ',') {
+      return Fail();
+    }
+    ++_pos;
+    SkipSpace();
+  }
+}
+
+
+static inline bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+
+JObject JsonParser::ParseNumber() {
+  const char* start = _pos;
+  bool negative = false;
+  bool integer = true;
+
+  if (_pos < _end && *_pos == '-') {
+    negative = true;
+    ++_pos;
+  }
+
+  // Integer part, no leading zeros.
+  if (_pos >= _end || !IsDigit(*_pos)) {
+    return Fail();
+  }
+  if (*_pos == '0') {
+    ++_pos;
+  } else {
+    while (_pos < _end && IsDigit(*_pos)) {
+      ++_pos;
+    }
+  }
+  const char* int_end = _pos;
+
+  if (_pos < _end && *_pos == '.') {
+    integer = false;
+    ++_pos;
+    if (_pos >= _end || !IsDigit(*_pos)) {
+      return Fail();
+    }
+    while (_pos < _end && IsDigit(*_pos)) {
+      ++_pos;
+    }
+  }
+
+  if (_pos < _end && (*_pos == 'e' || *_pos == 'E')) {
+    integer = false;
+    ++_pos;
+    if (_pos < _end && (*_pos == '+' || *_pos == '-')) {
+      ++_pos;
+    }
+    if (_pos >= _end || !IsDigit(*_pos)) {
+      return Fail();
+    }
+    while (_pos < _end && IsDigit(*_pos)) {
+      ++_pos;
+    }
+  }
+
+  // Small integers, the common case, are converted here.
+  const char* digits = negative ? start + 1 : start;
+  if (integer && int_end - digits <= 9) {
+    int value = 0;
+    for (const char* p = digits; p < int_end; ++p) {
+      value = value * 10 + (*p - '0');
+    }
+    if (negative) {
+      return value == 0 ? JObject(-0.0) : JObject(-value);
+    }
+    return JObject(value);
+  }
+
+  // The text may not be null terminated, `strtod()` gets a copy.
+  size_t mark = _scratch.length();
+  _scratch.Append(start, _pos - start);
+  double value = strtod(_scratch.CString() + mark, NULL);
+  _scratch.Truncate(mark);
+
+  return JObject(value);
+}
+
+
+bool JsonParser::ParseHex4(unsigned* code) {
+  if (_end - _pos < 4) {
+    return false;
+  }
+  unsigned value = 0;
+  for (int i = 0; i < 4; ++i) {
+    char c = *_pos++;
+    value <<= 4;
+    if (c >= '0' && c <= '9') {
+      value |= c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      value |= c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      value |= c - 'A' + 10;
+    } else {
+      return false;
+    }
+  }
+  *code = value;
+  return true;
+}
+
+
+bool JsonParser::ParseString(size_t* start) {
+  *start = _scratch.length();
+
+  // Skip '"'.
+  ++_pos;
+
+  while (true) {
+    // Copy the run of plain characters at once.
+    const char* run = _pos;
+    while (_pos < _end && *_pos != '"' && *_pos != '\\' &&
+           static_cast<unsigned char>(*_pos) >= 0x20) {
+      ++_pos;
+    }
+    _scratch.Append(run, _pos - run);
+
+    if (_pos >= _end) {
+      return false;
+    }
+
+    char c = *_pos++;
+    if (c == '"') {
+      _scratch.Append('\0');
+      return true;
+    }
+    if (c != '\\' || _pos >= _end) {
+      // Control characters must be escaped.
+      return false;
+    }
+
+    c = *_pos++;
+    switch (c) {
+      case '"': _scratch.Append('"'); break;
+      case '\\': _scratch.Append('\\'); break;
+      case '/': _scratch.Append('/'); break;
+      case 'b': _scratch.Append('\b'); break;
+      case 'f': _scratch.Append('\f'); break;
+      case 'n': _scratch.Append('\n'); break;
+      case 'r': _scratch.Append('\r'); break;
+      case 't': _scratch.Append('\t'); break;
+      case 'u': {
+        unsigned code;
+        // Strings are null terminated when handed to the engine, so "\u0000"
+        // can not be represented.
+        if (!ParseHex4(&code) || code == 0) {
+          return false;
+        }
+        // The engine keeps strings in CESU-8, surrogates are encoded one by
+        // one.
+        if (code < 0x80) {
+          _scratch.Append(static_cast<char>(code));
+        } else if (code < 0x800) {
+          _scratch.Append(static_cast<char>(0xc0 | (code >> 6)));
+          _scratch.Append(static_cast<char>(0x80 | (code & 0x3f)));
+        } else {
+          _scratch.Append(static_cast<char>(0xe0 | (code >> 12)));
+          _scratch.Append(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+          _scratch.Append(static_cast<char>(0x80 | (code & 0x3f)));
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+}
+
+
+bool JsonParser::Literal(const char* word, size_t len) {
+  if (static_cast<size_t>(_end - _pos) < len || memcmp(_pos, word, len)) {
+    return false;
+  }
+  _pos += len;
+  return true;
+}
+
+
+void JsonParser::SkipSpace() {
+  while (_pos < _end &&
+         (*_pos == ' ' || *_pos == '\t' || *_pos == '\n' || *_pos == '\r')) {
+    ++_pos;
+  }
+}
+
+
+JObject JsonParser::Fail() {
+  _failed = true;
+  return JObject::Undefined();
+}
+
+
+JResult ParseJson(const char* text, size_t length) {
+  JsonParser parser(text, length);
+  return parser.Parse();
+}
+
+
+// Serializer writing straight from javascript values to a single buffer.
+class JsonWriter {
+ public:
+  // `gap` is the indentation of each level, empty for compact output.
+  explicit JsonWriter(const char* gap);
+
+  JResult Write(JObject& value);
+
+ private:
+  enum Error {
+    ERROR_NONE,
+    ERROR_CIRCULAR,
+    ERROR_TOO_DEEP,
+    ERROR_EXCEPTION
+  };
+
+  // Returns false, having written nothing, for values without representation
+  // like undefined and functions.
+  bool WriteValue(JObject& value, int depth);
+  void WriteStructure(JObject& value, int depth);
+  void WriteObject(JObject& object, int depth);
+  void WriteArray(JObject& array, int depth);
+  void WriteNumber(double value);
+  void WriteString(const char* str, size_t len);
+  void WriteIndent(int depth);
+
+  // Fails for objects already on the stack or nested too deep.
+  bool Enter(JObject& object, int depth);
+
+  StringBuilder _out;
+  const char* _gap;
+  Error _error;
+
+  // Thrown by a `toJSON()` method.
+  JObject* _exception;
+
+  JObject _keys;
+  JObject _is_array;
+
+  const JRawObjectType* _stack[IOTJS_JSON_MAX_DEPTH];
+};
+
+
+JsonWriter::JsonWriter(const char* gap)
+    : _gap(gap)
+    , _error(ERROR_NONE)
+    , _exception(NULL)
+    , _keys(JObject::Global().GetProperty("Object").GetProperty("keys"))
+    , _is_array(JObject::Global().GetProperty("Array").GetProperty("isArray")) {
+  IOTJS_ASSERT(_keys.IsFunction());
+  IOTJS_ASSERT(_is_array.IsFunction());
+}
+
+
+JResult JsonWriter::Write(JObject& value) {
+  bool written = WriteValue(value, 0);
+
+  if (_error == ERROR_CIRCULAR) {
+    JObject error(JObject::TypeError("Converting circular structure to JSON"));
+    return JResult(error, JRESULT_EXCEPTION);
+  }
+  if (_error == ERROR_TOO_DEEP) {
+    JObject error(JObject::RangeError("JSON nested too deep"));
+    return JResult(error, JRESULT_EXCEPTION);
+  }
+  if (_error == ERROR_EXCEPTION) {
+    JResult jres(*_exception, JRESULT_EXCEPTION);
+    delete _exception;
+    return jres;
+  }
+  if (!written) {
+    return JResult(JObject::Undefined(), JRESULT_OK);
+  }
+
+  return JResult(JObject(_out.CString()), JRESULT_OK);
+}
+
+
+bool JsonWriter::WriteValue(JObject& value, int depth) {
+  if (_error != ERROR_NONE) {
+    return true;
+  }
+
+  if (value.IsNull()) {
+    _out.Append("null", 4);
+  } else if (value.IsBoolean()) {
+    if (value.GetBoolean()) {
+      _out.Append("true", 4);
+    } else {
+      _out.Append("false", 5);
+    }
+  } else if (value.IsNumber()) {
+    WriteNumber(value.GetNumber());
+  } else if (value.IsString()) {
+    char* str = value.GetCString();
+    WriteString(str, strlen(str));
+    JObject::ReleaseCString(str);
+  } else if (value.IsFunction() || !value.IsObject()) {
+    return false;
+  } else {
+    JObject to_json(value.GetProperty("toJSON"));
+    if (!to_json.IsFunction()) {
+      WriteStructure(value, depth);
+      return true;
+    }
+
+    JResult jres(to_json.Call(value, JArgList::Empty()));
+    if (jres.IsException()) {
+      _error = ERROR_EXCEPTION;
+      _exception = new JObject(jres.value());
+      return true;
+    }
+
+    // Objects returned by `toJSON()` are written as they are, without calling
+    // their own `toJSON()`.
+    JObject& replaced = jres.value();
+    if (replaced.IsFunction() || !replaced.IsObject()) {
+      return WriteValue(replaced, depth);
+    }
+    WriteStructure(replaced, depth);
+  }
+
+  return true;
+}
+
+
+void JsonWriter::WriteStructure(JObject& value, int depth) {
+  JArgList args(1);
+  args.Add(value);
+  if (_is_array.CallOk(JObject::Null(), args).GetBoolean()) {
+    WriteArray(value, depth);
+  } else {
+    WriteObject(value, depth);
+  }
+}
+
+
+bool JsonWriter::Enter(JObject& object, int depth) {
+  const JRawObjectType* raw = object.raw_value().v_object;
+  for (int i = 0; i < depth && i < IOTJS_JSON_MAX_DEPTH; ++i) {
+    if (_stack[i] == raw) {
+      _error = ERROR_CIRCULAR;
+      return false;
+    }
+  }
+  if (depth >= IOTJS_JSON_MAX_DEPTH) {
+    _error = ERROR_TOO_DEEP;
+    return false;
+  }
+  _stack[depth] = raw;
+  return true;
+}
+
+
+void JsonWriter::WriteObject(JObject& object, int depth) {
+  if (!Enter(object, depth)) {
+    return;
+  }
+
+  JArgList args(1);
+  args.Add(object);
+  JObject keys(_keys.CallOk(JObject::Null(), args));
+  int32_t length = keys.GetProperty("length").GetInt32();
+
+  _out.Append('{');
+  bool empty = true;
+
+  for (int32_t i = 0; i < length && _error == ERROR_NONE; ++i) {
+    JObject jkey(keys.GetElement(i));
+    char* key = jkey.GetCString();
+    JObject value(object.GetProperty(key));
+
+    // Members without representation are dropped with their key.
+    size_t mark = _out.length();
+    if (!empty) {
+      _out.Append(',');
+    }
+    WriteIndent(depth + 1);
+    WriteString(key, strlen(key));
+    _out.Append(':');
+    if (*_gap != '\0') {
+      _out.Append(' ');
+    }
+    JObject::ReleaseCString(key);
+
+    if (WriteValue(value, depth + 1)) {
+      empty = false;
+    } else {
+      _out.Truncate(mark);
+    }
+  }
+
+  if (!empty) {
+    WriteIndent(depth);
+  }
+  _out.Append('}');
+}
+
+
+void JsonWriter::WriteArray(JObject& array, int depth) {
+  if (!Enter(array, depth)) {
+    return;
+  }
+
+  int32_t length = array.GetProperty("length").GetInt32();
+
+  _out.Append('[');
+
+  for (int32_t i = 0; i < length && _error == ERROR_NONE; ++i) {
+    if (i > 0) {
+      _out.Append(',');
+    }
+    WriteIndent(depth + 1);
+    JObject value(array.GetElement(i));
+    if (!WriteValue(value, depth + 1)) {
+      _out.Append("null", 4);
+    }
+  }
+
+  if (length > 0) {
+    WriteIndent(depth);
+  }
+  _out.Append(']');
+}
+
+
+void JsonWriter::WriteNumber(double value) {
+  if (isnan(value) || isinf(value)) {
+    _out.Append("null", 4);
+    return;
+  }
+
+  char str[32];
+  if (value == floor(value) && fabs(value) < 1e21) {
+    snprintf(str, sizeof(str), "%.0f", value == 0 ? 0.0 : value);
+  } else {
+    // Shortest precision that reads back the same value.
+    for (int precision = 15; precision <= 17; ++precision) {
+      snprintf(str, sizeof(str), "%.*g", precision, value);
+      if (strtod(str, NULL) == value) {
+        break;
+      }
+    }
+    // Drop zeros leading the exponent, e.g. "1e-07" to "1e-7".
+    char* exp = strchr(str, 'e');
+    if (exp != NULL) {
+      char* digits = exp + 2;
+      char* p = digits;
+      while (*p == '0' && *(p + 1) != '\0') {
+        ++p;
+      }
+      memmove(digits, p, strlen(p) + 1);
+    }
+  }
+  _out.Append(str);
+}
+
+
+void JsonWriter::WriteString(const char* str, size_t len) {
+  static const char hex[] = "0123456789abcdef";
+
+  _out.Append('"');
+
+  const char* run = str;
+  const char* end = str + len;
+  for (const char* p = str; p < end; ++p) {
+    unsigned char c = *p;
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    _out.Append(run, p - run);
+    run = p + 1;
+
+    switch (c) {
+      case '"': _out.Append("\\\"", 2); break;
+      case '\\': _out.Append("\\\\", 2); break;
+      case '\b': _out.Append("\\b", 2); break;
+      case '\f': _out.Append("\\f", 2); break;
+      case '\n': _out.Append("\\n", 2); break;
+      case '\r': _out.Append("\\r", 2); break;
+      case '\t': _out.Append("\\t", 2); break;
+      default: {
+        char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+        _out.Append(escaped, sizeof(escaped));
+        break;
+      }
+    }
+  }
+  _out.Append(run, end - run);
+
+  _out.Append('"');
+}
+
+
+void JsonWriter::WriteIndent(int depth) {
+  if (*_gap == '\0') {
+    return;
+  }
+  _out.Append('\n');
+  for (int i = 0; i < depth; ++i) {
+    _out.Append(_gap);
+  }
+}
+
+
+JsonRecordParser::JsonRecordParser(JObject& jparser, size_t max_length)
+    : JObjectWrap(jparser)
+    , _max_length(max_length)
+    , _overflow(false) {
+}
+
+
+JsonRecordParser* JsonRecordParser::FromJObject(JObject* jparser) {
+  JsonRecordParser* parser =
+      reinterpret_cast<JsonRecordParser*>(jparser->GetNative());
+  IOTJS_ASSERT(parser != NULL);
+  return parser;
+}
+
+
+void JsonRecordParser::Feed(const char* data,
+                            size_t length,
+                            JObject& jrecords) {
+  const char* end = data + length;
+
+  while (data < end) {
+    const char* newline =
+        static_cast<const char*>(memchr(data, '\n', end - data));
+    size_t len = (newline != NULL ? newline : end) - data;
+
+    if (_overflow) {
+      // Rest of a line already reported too long.
+    } else if (_max_length > 0 && _partial.length() + len > _max_length) {
+      JObject error(JObject::RangeError("JSON record too long"));
+      jrecords.SetElement(jrecords.GetProperty("length").GetInt32(), error);
+      _partial.Truncate(0);
+      _overflow = true;
+    } else if (newline != NULL && _partial.length() == 0) {
+      // Whole line within the chunk, parsed in place.
+      ParseLine(data, len, jrecords);
+    } else {
+      _partial.Append(data, len);
+      if (newline != NULL) {
+        ParseLine(_partial.data(), _partial.length(), jrecords);
+        _partial.Truncate(0);
+      }
+    }
+
+    if (newline == NULL) {
+      break;
+    }
+    _overflow = false;
+    data = newline + 1;
+  }
+}
+
+
+void JsonRecordParser::Flush(JObject& jrecords) {
+  if (!_overflow && _partial.length() > 0) {
+    ParseLine(_partial.data(), _partial.length(), jrecords);
+  }
+  _partial.Truncate(0);
+  _overflow = false;
+}
+
+
+void JsonRecordParser::ParseLine(const char* line,
+                                 size_t length,
+                                 JObject& jrecords) {
+  // Blank lines, including a lone "\r", separate nothing.
+  size_t i = 0;
+  while (i < length && (line[i] == ' ' || line[i] == '\t' ||
+                        line[i] == '\r')) {
+    ++i;
+  }
+  if (i == length) {
+    return;
+  }
+
+  JResult jres(ParseJson(line, length));
+  jrecords.SetElement(jrecords.GetProperty("length").GetInt32(), jres.value());
+}
+
+
+// parse(text)
+//  `text` is a string or a Buffer holding the JSON text.
+JHANDLER_FUNCTION(Parse, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+
+  JObject* jtext = handler.GetArg(0);
+
+  if (jtext->IsString()) {
+    char* text = jtext->GetCString();
+    JResult jres(ParseJson(text, strlen(text)));
+    JObject::ReleaseCString(text);
+    if (jres.IsException()) {
+      handler.Throw(jres.value());
+      return false;
+    }
+    handler.Return(jres.value());
+    return true;
+  }
+
+  IOTJS_ASSERT(jtext->IsObject());
+
+  // Buffers are parsed in place.
+  Buffer* buffer = Buffer::FromJBuffer(*jtext);
+  JResult jres(ParseJson(buffer->buffer(), buffer->length()));
+  if (jres.IsException()) {
+    handler.Throw(jres.value());
+    return false;
+  }
+  handler.Return(jres.value());
+
+  return true;
+}
+
+
+// stringify(value, gap)
+JHANDLER_FUNCTION(Stringify, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(1)->IsString());
+
+  char* gap = handler.GetArg(1)->GetCString();
+  JsonWriter writer(gap);
+  JResult jres(writer.Write(*handler.GetArg(0)));
+  JObject::ReleaseCString(gap);
+
+  if (jres.IsException()) {
+    handler.Throw(jres.value());
+    return false;
+  }
+  handler.Return(jres.value());
+
+  return true;
+}
+
+
+// new RecordParser(maxLength)
+JHANDLER_FUNCTION(RecordParser, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+
+  JObject* jparser = handler.GetThis();
+  int max_length = handler.GetArg(0)->GetInt32();
+
+  JsonRecordParser* parser = new JsonRecordParser(*jparser, max_length);
+  IOTJS_ASSERT(parser == JsonRecordParser::FromJObject(jparser));
+
+  return true;
+}
+
+
+// feed(buffer)
+//  Returns an array of the records completed by `buffer`.
+JHANDLER_FUNCTION(Feed, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  JsonRecordParser* parser = JsonRecordParser::FromJObject(handler.GetThis());
+  Buffer* buffer = Buffer::FromJBuffer(*handler.GetArg(0));
+
+  JObject jrecords(JObject::Array());
+  parser->Feed(buffer->buffer(), buffer->length(), jrecords);
+  handler.Return(jrecords);
+
+  return true;
+}
+
+
+// flush()
+//  Returns an array with the record in the unfinished line, if any.
+JHANDLER_FUNCTION(Flush, handler) {
+  JsonRecordParser* parser = JsonRecordParser::FromJObject(handler.GetThis());
+
+  JObject jrecords(JObject::Array());
+  parser->Flush(jrecords);
+  handler.Return(jrecords);
+
+  return true;
+}
+
+
+JObject* InitJson() {
+  Module* module = GetBuiltinModule(MODULE_JSON);
+  JObject* json = module->module;
+
+  if (json == NULL) {
+    json = new JObject();
+    json->SetMethod("parse", Parse);
+    json->SetMethod("stringify", Stringify);
+
+    JObject record_parser(RecordParser);
+    JObject prototype;
+    record_parser.SetProperty("prototype", prototype);
+    prototype.SetMethod("feed", Feed);
+    prototype.SetMethod("flush", Flush);
+    json->SetProperty("RecordParser", record_parser);
+
+    module->module = json;
+  }
+
+  return json;
+}
+
+
+} // namespace iotjs
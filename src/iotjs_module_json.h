@@ -0,0 +1,63 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IOTJS_MODULE_JSON_H
+#define IOTJS_MODULE_JSON_H
+
+#include "iotjs_binding.h"
+#include "iotjs_objectwrap.h"
+
+
+namespace iotjs {
+
+
+// Parses a JSON text of `length` bytes into javascript values. The result is
+// an exception holding a SyntaxError if the text is not valid.
+JResult ParseJson(const char* text, size_t length);
+
+
+// Parser of newline delimited JSON records arriving in chunks.
+// Complete lines are parsed straight from the chunk, only the unfinished
+// line at the end of a chunk is kept until the next one.
+class JsonRecordParser : public JObjectWrap {
+ public:
+  // Lines longer than `max_length` bytes are dropped, zero for no limit.
+  JsonRecordParser(JObject& jparser, size_t max_length);
+
+  static JsonRecordParser* FromJObject(JObject* jparser);
+
+  // Appends the records completed by `data` to the `jrecords` array. Lines
+  // that are not valid JSON are appended as SyntaxError objects.
+  void Feed(const char* data, size_t length, JObject& jrecords);
+
+  // Parses the unfinished line as the last record.
+  void Flush(JObject& jrecords);
+
+ private:
+  void ParseLine(const char* line, size_t length, JObject& jrecords);
+
+  size_t _max_length;
+  StringBuilder _partial;
+  bool _overflow;
+};
+
+
+JObject* InitJson();
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_MODULE_JSON_H */
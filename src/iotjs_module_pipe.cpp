@@ -0,0 +1,158 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "iotjs_def.h"
+#include "iotjs_module_pipe.h"
+
+#include "iotjs_streamwrap.h"
+
+
+namespace iotjs {
+
+
+// Unix domain socket or named pipe.
+class PipeWrap : public StreamWrap {
+ public:
+  explicit PipeWrap(Environment* env,
+                    JObject& jpipe,
+                    JObject& jholder)
+      : StreamWrap(jpipe, jholder, reinterpret_cast<uv_stream_t*>(&_handle)) {
+    uv_pipe_init(env->loop(), &_handle, 0);
+  }
+
+  virtual JObject CreateClientHandle() {
+    JObject jpipe = CreateInstance(GetBuiltinModule(MODULE_PIPE)->module);
+    new PipeWrap(Environment::GetEnv(), jpipe, JObject::Undefined());
+    return jpipe;
+  }
+
+  static PipeWrap* FromJObject(JObject* jpipe) {
+    PipeWrap* wrap = reinterpret_cast<PipeWrap*>(jpipe->GetNative());
+    IOTJS_ASSERT(wrap != NULL);
+    return wrap;
+  }
+
+  uv_pipe_t* pipe_handle() {
+    return &_handle;
+  }
+
+ protected:
+  uv_pipe_t _handle;
+};
+
+
+JHANDLER_FUNCTION(Pipe, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  Environment* env = Environment::GetEnv();
+  JObject* jpipe = handler.GetThis();
+  JObject* jholder = handler.GetArg(0);
+
+  PipeWrap* pipe_wrap = new PipeWrap(env, *jpipe, *jholder);
+  IOTJS_ASSERT(pipe_wrap->jnative().IsObject());
+  IOTJS_ASSERT(jpipe->GetNative() != 0);
+
+  return true;
+}
+
+
+// Use an existing file descriptor as the pipe.
+// [0] fd
+JHANDLER_FUNCTION(Open, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+
+  PipeWrap* wrap = PipeWrap::FromJObject(handler.GetThis());
+  int fd = handler.GetArg(0)->GetInt32();
+
+  int err = uv_pipe_open(wrap->pipe_handle(), fd);
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+// Bind the pipe to a path, called from server before start listening.
+// [0] path
+JHANDLER_FUNCTION(Bind, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsString());
+
+  PipeWrap* wrap = PipeWrap::FromJObject(handler.GetThis());
+  LocalString path(handler.GetArg(0)->GetCString());
+
+  int err = uv_pipe_bind(wrap->pipe_handle(), path);
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+// Connect to the server listening on the path.
+// [0] path
+// [1] callback
+JHANDLER_FUNCTION(Connect, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsString());
+  IOTJS_ASSERT(handler.GetArg(1)->IsFunction());
+
+  PipeWrap* pipe_wrap = PipeWrap::FromJObject(handler.GetThis());
+  LocalString path(handler.GetArg(0)->GetCString());
+
+  ConnectReqWrap* req_wrap = new ConnectReqWrap(*handler.GetArg(1));
+
+  // Errors are reported to `AfterConnect`.
+  uv_pipe_connect(req_wrap->connect_req(),
+                  pipe_wrap->pipe_handle(),
+                  path,
+                  AfterConnect);
+
+  req_wrap->Dispatched();
+
+  handler.Return(JVal::Number(0));
+
+  return true;
+}
+
+
+JObject* InitPipe() {
+  Module* module = GetBuiltinModule(MODULE_PIPE);
+  JObject* pipe = module->module;
+
+  if (pipe == NULL) {
+    pipe = new JObject(Pipe);
+
+    JObject prototype;
+    pipe->SetProperty("prototype", prototype);
+
+    SetStreamMethods(prototype);
+    prototype.SetMethod("open", Open);
+    prototype.SetMethod("connect", Connect);
+    prototype.SetMethod("bind", Bind);
+
+    module->module = pipe;
+  }
+
+  return pipe;
+}
+
+
+} // namespace iotjs
@@ -18,6 +18,7 @@
 #include "iotjs_js.h"
 
 #include <cstdlib>
+#include <limits.h>
 #include <string.h>
 
 
@@ -219,6 +220,16 @@ JHANDLER_FUNCTION(Cwd, handler){
 }
 
 
+// Returns high resolution time in nanoseconds.
+JHANDLER_FUNCTION(Hrtime, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 0);
+
+  handler.Return(JVal::Number(static_cast<double>(uv_hrtime())));
+
+  return true;
+}
+
+
 JHANDLER_FUNCTION(DoExit, handler) {
   IOTJS_ASSERT(handler.GetArgLength() == 1);
   IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
@@ -238,6 +249,11 @@ void SetNativeSources(JObject* native_sources) {
 }
 
 
+#if !defined(__NUTTX__)
+extern "C" char** environ;
+#endif
+
+
 void SetProcessEnv(JObject* process){
   const char *homedir;
   homedir = getenv("HOME");
@@ -247,10 +263,42 @@ void SetProcessEnv(JObject* process){
   JObject home(homedir);
   JObject env;
   env.SetProperty("HOME", home);
+
+#if !defined(__NUTTX__)
+  // Whole environment, so that it can be passed on to child processes.
+  for (char** var = environ; *var != NULL; ++var) {
+    const char* eq = strchr(*var, '=');
+    if (eq == NULL || eq == *var) {
+      continue;
+    }
+    LocalString name(eq - *var + 1);
+    strncpy(name, *var, eq - *var);
+    JObject value(eq + 1);
+    env.SetProperty(name, value);
+  }
+#endif
+
   process->SetProperty("env", env);
 }
 
 
+#ifndef PATH_MAX
+ #define PATH_MAX 256
+#endif
+
+
+void SetProcessExecPath(JObject* process) {
+  char path[PATH_MAX];
+  size_t size = sizeof(path);
+  if (uv_exepath(path, &size) != 0) {
+    path[0] = '\0';
+  }
+
+  JObject jpath(path);
+  process->SetProperty("execPath", jpath);
+}
+
+
 JObject* InitProcess() {
   Module* module = GetBuiltinModule(MODULE_PROCESS);
   JObject* process = module->module;
@@ -263,7 +311,9 @@ JObject* InitProcess() {
     process->SetMethod("readSource", ReadSource);
     process->SetMethod("cwd", Cwd);
     process->SetMethod("doExit", DoExit);
+    process->SetMethod("_hrtime", Hrtime);
     SetProcessEnv(process);
+    SetProcessExecPath(process);
 
     // process.native_sources
     JObject native_sources;
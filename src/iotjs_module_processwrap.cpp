@@ -0,0 +1,276 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "iotjs_def.h"
+#include "iotjs_module_processwrap.h"
+
+#include "iotjs_handlewrap.h"
+#include "iotjs_streamwrap.h"
+
+#include <string.h>
+
+
+namespace iotjs {
+
+
+// Child process.
+class ProcessWrap : public HandleWrap {
+ public:
+  explicit ProcessWrap(JObject& jprocess, JObject& jholder)
+      : HandleWrap(jprocess,
+                   jholder,
+                   reinterpret_cast<uv_handle_t*>(&_handle)) {
+  }
+
+  static ProcessWrap* FromJObject(JObject* jprocess) {
+    ProcessWrap* wrap = reinterpret_cast<ProcessWrap*>(jprocess->GetNative());
+    IOTJS_ASSERT(wrap != NULL);
+    return wrap;
+  }
+
+  uv_process_t* process_handle() {
+    return &_handle;
+  }
+
+ protected:
+  uv_process_t _handle;
+};
+
+
+JHANDLER_FUNCTION(Process, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+
+  JObject* jprocess = handler.GetThis();
+  JObject* jholder = handler.GetArg(0);
+
+  ProcessWrap* process_wrap = new ProcessWrap(*jprocess, *jholder);
+  IOTJS_ASSERT(process_wrap->jnative().IsObject());
+  IOTJS_ASSERT(jprocess->GetNative() != 0);
+
+  return true;
+}
+
+
+// Returns a NULL terminated copy of an array of strings.
+static char** GetStringArray(JObject& jarray) {
+  int length = jarray.GetProperty("length").GetInt32();
+
+  char** strings = new char*[length + 1];
+  for (int i = 0; i < length; ++i) {
+    JObject jstring = jarray.GetElement(i);
+    IOTJS_ASSERT(jstring.IsString());
+    strings[i] = jstring.GetCString();
+  }
+  strings[length] = NULL;
+
+  return strings;
+}
+
+
+static void ReleaseStringArray(char** strings) {
+  if (strings == NULL) {
+    return;
+  }
+  for (char** s = strings; *s != NULL; ++s) {
+    JObject::ReleaseCString(*s);
+  }
+  delete [] strings;
+}
+
+
+static void OnExit(uv_process_t* handle,
+                   int64_t exit_status,
+                   int term_signal) {
+  ProcessWrap* wrap = reinterpret_cast<ProcessWrap*>(handle->data);
+  IOTJS_ASSERT(wrap != NULL);
+
+  JObject jholder = wrap->jholder();
+  IOTJS_ASSERT(jholder.IsObject());
+
+  // function _onexit(exitCode, signal)
+  JObject jonexit = jholder.GetProperty("_onexit");
+  IOTJS_ASSERT(jonexit.IsFunction());
+
+  JArgList args(2);
+  args.Add(JVal::Number(static_cast<int>(exit_status)));
+  args.Add(JVal::Number(term_signal));
+
+  MakeCallback(jonexit, jholder, args);
+}
+
+
+// Largest number of file descriptors set up for a child.
+#define PROCESS_MAX_STDIO 8
+
+
+// Fills `stdio` from the `stdio` option, an array with for each descriptor
+// of the child either
+//    a pipe handle - connected to a new pipe
+//    a number - a descriptor of this process shared with the child
+//    'ignore' - left closed
+//    null or undefined - shared if it is a standard input or output
+// Returns the number of descriptors.
+static int GetStdio(JObject& joptions, uv_stdio_container_t* stdio) {
+  for (int i = 0; i < PROCESS_MAX_STDIO; ++i) {
+    stdio[i].flags = i < 3 ? UV_INHERIT_FD : UV_IGNORE;
+    stdio[i].data.fd = i;
+  }
+
+  JObject jstdio = joptions.GetProperty("stdio");
+  if (!jstdio.IsObject()) {
+    return 3;
+  }
+
+  int count = jstdio.GetProperty("length").GetInt32();
+  if (count < 3) {
+    count = 3;
+  } else if (count > PROCESS_MAX_STDIO) {
+    count = PROCESS_MAX_STDIO;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    JObject jentry = jstdio.GetElement(i);
+    if (jentry.IsNumber()) {
+      stdio[i].flags = UV_INHERIT_FD;
+      stdio[i].data.fd = jentry.GetInt32();
+    } else if (jentry.IsString()) {
+      stdio[i].flags = UV_IGNORE;
+    } else if (jentry.IsObject()) {
+      StreamWrap* stream_wrap = StreamWrap::FromJObject(&jentry);
+      stdio[i].flags = static_cast<uv_stdio_flags>(
+          UV_CREATE_PIPE | UV_READABLE_PIPE | UV_WRITABLE_PIPE);
+      stdio[i].data.stream = stream_wrap->stream_handle();
+    }
+  }
+
+  return count;
+}
+
+
+// Start the child process, sets `pid` of this object on success.
+// [0] options
+//    file - program to run, searched in PATH
+//    args - arguments including the program name
+//    envPairs - optional, "NAME=VALUE" strings, the parent's otherwise
+//    cwd - optional working directory
+//    stdio - optional descriptors of the child, see `GetStdio()`. Standard
+//            input and outputs are shared with this process by default.
+JHANDLER_FUNCTION(Spawn, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  Environment* env = Environment::GetEnv();
+  ProcessWrap* wrap = ProcessWrap::FromJObject(handler.GetThis());
+  JObject* joptions = handler.GetArg(0);
+
+  uv_process_options_t options;
+  memset(&options, 0, sizeof(options));
+  options.exit_cb = OnExit;
+
+  JObject jfile = joptions->GetProperty("file");
+  IOTJS_ASSERT(jfile.IsString());
+  LocalString file(jfile.GetCString());
+  options.file = file;
+
+  JObject jargs = joptions->GetProperty("args");
+  IOTJS_ASSERT(jargs.IsObject());
+  options.args = GetStringArray(jargs);
+
+  JObject jenv = joptions->GetProperty("envPairs");
+  if (jenv.IsObject()) {
+    options.env = GetStringArray(jenv);
+  }
+
+  char* cwd = NULL;
+  JObject jcwd = joptions->GetProperty("cwd");
+  if (jcwd.IsString()) {
+    cwd = jcwd.GetCString();
+    options.cwd = cwd;
+  }
+
+  uv_stdio_container_t stdio[PROCESS_MAX_STDIO];
+  options.stdio = stdio;
+  options.stdio_count = GetStdio(*joptions, stdio);
+
+  int err = uv_spawn(env->loop(), wrap->process_handle(), &options);
+  if (err == 0) {
+    wrap->jnative().SetProperty("pid",
+                                JVal::Number(wrap->process_handle()->pid));
+  }
+
+  ReleaseStringArray(options.args);
+  ReleaseStringArray(options.env);
+  if (cwd != NULL) {
+    JObject::ReleaseCString(cwd);
+  }
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+// Send a signal to the child process.
+// [0] signal number
+JHANDLER_FUNCTION(Kill, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+
+  ProcessWrap* wrap = ProcessWrap::FromJObject(handler.GetThis());
+  int signum = handler.GetArg(0)->GetInt32();
+
+  int err = uv_process_kill(wrap->process_handle(), signum);
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+JHANDLER_FUNCTION(Close, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  ProcessWrap* wrap = ProcessWrap::FromJObject(handler.GetThis());
+  wrap->Close(NULL);
+
+  return true;
+}
+
+
+JObject* InitProcessWrap() {
+  Module* module = GetBuiltinModule(MODULE_PROCESSWRAP);
+  JObject* process_wrap = module->module;
+
+  if (process_wrap == NULL) {
+    process_wrap = new JObject(Process);
+
+    JObject prototype;
+    process_wrap->SetProperty("prototype", prototype);
+
+    prototype.SetMethod("spawn", Spawn);
+    prototype.SetMethod("kill", Kill);
+    prototype.SetMethod("close", Close);
+
+    module->module = process_wrap;
+  }
+
+  return process_wrap;
+}
+
+
+} // namespace iotjs
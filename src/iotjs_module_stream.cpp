@@ -17,17 +17,378 @@
 #include "iotjs_def.h"
 #include "iotjs_module_stream.h"
 
+#include "iotjs_module_buffer.h"
+#include "iotjs_streamwrap.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
 
 namespace iotjs {
 
 
+enum {
+  FIELD_LITERAL = -1,
+  FIELD_LENGTH = -2,
+  FIELD_DATE = -3,
+};
+
+
+static const char* kWeekDays[] = {
+  "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+};
+
+static const char* kMonths[] = {
+  "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+  "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+
+// State of the module kept in the environment.
+class StreamState : public ModuleState {
+ public:
+  StreamState() : date_time(0) {
+    date[0] = '\0';
+  }
+
+  char date[32];
+  time_t date_time;
+};
+
+
+static StreamState* GetStreamState() {
+  Module* module = GetBuiltinModule(MODULE_STREAM);
+  if (module->state == NULL) {
+    module->state = new StreamState();
+  }
+  return static_cast<StreamState*>(module->state);
+}
+
+
+// Returns the current time as an HTTP date. Formatted once a second.
+static const char* HttpDate() {
+  StreamState* state = GetStreamState();
+
+  time_t now = time(NULL);
+  if (now != state->date_time) {
+    struct tm tm;
+    gmtime_r(&now, &tm);
+    snprintf(state->date, sizeof(state->date),
+             "%s, %02d %s %04d %02d:%02d:%02d GMT",
+             kWeekDays[tm.tm_wday], tm.tm_mday, kMonths[tm.tm_mon],
+             tm.tm_year + 1900, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    state->date_time = now;
+  }
+
+  return state->date;
+}
+
+
+static void AppendInteger(StringBuilder& builder, int64_t value) {
+  char digits[24];
+  size_t pos = sizeof(digits);
+  bool negative = value < 0;
+  uint64_t rest = negative ? -static_cast<uint64_t>(value) : value;
+
+  do {
+    digits[--pos] = '0' + rest % 10;
+    rest /= 10;
+  } while (rest > 0);
+
+  if (negative) {
+    digits[--pos] = '-';
+  }
+
+  builder.Append(digits + pos, sizeof(digits) - pos);
+}
+
+
+HeaderTemplate::HeaderTemplate(JObject& jtemplate,
+                               const char* text,
+                               size_t length)
+    : JObjectWrap(jtemplate)
+    , _nsegments(0) {
+  const char* end = text + length;
+  const char* literal = text;
+  size_t nfields = 0;
+
+  for (const char* p = text; p < end; ++p) {
+    if (*p != '{') {
+      continue;
+    }
+
+    const char* close = static_cast<const char*>(memchr(p, '}', end - p));
+    if (close == NULL) {
+      break;
+    }
+
+    int field = FIELD_LITERAL;
+    size_t name_length = close - p - 1;
+    if (name_length == 6 && strncmp(p + 1, "length", 6) == 0) {
+      field = FIELD_LENGTH;
+    } else if (name_length == 4 && strncmp(p + 1, "date", 4) == 0) {
+      field = FIELD_DATE;
+    } else if (name_length == 1 && p[1] >= '0' && p[1] <= '9') {
+      field = p[1] - '0';
+    }
+
+    if (field == FIELD_LITERAL) {
+      // Not a field, braces are a part of the text.
+      continue;
+    }
+
+    if (++nfields > IOTJS_TEMPLATE_MAX_FIELDS) {
+      _nsegments = 0;
+      return;
+    }
+
+    AddLiteral(literal, p - literal);
+
+    Segment& segment = _segments[_nsegments++];
+    segment.field = field;
+    segment.offset = 0;
+    segment.length = 0;
+
+    p = close;
+    literal = close + 1;
+  }
+
+  AddLiteral(literal, end - literal);
+}
+
+
+// Empty literals are dropped, except to keep an empty template valid.
+void HeaderTemplate::AddLiteral(const char* text, size_t length) {
+  if (length > 0 || _nsegments == 0) {
+    Segment& segment = _segments[_nsegments++];
+    segment.field = FIELD_LITERAL;
+    segment.offset = _text.length();
+    segment.length = length;
+    _text.Append(text, length);
+  }
+}
+
+
+HeaderTemplate* HeaderTemplate::FromJObject(JObject* jtemplate) {
+  HeaderTemplate* tmpl =
+      reinterpret_cast<HeaderTemplate*>(jtemplate->GetNative());
+  IOTJS_ASSERT(tmpl != NULL);
+  return tmpl;
+}
+
+
+void HeaderTemplate::AppendField(int field,
+                                 size_t body_length,
+                                 JObject& jvalues) {
+  if (field == FIELD_LENGTH) {
+    AppendInteger(_fields, body_length);
+    return;
+  }
+  if (field == FIELD_DATE) {
+    _fields.Append(HttpDate());
+    return;
+  }
+
+  JObject jvalue = jvalues.GetElement(field);
+  if (jvalue.IsString()) {
+    char* value = jvalue.GetCString();
+    _fields.Append(value);
+    JObject::ReleaseCString(value);
+  } else if (jvalue.IsNumber()) {
+    AppendInteger(_fields, static_cast<int64_t>(jvalue.GetNumber()));
+  }
+}
+
+
+size_t HeaderTemplate::Fill(size_t body_length,
+                            JObject& jvalues,
+                            uv_buf_t* bufs) {
+  _fields.Truncate(0);
+
+  // Field contents are appended first, the builder may move while growing.
+  for (size_t i = 0; i < _nsegments; ++i) {
+    Segment& segment = _segments[i];
+    if (segment.field != FIELD_LITERAL) {
+      segment.offset = _fields.length();
+      AppendField(segment.field, body_length, jvalues);
+      segment.length = _fields.length() - segment.offset;
+    }
+  }
+
+  for (size_t i = 0; i < _nsegments; ++i) {
+    Segment& segment = _segments[i];
+    StringBuilder& source = segment.field == FIELD_LITERAL ? _text : _fields;
+    bufs[i] = uv_buf_init(source.data() + segment.offset, segment.length);
+  }
+
+  return _nsegments;
+}
+
+
+JObject HeaderTemplate::Render(size_t body_length, JObject& jvalues) {
+  uv_buf_t bufs[kMaxBuffers];
+  size_t nbufs = Fill(body_length, jvalues, bufs);
+
+  size_t length = 0;
+  for (size_t i = 0; i < nbufs; ++i) {
+    length += bufs[i].len;
+  }
+
+  JObject jbuffer = CreateBuffer(length);
+  char* data = Buffer::FromJBuffer(jbuffer)->buffer();
+  for (size_t i = 0; i < nbufs; ++i) {
+    memcpy(data, bufs[i].base, bufs[i].len);
+    data += bufs[i].len;
+  }
+
+  return jbuffer;
+}
+
+// Write a buffer to a stream handle.
+// [0] stream handle
+// [1] buffer
+// [2] callback
+// Returns the same as `write` of the stream handle.
 JHANDLER_FUNCTION(DoWrite, handler) {
   IOTJS_ASSERT(handler.GetArgLength() == 3);
   IOTJS_ASSERT(handler.GetArg(0)->IsObject());
   IOTJS_ASSERT(handler.GetArg(1)->IsObject());
   IOTJS_ASSERT(handler.GetArg(2)->IsFunction());
 
-  // FIXME: Implement me.
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetArg(0));
+
+  JObject* jbuffer = handler.GetArg(1);
+  Buffer* buffer_wrap = Buffer::FromJBuffer(*jbuffer);
+
+  uv_buf_t buf = uv_buf_init(buffer_wrap->buffer(), buffer_wrap->length());
+
+  int ret = stream_wrap->WriteBuffers(&buf, 1, *jbuffer, *handler.GetArg(2));
+
+  handler.Return(JVal::Number(ret));
+
+  return true;
+}
+
+
+// Write a message made of a header template and a body to a stream handle.
+// [0] stream handle
+// [1] template
+// [2] body buffer
+// [3] array of values of numbered fields
+// [4] callback
+// Returns the same as `write` of the stream handle.
+JHANDLER_FUNCTION(WriteTemplate, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 5);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+  IOTJS_ASSERT(handler.GetArg(1)->IsObject());
+  IOTJS_ASSERT(handler.GetArg(2)->IsObject());
+  IOTJS_ASSERT(handler.GetArg(3)->IsObject());
+  IOTJS_ASSERT(handler.GetArg(4)->IsFunction());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetArg(0));
+  HeaderTemplate* tmpl = HeaderTemplate::FromJObject(handler.GetArg(1));
+
+  JObject* jbody = handler.GetArg(2);
+  Buffer* body = Buffer::FromJBuffer(*jbody);
+
+  uv_buf_t bufs[HeaderTemplate::kMaxBuffers + 1];
+  size_t nheader = tmpl->Fill(body->length(), *handler.GetArg(3), bufs);
+  size_t nbufs = nheader;
+  if (body->length() > 0) {
+    bufs[nbufs++] = uv_buf_init(body->buffer(), body->length());
+  }
+
+  uv_buf_t* rest = bufs;
+  int err = stream_wrap->DoTryWrite(&rest, &nbufs);
+  if (err < 0 || nbufs == 0) {
+    handler.Return(JVal::Number(err));
+    return true;
+  }
+
+  // Field contents belong to the template only until its next use, the
+  // unwritten part of the header is copied for the request.
+  size_t written = rest - bufs;
+  size_t header_left = written < nheader ? nheader - written : 0;
+
+  size_t header_length = 0;
+  for (size_t i = 0; i < header_left; ++i) {
+    header_length += rest[i].len;
+  }
+
+  JObject jdata(JObject::Array());
+  jdata.SetElement(0, *jbody);
+
+  if (header_left > 0) {
+    JObject jheader = CreateBuffer(header_length);
+    char* header = Buffer::FromJBuffer(jheader)->buffer();
+    char* data = header;
+    for (size_t i = 0; i < header_left; ++i) {
+      memcpy(data, rest[i].base, rest[i].len);
+      data += rest[i].len;
+    }
+    jdata.SetElement(1, jheader);
+
+    // The copy replaces what is left of the header.
+    rest += header_left - 1;
+    nbufs -= header_left - 1;
+    rest[0] = uv_buf_init(header, header_length);
+  }
+
+  size_t queued = 0;
+  for (size_t i = 0; i < nbufs; ++i) {
+    queued += rest[i].len;
+  }
+
+  err = stream_wrap->DoWrite(rest, nbufs, jdata, *handler.GetArg(4));
+
+  handler.Return(JVal::Number(err < 0 ? err : static_cast<int>(queued)));
+
+  return true;
+}
+
+
+// new Template(text)
+JHANDLER_FUNCTION(Template, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsString());
+
+  JObject* jtemplate = handler.GetThis();
+  char* text = handler.GetArg(0)->GetCString();
+
+  HeaderTemplate* tmpl = new HeaderTemplate(*jtemplate, text, strlen(text));
+  IOTJS_ASSERT(tmpl == HeaderTemplate::FromJObject(jtemplate));
+
+  JObject::ReleaseCString(text);
+
+  if (!tmpl->valid()) {
+    JObject jerror(JObject::RangeError("Too many fields in template"));
+    handler.Throw(jerror);
+    return false;
+  }
+
+  JObject jlength(static_cast<double>(tmpl->literal_length()));
+  jtemplate->SetProperty("length", jlength);
+
+  return true;
+}
+
+
+// Returns a buffer with the header of a message.
+// [0] byte length of the body
+// [1] array of values of numbered fields
+JHANDLER_FUNCTION(Render, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+  IOTJS_ASSERT(handler.GetArg(1)->IsObject());
+
+  HeaderTemplate* tmpl = HeaderTemplate::FromJObject(handler.GetThis());
+  size_t body_length = handler.GetArg(0)->GetInt32();
+
+  JObject jbuffer = tmpl->Render(body_length, *handler.GetArg(1));
+  handler.Return(jbuffer);
 
   return true;
 }
@@ -40,6 +401,13 @@ JObject* InitStream() {
   if (stream == NULL) {
     stream = new JObject();
     stream->SetMethod("doWrite", DoWrite);
+    stream->SetMethod("writeTemplate", WriteTemplate);
+
+    JObject jtemplate(Template);
+    JObject prototype;
+    jtemplate.SetProperty("prototype", prototype);
+    prototype.SetMethod("render", Render);
+    stream->SetProperty("Template", jtemplate);
 
     module->module = stream;
   }
@@ -17,12 +17,60 @@
 #ifndef IOTJS_MODULE_STREAM_H
 #define IOTJS_MODULE_STREAM_H
 
+#include <uv.h>
+
 #include "iotjs_binding.h"
+#include "iotjs_objectwrap.h"
 
 
 namespace iotjs {
 
 
+// Pre-serialized header of a text protocol message. The text is split once
+// into literal segments and fields, `{length}` for the byte length of the body,
+// `{date}` for the current HTTP date and `{0}` to `{9}` for values given with
+// each message. A message is written as the segments, the field contents and
+// the body with a single vectored write, without building a string.
+class HeaderTemplate : public JObjectWrap {
+ public:
+  HeaderTemplate(JObject& jtemplate, const char* text, size_t length);
+
+  static HeaderTemplate* FromJObject(JObject* jtemplate);
+
+  // `false` if the text has more than `IOTJS_TEMPLATE_MAX_FIELDS` fields.
+  bool valid() { return _nsegments > 0; }
+
+  // Number of bytes of the literal segments.
+  size_t literal_length() { return _text.length(); }
+
+  // Sets `bufs` to the header of a message whose body is `body_length` bytes,
+  // taking values of numbered fields from the `jvalues` array. Field contents
+  // are kept by the template only until the next call. Returns the number of
+  // buffers set, at most `kMaxBuffers`.
+  size_t Fill(size_t body_length, JObject& jvalues, uv_buf_t* bufs);
+
+  // Returns a buffer holding the header made by `Fill()`.
+  JObject Render(size_t body_length, JObject& jvalues);
+
+  static const size_t kMaxBuffers = 2 * IOTJS_TEMPLATE_MAX_FIELDS + 1;
+
+ private:
+  struct Segment {
+    int field;
+    size_t offset;
+    size_t length;
+  };
+
+  void AddLiteral(const char* text, size_t length);
+  void AppendField(int field, size_t body_length, JObject& jvalues);
+
+  StringBuilder _text;
+  StringBuilder _fields;
+  Segment _segments[kMaxBuffers];
+  size_t _nsegments;
+};
+
+
 JObject* InitStream();
 
 
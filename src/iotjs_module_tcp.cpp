@@ -17,23 +17,40 @@
 #include "iotjs_def.h"
 #include "iotjs_module_tcp.h"
 
-#include "iotjs_module_buffer.h"
-#include "iotjs_handlewrap.h"
-#include "iotjs_reqwrap.h"
+#include "iotjs_sockaddr.h"
+#include "iotjs_streamwrap.h"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 
 namespace iotjs {
 
 
-class TcpWrap : public HandleWrap {
+// `bind()` flag, lets several processes listen on the same port, the kernel
+// spreads incoming connections over them.
+#define TCP_BIND_REUSEPORT 1
+
+// `bind()` flag, an IPv6 socket does not accept IPv4 connections.
+#define TCP_BIND_IPV6ONLY 2
+
+
+class TcpWrap : public StreamWrap {
  public:
   explicit TcpWrap(Environment* env,
                    JObject& jtcp,
                    JObject& jholder)
-      : HandleWrap(jtcp, jholder, reinterpret_cast<uv_handle_t*>(&_handle)) {
+      : StreamWrap(jtcp, jholder, reinterpret_cast<uv_stream_t*>(&_handle)) {
     uv_tcp_init(env->loop(), &_handle);
   }
 
+  virtual JObject CreateClientHandle() {
+    JObject jtcp = CreateInstance(GetBuiltinModule(MODULE_TCP)->module);
+    new TcpWrap(Environment::GetEnv(), jtcp, JObject::Undefined());
+    return jtcp;
+  }
+
   static TcpWrap* FromJObject(JObject* jtcp) {
     TcpWrap* wrap = reinterpret_cast<TcpWrap*>(jtcp->GetNative());
     IOTJS_ASSERT(wrap != NULL);
@@ -49,51 +66,6 @@ class TcpWrap : public HandleWrap {
 };
 
 
-class ConnectReqWrap : public ReqWrap {
- public:
-  explicit ConnectReqWrap(JObject& jcallback)
-      : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data)) {
-  }
-
-  uv_connect_t* connect_req() {
-    return &_data;
-  }
-
- protected:
-  uv_connect_t _data;
-};
-
-
-class WriteReqWrap : public ReqWrap {
- public:
-  explicit WriteReqWrap(JObject& jcallback)
-      : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data)) {
-  }
-
-  uv_write_t* write_req() {
-    return &_data;
-  }
-
- protected:
-  uv_write_t _data;
-};
-
-
-class ShutdownWrap : public ReqWrap {
- public:
-  explicit ShutdownWrap(JObject& jcallback)
-      : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data)) {
-  }
-
-  uv_shutdown_t* shutdown_req() {
-    return &_data;
-  }
-
- protected:
-   uv_shutdown_t _data;
-};
-
-
 JHANDLER_FUNCTION(TCP, handler) {
   IOTJS_ASSERT(handler.GetThis()->IsObject());
 
@@ -114,58 +86,56 @@ JHANDLER_FUNCTION(Open, handler) {
 }
 
 
-// Socket close result handler.
-static void AfterClose(uv_handle_t* handle) {
-  HandleWrap* tcp_wrap = HandleWrap::FromHandle(handle);
-  IOTJS_ASSERT(tcp_wrap != NULL);
-
-  // socket object.
-  JObject jsocket = tcp_wrap->jholder();
-  IOTJS_ASSERT(jsocket.IsObject());
-
-  // internal close callback.
-  JObject jonclose = jsocket.GetProperty("_onclose");
-  IOTJS_ASSERT(jonclose.IsFunction());
-
-  MakeCallback(jonclose, jsocket, JArgList::Empty());
-}
-
-
-// Close socket
-JHANDLER_FUNCTION(Close, handler) {
-  IOTJS_ASSERT(handler.GetThis()->IsObject());
-
-  JObject* jtcp = handler.GetThis();
-  HandleWrap* wrap = reinterpret_cast<HandleWrap*>(jtcp->GetNative());
+// libuv creates the socket on bind, too late for setting SO_REUSEPORT. Create
+// it here and give it to the handle.
+static int OpenReusePortSocket(uv_tcp_t* handle, int family) {
+#if defined(SO_REUSEPORT)
+  int fd = socket(family, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -errno;
+  }
 
-  // close uv handle, `AfterClose` will be called after socket closed.
-  wrap->Close(AfterClose);
+  int on = 1;
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+    int err = -errno;
+    close(fd);
+    return err;
+  }
 
-  return true;
+  int err = uv_tcp_open(handle, fd);
+  if (err) {
+    close(fd);
+  }
+  return err;
+#else
+  return UV_ENOTSUP;
+#endif
 }
 
 
 // Socket binding, this function would be called from server socket before
 // start listening.
-// [0] address
-// [1] port
+// [0] address object from `TCP.parseAddress()`
+// [1] flags - TCP.REUSEPORT, TCP.IPV6ONLY
+// IPv6 sockets accept IPv4 connections too unless TCP.IPV6ONLY is given.
 JHANDLER_FUNCTION(Bind, handler) {
   IOTJS_ASSERT(handler.GetThis()->IsObject());
   IOTJS_ASSERT(handler.GetArgLength() == 2);
-  IOTJS_ASSERT(handler.GetArg(0)->IsString());
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
   IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
 
-  LocalString address(handler.GetArg(0)->GetCString());
-  int port = handler.GetArg(1)->GetInt32();
+  TcpWrap* wrap = TcpWrap::FromJObject(handler.GetThis());
+  SockAddrWrap* addr = SockAddrWrap::FromJObject(handler.GetArg(0));
+  int flags = handler.GetArg(1)->GetInt32();
 
-  sockaddr_in addr;
-  int err = uv_ip4_addr(address, port, &addr);
+  int err = 0;
+  if (flags & TCP_BIND_REUSEPORT) {
+    err = OpenReusePortSocket(wrap->tcp_handle(), addr->family());
+  }
 
   if (err == 0) {
-    TcpWrap* wrap = TcpWrap::FromJObject(handler.GetThis());
-    err = uv_tcp_bind(wrap->tcp_handle(),
-                      reinterpret_cast<const sockaddr*>(&addr),
-                      0);
+    unsigned int uv_flags = (flags & TCP_BIND_IPV6ONLY) ? UV_TCP_IPV6ONLY : 0;
+    err = uv_tcp_bind(wrap->tcp_handle(), addr->addr(), uv_flags);
   }
 
   handler.Return(JVal::Number(err));
@@ -174,194 +144,31 @@ JHANDLER_FUNCTION(Bind, handler) {
 }
 
 
-// Connection request result handler.
-static void AfterConnect(uv_connect_t* req, int status) {
-  ConnectReqWrap* req_wrap = reinterpret_cast<ConnectReqWrap*>(req->data);
-  TcpWrap* tcp_wrap = reinterpret_cast<TcpWrap*>(req->handle->data);
-  IOTJS_ASSERT(req_wrap != NULL);
-  IOTJS_ASSERT(tcp_wrap != NULL);
-
-  JObject jsocket = tcp_wrap->jholder();
-
-  // Take callback function object.
-  //  function afterConnect(status)
-  JObject jcallback = req_wrap->jcallback();
-  IOTJS_ASSERT(jcallback.IsFunction());
-
-  // Only parameter is status code.
-  JArgList args(1);
-  args.Add(JVal::Number(status));
-
-  // Make callback.
-  MakeCallback(jcallback, jsocket, args);
-
-  // Release request wrapper.
-  delete req_wrap;
-}
-
-
 // Create a connection using the socket.
-// [0] address
-// [1] port
-// [2] callback
+// [0] address object from `TCP.parseAddress()`
+// [1] callback
 JHANDLER_FUNCTION(Connect, handler) {
-  IOTJS_ASSERT(handler.GetThis()->IsObject());
-  IOTJS_ASSERT(handler.GetArgLength() == 3);
-  IOTJS_ASSERT(handler.GetArg(0)->IsString());
-  IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
-  IOTJS_ASSERT(handler.GetArg(2)->IsFunction());
-
-  LocalString address(handler.GetArg(0)->GetCString());
-  int port = handler.GetArg(1)->GetInt32();
-  JObject jcallback = *handler.GetArg(2);
-
-  sockaddr_in addr;
-  int err = uv_ip4_addr(address, port, &addr);
-
-  if (err == 0) {
-    // Get tcp wrapper from javascript socket object.
-    TcpWrap* tcp_wrap = TcpWrap::FromJObject(handler.GetThis());
-
-    // Create connection request wrapper.
-    ConnectReqWrap* req_wrap = new ConnectReqWrap(jcallback);
-
-    // Create connection request.
-    err = uv_tcp_connect(req_wrap->connect_req(),
-                         tcp_wrap->tcp_handle(),
-                         reinterpret_cast<const sockaddr*>(&addr),
-                         AfterConnect);
-
-    req_wrap->Dispatched();
-
-    if (err) {
-      delete req_wrap;
-    }
-  }
-
-  JObject ret(err);
-  handler.Return(ret);
-
-  return true;
-}
-
-
-// A client socket wants to connect to this server.
-// Parameters:
-//   * uv_stream_t* handle - server handle
-//   * int status - status code
-static void OnConnection(uv_stream_t* handle, int status) {
-  // Server tcp wrapper.
-  TcpWrap* tcp_wrap = reinterpret_cast<TcpWrap*>(handle->data);
-  IOTJS_ASSERT(tcp_wrap->tcp_handle() == reinterpret_cast<uv_tcp_t*>(handle));
-
-  // Server object.
-  JObject jserver = tcp_wrap->jholder();
-  IOTJS_ASSERT(jserver.IsObject());
-
-  // `onconnection` callback.
-  JObject jonconnection = jserver.GetProperty("_onconnection");
-  IOTJS_ASSERT(jonconnection.IsFunction());
-
-  // The callback takes two parameter
-  // [0] status
-  // [1] client tcp object
-  JArgList args(2);
-  args.Add(JVal::Number(status));
-
-  if (status == 0) {
-    // Create client socket handle wrapper.
-    JObject jfunc_create_tcp = jserver.GetProperty("_createTCP");
-    IOTJS_ASSERT(jfunc_create_tcp.IsFunction());
-
-    JObject jclient_tcp = jfunc_create_tcp.CallOk(jserver, JArgList::Empty());
-    IOTJS_ASSERT(jclient_tcp.IsObject());
-
-    TcpWrap* tcp_wrap = reinterpret_cast<TcpWrap*>(jclient_tcp.GetNative());
-
-    uv_stream_t* client_handle =
-        reinterpret_cast<uv_stream_t*>(tcp_wrap->tcp_handle());
-
-    int err = uv_accept(handle, client_handle);
-    if (err) {
-      return;
-    }
-
-    args.Add(jclient_tcp);
-  }
-
-  MakeCallback(jonconnection, jserver, args);
-}
-
-
-JHANDLER_FUNCTION(Listen, handler) {
-  IOTJS_ASSERT(handler.GetThis()->IsObject());
-
-  TcpWrap* tcp_wrap = TcpWrap::FromJObject(handler.GetThis());
-
-  int backlog = handler.GetArg(0)->GetInt32();
-
-  int err = uv_listen(reinterpret_cast<uv_stream_t*>(tcp_wrap->tcp_handle()),
-                      backlog,
-                      OnConnection);
-
-  handler.Return(JVal::Number(err));
-
-  return true;
-}
-
-
-void AfterWrite(uv_write_t* req, int status) {
-  WriteReqWrap* req_wrap = reinterpret_cast<WriteReqWrap*>(req->data);
-  TcpWrap* tcp_wrap = reinterpret_cast<TcpWrap*>(req->handle->data);
-  IOTJS_ASSERT(req_wrap != NULL);
-  IOTJS_ASSERT(tcp_wrap != NULL);
-
-  // holder socket.
-  JObject jsocket = tcp_wrap->jholder();
-
-  // Take callback function object.
-  JObject jcallback = req_wrap->jcallback();
-
-  // Only parameter is status code.
-  JArgList args(1);
-  args.Add(JVal::Number(status));
-
-  // Make callback.
-  MakeCallback(jcallback, jsocket, args);
-
-  // Release request wrapper.
-  delete req_wrap;
-}
-
-
-JHANDLER_FUNCTION(Write, handler) {
   IOTJS_ASSERT(handler.GetThis()->IsObject());
   IOTJS_ASSERT(handler.GetArgLength() == 2);
   IOTJS_ASSERT(handler.GetArg(0)->IsObject());
   IOTJS_ASSERT(handler.GetArg(1)->IsFunction());
 
+  // Get tcp wrapper from javascript socket object.
   TcpWrap* tcp_wrap = TcpWrap::FromJObject(handler.GetThis());
-  IOTJS_ASSERT(tcp_wrap != NULL);
-
-  JObject* jbuffer = handler.GetArg(0);
-  Buffer* buffer_wrap = Buffer::FromJBuffer(*jbuffer);
-  char* buffer = buffer_wrap->buffer();
-  int len = buffer_wrap->length();
+  SockAddrWrap* addr = SockAddrWrap::FromJObject(handler.GetArg(0));
+  JObject jcallback = *handler.GetArg(1);
 
-  uv_buf_t buf;
-  buf.base = buffer;
-  buf.len = len;
+  // Create connection request wrapper.
+  ConnectReqWrap* req_wrap = new ConnectReqWrap(jcallback);
 
-  WriteReqWrap* req_wrap = new WriteReqWrap(*handler.GetArg(1));
-
-  int err = uv_write(req_wrap->write_req(),
-                     reinterpret_cast<uv_stream_t*>(tcp_wrap->tcp_handle()),
-                     &buf,
-                     1,
-                     AfterWrite
-                     );
+  // Create connection request.
+  int err = uv_tcp_connect(req_wrap->connect_req(),
+                           tcp_wrap->tcp_handle(),
+                           addr->addr(),
+                           AfterConnect);
 
   req_wrap->Dispatched();
+
   if (err) {
     delete req_wrap;
   }
@@ -372,113 +179,17 @@ JHANDLER_FUNCTION(Write, handler) {
 }
 
 
-void OnAlloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-  if (suggested_size > IOTJS_MAX_READ_BUFFER_SIZE) {
-    suggested_size = IOTJS_MAX_READ_BUFFER_SIZE;
-  }
-
-  buf->base = AllocBuffer(suggested_size);
-  buf->len = suggested_size;
-}
-
-
-void OnRead(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf) {
-  TcpWrap* tcp_wrap = reinterpret_cast<TcpWrap*>(handle->data);
-  IOTJS_ASSERT(tcp_wrap != NULL);
-
-  JObject jsocket = tcp_wrap->jholder();
-  IOTJS_ASSERT(jsocket.IsObject());
-
-  // Socket.prototype._onread = function(nread, isEOF, buffer)
-  JObject jonread = jsocket.GetProperty("_onread");
-  IOTJS_ASSERT(jonread.IsFunction());
-
-  JArgList jargs(3);
-  jargs.Add(JVal::Number((int)nread));
-  jargs.Add(JVal::Bool(false));
-
-  if (nread <= 0) {
-    if (buf->base != NULL) {
-      ReleaseBuffer(buf->base);
-    }
-    if (nread < 0) {
-      if (nread == UV__EOF) {
-        jargs.Set(1, JVal::Bool(true));
-      }
-      MakeCallback(jonread, jsocket, jargs);
-    }
-    return;
-  }
-
-  JObject jbuffer(CreateBuffer(static_cast<size_t>(nread)));
-  Buffer* buffer_wrap = Buffer::FromJBuffer(jbuffer);
-
-  buffer_wrap->Copy(buf->base, nread);
-
-  jargs.Add(jbuffer);
-  MakeCallback(jonread, jsocket, jargs);
-
-  ReleaseBuffer(buf->base);
-}
-
-
-JHANDLER_FUNCTION(ReadStart, handler) {
-  IOTJS_ASSERT(handler.GetThis()->IsObject());
-
-  TcpWrap* tcp_wrap = TcpWrap::FromJObject(handler.GetThis());
-  IOTJS_ASSERT(tcp_wrap != NULL);
-
-  int err = uv_read_start(
-      reinterpret_cast<uv_stream_t*>(tcp_wrap->tcp_handle()),
-      OnAlloc,
-      OnRead);
-
-  handler.Return(JVal::Number(err));
-
-  return true;
-}
-
-
-static void AfterShutdown(uv_shutdown_t* req, int status) {
-  ShutdownWrap* req_wrap = reinterpret_cast<ShutdownWrap*>(req->data);
-  TcpWrap* tcp_wrap = reinterpret_cast<TcpWrap*>(req->handle->data);
-  IOTJS_ASSERT(req_wrap != NULL);
-  IOTJS_ASSERT(tcp_wrap != NULL);
-
-  JObject jsocket = tcp_wrap->jholder();
-  IOTJS_ASSERT(jsocket.IsObject());
-
-  // function onShutdown(status)
-  JObject jonshutdown(req_wrap->jcallback());
-  IOTJS_ASSERT(jonshutdown.IsFunction());
-
-  JArgList args(1);
-  args.Add(JVal::Number(status));
-
-  MakeCallback(jonshutdown, jsocket, args);
-
-  delete req_wrap;
-}
-
-
-JHANDLER_FUNCTION(Shutdown, handler) {
+// Enable or disable Nagle's algorithm.
+// [0] enable - true for sending small packets without delay.
+JHANDLER_FUNCTION(SetNoDelay, handler) {
   IOTJS_ASSERT(handler.GetThis()->IsObject());
   IOTJS_ASSERT(handler.GetArgLength() == 1);
-  IOTJS_ASSERT(handler.GetArg(0)->IsFunction());
-
-  TcpWrap* tcp_wrap = TcpWrap::FromJObject(handler.GetThis());
-  IOTJS_ASSERT(tcp_wrap != NULL);
+  IOTJS_ASSERT(handler.GetArg(0)->IsBoolean());
 
-  ShutdownWrap* req_wrap = new ShutdownWrap(*handler.GetArg(0));
+  TcpWrap* wrap = TcpWrap::FromJObject(handler.GetThis());
 
-  int err = uv_shutdown(req_wrap->shutdown_req(),
-                        reinterpret_cast<uv_stream_t*>(tcp_wrap->tcp_handle()),
-                        AfterShutdown);
-  req_wrap->Dispatched();
-
-  if (err) {
-    delete req_wrap;
-  }
+  int enable = handler.GetArg(0)->GetBoolean() ? 1 : 0;
+  int err = uv_tcp_nodelay(wrap->tcp_handle(), enable);
 
   handler.Return(JVal::Number(err));
 
@@ -486,16 +197,22 @@ JHANDLER_FUNCTION(Shutdown, handler) {
 }
 
 
-JHANDLER_FUNCTION(SetHolder, handler) {
+// Enable or disable TCP keep-alive.
+// [0] enable
+// [1] initial delay in seconds, ignored when disabling.
+JHANDLER_FUNCTION(SetKeepAlive, handler) {
   IOTJS_ASSERT(handler.GetThis()->IsObject());
-  IOTJS_ASSERT(handler.GetArgLength() == 1);
-  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsBoolean());
+  IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
 
-  TcpWrap* tcp_wrap = TcpWrap::FromJObject(handler.GetThis());
+  TcpWrap* wrap = TcpWrap::FromJObject(handler.GetThis());
 
-  JObject* jholder = handler.GetArg(0);
+  int enable = handler.GetArg(0)->GetBoolean() ? 1 : 0;
+  unsigned int delay = handler.GetArg(1)->GetInt32();
+  int err = uv_tcp_keepalive(wrap->tcp_handle(), enable, delay);
 
-  tcp_wrap->set_jholder(*jholder);
+  handler.Return(JVal::Number(err));
 
   return true;
 }
@@ -511,15 +228,16 @@ JObject* InitTcp() {
     JObject prototype;
     tcp->SetProperty("prototype", prototype);
 
+    SetStreamMethods(prototype);
     prototype.SetMethod("open", Open);
-    prototype.SetMethod("close", Close);
     prototype.SetMethod("connect", Connect);
     prototype.SetMethod("bind", Bind);
-    prototype.SetMethod("listen", Listen);
-    prototype.SetMethod("write", Write);
-    prototype.SetMethod("readStart", ReadStart);
-    prototype.SetMethod("shutdown", Shutdown);
-    prototype.SetMethod("_setHolder", SetHolder);
+    prototype.SetMethod("setNoDelay", SetNoDelay);
+    prototype.SetMethod("setKeepAlive", SetKeepAlive);
+
+    tcp->SetProperty("REUSEPORT", JVal::Number(TCP_BIND_REUSEPORT));
+    tcp->SetProperty("IPV6ONLY", JVal::Number(TCP_BIND_IPV6ONLY));
+    SetSockAddrMethods(*tcp);
 
     module->module = tcp;
   }
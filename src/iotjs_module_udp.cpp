@@ -0,0 +1,472 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "iotjs_def.h"
+#include "iotjs_module_udp.h"
+
+#include "iotjs_buffer_pool.h"
+#include "iotjs_module_buffer.h"
+#include "iotjs_handlewrap.h"
+#include "iotjs_reqwrap.h"
+#include "iotjs_sockaddr.h"
+
+
+namespace iotjs {
+
+
+// UDP socket.
+// Datagrams received in a loop iteration are collected into a batch which is
+// delivered to javascript with a single callback from the check phase.
+class UdpWrap : public HandleWrap {
+ public:
+  explicit UdpWrap(Environment* env,
+                   JObject& judp,
+                   JObject& jholder)
+      : HandleWrap(judp, jholder, reinterpret_cast<uv_handle_t*>(&_handle))
+      , _jbatch(NULL)
+      , _batch_count(0) {
+    uv_udp_init(env->loop(), &_handle);
+    uv_check_init(env->loop(), &_check);
+    uv_unref(reinterpret_cast<uv_handle_t*>(&_check));
+    _check.data = this;
+  }
+
+  virtual ~UdpWrap() {
+    ResetBatch();
+  }
+
+  static UdpWrap* FromJObject(JObject* judp) {
+    UdpWrap* wrap = reinterpret_cast<UdpWrap*>(judp->GetNative());
+    IOTJS_ASSERT(wrap != NULL);
+    return wrap;
+  }
+
+  uv_udp_t* udp_handle() {
+    return &_handle;
+  }
+
+  uv_check_t* check_handle() {
+    return &_check;
+  }
+
+  // Appends a datagram to the batch.
+  void Push(JObject& jbuffer, JObject& jrinfo);
+
+  // Delivers the batch.
+  void Flush();
+
+  // Drops the batch.
+  void ResetBatch();
+
+ protected:
+  uv_udp_t _handle;
+  uv_check_t _check;
+
+  // Pairs of Buffer and rinfo object, flattened.
+  JObject* _jbatch;
+  int _batch_count;
+};
+
+
+class SendReqWrap : public ReqWrap {
+ public:
+  explicit SendReqWrap(JObject& jcallback, JObject& jbuffers)
+      : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data))
+      , _jbuffers(jbuffers) {
+  }
+
+  uv_udp_send_t* send_req() {
+    return &_data;
+  }
+
+ protected:
+  uv_udp_send_t _data;
+
+  // Keeps data being sent alive.
+  JObject _jbuffers;
+};
+
+
+static void MakeMessageCallback(UdpWrap* wrap, int status, JObject& jbatch) {
+  JObject jsocket = wrap->jholder();
+  IOTJS_ASSERT(jsocket.IsObject());
+
+  JObject jonmessage = jsocket.GetProperty("_onmessage");
+  IOTJS_ASSERT(jonmessage.IsFunction());
+
+  // Socket.prototype._onmessage = function(status, batch)
+  JArgList args(2);
+  args.Add(JVal::Number(status));
+  args.Add(jbatch);
+
+  MakeCallback(jonmessage, jsocket, args);
+}
+
+
+static void OnCheck(uv_check_t* handle) {
+  UdpWrap* wrap = reinterpret_cast<UdpWrap*>(handle->data);
+  IOTJS_ASSERT(wrap != NULL);
+  wrap->Flush();
+}
+
+
+void UdpWrap::Push(JObject& jbuffer, JObject& jrinfo) {
+  if (_jbatch == NULL) {
+    _jbatch = new JObject(JObject::Array());
+    uv_check_start(&_check, OnCheck);
+  }
+
+  _jbatch->SetElement(_batch_count * 2, jbuffer);
+  _jbatch->SetElement(_batch_count * 2 + 1, jrinfo);
+  _batch_count += 1;
+
+  if (_batch_count >= IOTJS_UDP_MAX_BATCH) {
+    Flush();
+  }
+}
+
+
+void UdpWrap::Flush() {
+  if (_jbatch == NULL) {
+    return;
+  }
+
+  // The callback may receive more datagrams into a new batch.
+  JObject* jbatch = _jbatch;
+  _jbatch = NULL;
+  _batch_count = 0;
+  uv_check_stop(&_check);
+
+  MakeMessageCallback(this, 0, *jbatch);
+
+  delete jbatch;
+}
+
+
+void UdpWrap::ResetBatch() {
+  if (_jbatch != NULL) {
+    delete _jbatch;
+    _jbatch = NULL;
+  }
+  _batch_count = 0;
+}
+
+
+JHANDLER_FUNCTION(UDP, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  Environment* env = Environment::GetEnv();
+  JObject* judp = handler.GetThis();
+  JObject* jholder = handler.GetArg(0);
+
+  UdpWrap* wrap = new UdpWrap(env, *judp, *jholder);
+  IOTJS_ASSERT(wrap->jnative().IsObject());
+  IOTJS_ASSERT(judp->GetNative() != 0);
+
+  return true;
+}
+
+
+// Bind the socket.
+// [0] address
+// [1] port
+// [2] flags
+JHANDLER_FUNCTION(Bind, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 3);
+  IOTJS_ASSERT(handler.GetArg(0)->IsString());
+  IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
+  IOTJS_ASSERT(handler.GetArg(2)->IsNumber());
+
+  LocalString address(handler.GetArg(0)->GetCString());
+  int port = handler.GetArg(1)->GetInt32();
+  unsigned int flags = handler.GetArg(2)->GetInt32();
+
+  sockaddr_storage addr;
+  int err = ParseSockAddr(address, port, &addr);
+
+  if (err == 0) {
+    UdpWrap* wrap = UdpWrap::FromJObject(handler.GetThis());
+    err = uv_udp_bind(wrap->udp_handle(),
+                      reinterpret_cast<const sockaddr*>(&addr),
+                      flags);
+  }
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+static void AfterSend(uv_udp_send_t* req, int status) {
+  SendReqWrap* req_wrap = reinterpret_cast<SendReqWrap*>(req->data);
+  UdpWrap* udp_wrap = reinterpret_cast<UdpWrap*>(req->handle->data);
+  IOTJS_ASSERT(req_wrap != NULL);
+  IOTJS_ASSERT(udp_wrap != NULL);
+
+  JObject jsocket = udp_wrap->jholder();
+
+  // function afterSend(status)
+  JObject jcallback = req_wrap->jcallback();
+  IOTJS_ASSERT(jcallback.IsFunction());
+
+  JArgList args(1);
+  args.Add(JVal::Number(status));
+
+  MakeCallback(jcallback, jsocket, args);
+
+  delete req_wrap;
+}
+
+
+// Send a datagram made of several buffers.
+// [0] array of buffers
+// [1] port
+// [2] address
+// [3] callback
+JHANDLER_FUNCTION(Send, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 4);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+  IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
+  IOTJS_ASSERT(handler.GetArg(2)->IsString());
+  IOTJS_ASSERT(handler.GetArg(3)->IsFunction());
+
+  UdpWrap* udp_wrap = UdpWrap::FromJObject(handler.GetThis());
+
+  JObject* jbuffers = handler.GetArg(0);
+  int port = handler.GetArg(1)->GetInt32();
+  LocalString address(handler.GetArg(2)->GetCString());
+
+  sockaddr_storage addr;
+  int err = ParseSockAddr(address, port, &addr);
+
+  if (err == 0) {
+    // An empty list is sent as one empty buffer, an empty datagram.
+    int length = jbuffers->GetProperty("length").GetInt32();
+    int nbufs = length > 0 ? length : 1;
+
+    // libuv copies the descriptors, the data is kept alive by the request.
+    uv_buf_t* bufs = new uv_buf_t[nbufs];
+    bufs[0] = uv_buf_init(NULL, 0);
+    for (int i = 0; i < length; ++i) {
+      JObject jbuffer = jbuffers->GetElement(i);
+      Buffer* buffer_wrap = Buffer::FromJBuffer(jbuffer);
+      bufs[i] = uv_buf_init(buffer_wrap->buffer(), buffer_wrap->length());
+    }
+
+    SendReqWrap* req_wrap = new SendReqWrap(*handler.GetArg(3), *jbuffers);
+
+    err = uv_udp_send(req_wrap->send_req(),
+                      udp_wrap->udp_handle(),
+                      bufs,
+                      nbufs,
+                      reinterpret_cast<const sockaddr*>(&addr),
+                      AfterSend);
+
+    req_wrap->Dispatched();
+
+    if (err) {
+      delete req_wrap;
+    }
+
+    delete [] bufs;
+  }
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+static void OnRecvAlloc(uv_handle_t* handle,
+                        size_t suggested_size,
+                        uv_buf_t* buf) {
+  if (suggested_size > IOTJS_MAX_READ_BUFFER_SIZE) {
+    suggested_size = IOTJS_MAX_READ_BUFFER_SIZE;
+  }
+
+  // A datagram must fit in a single buffer.
+  GetReadBufferPool()->Alloc(suggested_size, suggested_size, buf);
+}
+
+
+static void OnRecv(uv_udp_t* handle,
+                   ssize_t nread,
+                   const uv_buf_t* buf,
+                   const sockaddr* addr,
+                   unsigned int flags) {
+  UdpWrap* udp_wrap = reinterpret_cast<UdpWrap*>(handle->data);
+  IOTJS_ASSERT(udp_wrap != NULL);
+
+  if (nread < 0) {
+    // Deliver what was received before the error.
+    udp_wrap->Flush();
+    MakeMessageCallback(udp_wrap, nread, JObject::Null());
+    return;
+  }
+
+  if (addr == NULL) {
+    // Nothing more to read.
+    return;
+  }
+
+  JObject jrinfo(CreateAddressObject(addr));
+  jrinfo.SetProperty("size", JVal::Number(static_cast<int>(nread)));
+  if (flags & UV_UDP_PARTIAL) {
+    jrinfo.SetProperty("truncated", JVal::Bool(true));
+  }
+
+  if (nread == 0) {
+    JObject jbuffer(CreateBuffer(0));
+    udp_wrap->Push(jbuffer, jrinfo);
+  } else {
+    BufferPool* pool = GetReadBufferPool();
+    JObject jbuffer(pool->Take(buf, static_cast<size_t>(nread)));
+    udp_wrap->Push(jbuffer, jrinfo);
+  }
+}
+
+
+JHANDLER_FUNCTION(RecvStart, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  UdpWrap* wrap = UdpWrap::FromJObject(handler.GetThis());
+
+  int err = uv_udp_recv_start(wrap->udp_handle(), OnRecvAlloc, OnRecv);
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+// Stop receiving. A batch already collected is still delivered.
+JHANDLER_FUNCTION(RecvStop, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  UdpWrap* wrap = UdpWrap::FromJObject(handler.GetThis());
+
+  int err = uv_udp_recv_stop(wrap->udp_handle());
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+JHANDLER_FUNCTION(SetBroadcast, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsBoolean());
+
+  UdpWrap* wrap = UdpWrap::FromJObject(handler.GetThis());
+
+  int on = handler.GetArg(0)->GetBoolean() ? 1 : 0;
+  int err = uv_udp_set_broadcast(wrap->udp_handle(), on);
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+// Returns address object the socket is bound to, or error code.
+JHANDLER_FUNCTION(GetSockName, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  UdpWrap* wrap = UdpWrap::FromJObject(handler.GetThis());
+
+  sockaddr_storage storage;
+  int len = sizeof(storage);
+  int err = uv_udp_getsockname(wrap->udp_handle(),
+                               reinterpret_cast<sockaddr*>(&storage),
+                               &len);
+
+  if (err) {
+    handler.Return(JVal::Number(err));
+  } else {
+    JObject jaddress(
+        CreateAddressObject(reinterpret_cast<sockaddr*>(&storage)));
+    handler.Return(jaddress);
+  }
+
+  return true;
+}
+
+
+static void AfterClose(uv_handle_t* handle) {
+  HandleWrap* wrap = HandleWrap::FromHandle(handle);
+  IOTJS_ASSERT(wrap != NULL);
+
+  JObject jsocket = wrap->jholder();
+  IOTJS_ASSERT(jsocket.IsObject());
+
+  JObject jonclose = jsocket.GetProperty("_onclose");
+  IOTJS_ASSERT(jonclose.IsFunction());
+
+  MakeCallback(jonclose, jsocket, JArgList::Empty());
+}
+
+
+// Close the socket. Datagrams not delivered yet are dropped.
+JHANDLER_FUNCTION(Close, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  UdpWrap* wrap = UdpWrap::FromJObject(handler.GetThis());
+
+  wrap->ResetBatch();
+
+  uv_handle_t* check = reinterpret_cast<uv_handle_t*>(wrap->check_handle());
+  if (!uv_is_closing(check)) {
+    uv_close(check, NULL);
+  }
+  wrap->Close(AfterClose);
+
+  return true;
+}
+
+
+JObject* InitUdp() {
+  Module* module = GetBuiltinModule(MODULE_UDP);
+  JObject* udp = module->module;
+
+  if (udp == NULL) {
+    udp = new JObject(UDP);
+
+    JObject prototype;
+    udp->SetProperty("prototype", prototype);
+
+    prototype.SetMethod("bind", Bind);
+    prototype.SetMethod("send", Send);
+    prototype.SetMethod("recvStart", RecvStart);
+    prototype.SetMethod("recvStop", RecvStop);
+    prototype.SetMethod("setBroadcast", SetBroadcast);
+    prototype.SetMethod("getsockname", GetSockName);
+    prototype.SetMethod("close", Close);
+
+    udp->SetProperty("REUSEADDR", JVal::Number(UV_UDP_REUSEADDR));
+
+    module->module = udp;
+  }
+
+  return udp;
+}
+
+
+} // namespace iotjs
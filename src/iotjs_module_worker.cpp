@@ -0,0 +1,218 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "iotjs_def.h"
+#include "iotjs_module_worker.h"
+#include "iotjs_module_buffer.h"
+#include "iotjs_module_json.h"
+
+#include <string.h>
+
+
+namespace iotjs {
+
+
+MessageParser::MessageParser(JObject& jparser)
+    : JObjectWrap(jparser)
+    , _header_length(0)
+    , _jpayload(NULL)
+    , _payload_length(0)
+    , _payload_received(0) {
+}
+
+
+MessageParser::~MessageParser() {
+  if (_jpayload != NULL) {
+    delete _jpayload;
+  }
+}
+
+
+MessageParser* MessageParser::FromJObject(JObject* jparser) {
+  MessageParser* parser =
+      reinterpret_cast<MessageParser*>(jparser->GetNative());
+  IOTJS_ASSERT(parser != NULL);
+  return parser;
+}
+
+
+static inline uint8_t* BufferData(JObject& jbuffer) {
+  return reinterpret_cast<uint8_t*>(Buffer::FromJBuffer(jbuffer)->buffer());
+}
+
+
+bool MessageParser::PushMessage(JObject& jmessages) {
+  uint32_t index = jmessages.GetProperty("length").GetInt32();
+
+  if (_header[4] == MESSAGE_BUFFER) {
+    jmessages.SetElement(index, *_jpayload);
+    return true;
+  }
+
+  JResult jres(ParseJson(reinterpret_cast<char*>(BufferData(*_jpayload)),
+                         _payload_length));
+  if (jres.IsException()) {
+    return false;
+  }
+  jmessages.SetElement(index, jres.value());
+  return true;
+}
+
+
+bool MessageParser::Feed(const uint8_t* data,
+                         size_t length,
+                         JObject& jmessages) {
+  const uint8_t* end = data + length;
+
+  while (data < end) {
+    if (_jpayload == NULL) {
+      size_t take = MESSAGE_HEADER_SIZE - _header_length;
+      if (take > static_cast<size_t>(end - data)) {
+        take = end - data;
+      }
+      memcpy(_header + _header_length, data, take);
+      _header_length += take;
+      data += take;
+
+      if (_header_length < MESSAGE_HEADER_SIZE) {
+        break;
+      }
+
+      _payload_length = static_cast<size_t>(_header[0]) |
+                        static_cast<size_t>(_header[1]) << 8 |
+                        static_cast<size_t>(_header[2]) << 16 |
+                        static_cast<size_t>(_header[3]) << 24;
+      if (_header[4] >= MESSAGE_TYPE_COUNT ||
+          _payload_length > IOTJS_WORKER_MAX_MESSAGE) {
+        return false;
+      }
+
+      _jpayload = new JObject(CreateBuffer(_payload_length));
+      _payload_received = 0;
+    }
+
+    size_t take = _payload_length - _payload_received;
+    if (take > static_cast<size_t>(end - data)) {
+      take = end - data;
+    }
+    memcpy(BufferData(*_jpayload) + _payload_received, data, take);
+    _payload_received += take;
+    data += take;
+
+    if (_payload_received == _payload_length) {
+      bool ok = PushMessage(jmessages);
+      delete _jpayload;
+      _jpayload = NULL;
+      _header_length = 0;
+      if (!ok) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+// new MessageParser()
+JHANDLER_FUNCTION(MessageParserConstructor, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  JObject* jparser = handler.GetThis();
+  MessageParser* parser = new MessageParser(*jparser);
+  IOTJS_ASSERT(parser == MessageParser::FromJObject(jparser));
+
+  return true;
+}
+
+
+// Returns an array of the messages completed by a chunk, or an Error if the
+// data is not a message.
+// [0] buffer
+JHANDLER_FUNCTION(Feed, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  MessageParser* parser = MessageParser::FromJObject(handler.GetThis());
+  JObject* jbuffer = handler.GetArg(0);
+  Buffer* buffer = Buffer::FromJBuffer(*jbuffer);
+
+  JObject jmessages(JObject::Array());
+  if (parser->Feed(BufferData(*jbuffer), buffer->length(), jmessages)) {
+    handler.Return(jmessages);
+  } else {
+    JObject jerror(JObject::Error("Invalid message"));
+    handler.Return(jerror);
+  }
+
+  return true;
+}
+
+
+// Returns a buffer of the header of a message, written before the payload.
+// [0] type
+// [1] payload length
+JHANDLER_FUNCTION(Header, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+  IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
+
+  int type = handler.GetArg(0)->GetInt32();
+  double length = handler.GetArg(1)->GetNumber();
+  if (length < 0 || length > IOTJS_WORKER_MAX_MESSAGE) {
+    JHANDLER_THROW_RETURN(handler, RangeError, "Message too large");
+  }
+
+  uint32_t size = static_cast<uint32_t>(length);
+  JObject jheader = CreateBuffer(MESSAGE_HEADER_SIZE);
+  uint8_t* header = BufferData(jheader);
+  header[0] = size & 0xff;
+  header[1] = (size >> 8) & 0xff;
+  header[2] = (size >> 16) & 0xff;
+  header[3] = (size >> 24) & 0xff;
+  header[4] = static_cast<uint8_t>(type);
+
+  handler.Return(jheader);
+
+  return true;
+}
+
+
+JObject* InitWorker() {
+  Module* module = GetBuiltinModule(MODULE_WORKER);
+  JObject* worker = module->module;
+
+  if (worker == NULL) {
+    worker = new JObject();
+    worker->SetMethod("header", Header);
+    worker->SetProperty("JSON", JVal::Number(MESSAGE_JSON));
+    worker->SetProperty("BUFFER", JVal::Number(MESSAGE_BUFFER));
+
+    JObject parser(MessageParserConstructor);
+    JObject prototype;
+    parser.SetProperty("prototype", prototype);
+    prototype.SetMethod("feed", Feed);
+    worker->SetProperty("MessageParser", parser);
+
+    module->module = worker;
+  }
+
+  return worker;
+}
+
+
+} // namespace iotjs
@@ -0,0 +1,69 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef IOTJS_MODULE_WORKER_H
+#define IOTJS_MODULE_WORKER_H
+
+#include "iotjs_binding.h"
+#include "iotjs_objectwrap.h"
+
+
+namespace iotjs {
+
+
+// Messages between a worker and its parent are framed by a header of a
+// little endian 32 bit payload length and a type byte.
+enum MessageType {
+  MESSAGE_JSON,
+  MESSAGE_BUFFER,
+  MESSAGE_TYPE_COUNT
+};
+
+#define MESSAGE_HEADER_SIZE 5
+
+
+// Parser of messages arriving in chunks. The payload of a message is copied
+// once, into the buffer handed out for it.
+class MessageParser : public JObjectWrap {
+ public:
+  explicit MessageParser(JObject& jparser);
+  virtual ~MessageParser();
+
+  static MessageParser* FromJObject(JObject* jparser);
+
+  // Appends the messages completed by `data` to `jmessages`, buffers or the
+  // values of JSON messages. Returns false if the data is not a message.
+  bool Feed(const uint8_t* data, size_t length, JObject& jmessages);
+
+ private:
+  bool PushMessage(JObject& jmessages);
+
+  uint8_t _header[MESSAGE_HEADER_SIZE];
+  size_t _header_length;
+
+  JObject* _jpayload;
+  size_t _payload_length;
+  size_t _payload_received;
+};
+
+
+JObject* InitWorker();
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_MODULE_WORKER_H */
@@ -15,6 +15,8 @@
 
 #include "iotjs_def.h"
 #include "iotjs_reqwrap.h"
+#include "iotjs_exception.h"
+#include "iotjs_module_buffer.h"
 
 
 namespace iotjs {
@@ -52,4 +54,66 @@ void ReqWrap::Dispatched() {
 }
 
 
+WorkReqWrap::WorkReqWrap(JObject& jcallback)
+    : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data)) {
+}
+
+
+WorkReqWrap::~WorkReqWrap() {
+  for (LinkedListItem<JObject*>* item = _pinned.head();
+       item != NULL;
+       item = item->next) {
+    delete item->data;
+  }
+}
+
+
+uint8_t* WorkReqWrap::PinBuffer(JObject& jbuffer) {
+  Pin(jbuffer);
+  return reinterpret_cast<uint8_t*>(Buffer::FromJBuffer(jbuffer)->buffer());
+}
+
+
+void WorkReqWrap::Pin(JObject& jobject) {
+  _pinned.InsertTail(new JObject(jobject));
+}
+
+
+int WorkReqWrap::Queue() {
+  // `OnWork()` finds the request through `data`, which has to be set before
+  // the work could start on another thread.
+  Dispatched();
+
+  Environment* env = Environment::GetEnv();
+  int err = uv_queue_work(env->loop(), &_data, OnWork, AfterWork);
+  if (err) {
+    delete this;
+  }
+  return err;
+}
+
+
+void WorkReqWrap::OnWork(uv_work_t* req) {
+  WorkReqWrap* req_wrap = reinterpret_cast<WorkReqWrap*>(req->data);
+  req_wrap->Run();
+}
+
+
+void WorkReqWrap::AfterWork(uv_work_t* req, int status) {
+  WorkReqWrap* req_wrap = reinterpret_cast<WorkReqWrap*>(req->data);
+
+  JArgList args(2);
+  if (status < 0) {
+    JObject jerror(CreateUVException(status, "work"));
+    args.Add(jerror);
+  } else {
+    req_wrap->Complete(args);
+  }
+
+  MakeCallback(req_wrap->jcallback(), JObject::Null(), args);
+
+  delete req_wrap;
+}
+
+
 } // namespace iotjs
@@ -20,6 +20,7 @@
 #include <uv.h>
 
 #include "iotjs_binding.h"
+#include "iotjs_util.h"
 
 
 namespace iotjs {
@@ -45,6 +46,39 @@ class ReqWrap {
 };
 
 
+// Work done on the libuv threadpool, completed with a call of the callback.
+// Subclasses implement `Run()`, called on a threadpool thread where no
+// javascript value may be touched, and `Complete()`, called back on the loop
+// thread to give the arguments of the callback. Objects given to `Pin()`,
+// like the buffers the work reads and writes, are kept alive until then.
+class WorkReqWrap : public ReqWrap {
+ public:
+  explicit WorkReqWrap(JObject& jcallback);
+  virtual ~WorkReqWrap();
+
+  // Returns the data of a buffer, kept alive while the work is in flight.
+  uint8_t* PinBuffer(JObject& jbuffer);
+  void Pin(JObject& jobject);
+
+  // Queues the work. The request deletes itself once the callback is called,
+  // or right away if the work could not be queued.
+  int Queue();
+
+ protected:
+  virtual void Run() = 0;
+
+  // Adds the arguments of the callback, an error or null first.
+  virtual void Complete(JArgList& args) = 0;
+
+ private:
+  static void OnWork(uv_work_t* req);
+  static void AfterWork(uv_work_t* req, int status);
+
+  uv_work_t _data;
+  LinkedList<JObject*> _pinned;
+};
+
+
 } // namespace iotjs
 
 
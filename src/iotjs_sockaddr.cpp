@@ -0,0 +1,114 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "iotjs_def.h"
+#include "iotjs_sockaddr.h"
+
+#include <string.h>
+
+
+namespace iotjs {
+
+
+SockAddrWrap::SockAddrWrap(JObject& jaddr, const sockaddr_storage& storage)
+    : JObjectWrap(jaddr)
+    , _storage(storage) {
+}
+
+
+SockAddrWrap* SockAddrWrap::FromJObject(JObject* jaddr) {
+  SockAddrWrap* wrap = reinterpret_cast<SockAddrWrap*>(jaddr->GetNative());
+  IOTJS_ASSERT(wrap != NULL);
+  return wrap;
+}
+
+
+int ParseSockAddr(const char* host, int port, sockaddr_storage* storage) {
+  memset(storage, 0, sizeof(*storage));
+
+  // IPv6 addresses have colons, anything else is tried as IPv4.
+  if (strchr(host, ':') != NULL) {
+    return uv_ip6_addr(host,
+                       port,
+                       reinterpret_cast<sockaddr_in6*>(storage));
+  }
+  return uv_ip4_addr(host, port, reinterpret_cast<sockaddr_in*>(storage));
+}
+
+
+JObject CreateAddressObject(const sockaddr* addr) {
+  JObject jaddress;
+  char ip[INET6_ADDRSTRLEN];
+  int port = 0;
+  const char* family = NULL;
+
+  if (addr->sa_family == AF_INET6) {
+    const sockaddr_in6* a6 = reinterpret_cast<const sockaddr_in6*>(addr);
+    uv_ip6_name(a6, ip, sizeof(ip));
+    port = ntohs(a6->sin6_port);
+    family = "IPv6";
+  } else {
+    const sockaddr_in* a4 = reinterpret_cast<const sockaddr_in*>(addr);
+    uv_ip4_name(a4, ip, sizeof(ip));
+    port = ntohs(a4->sin_port);
+    family = "IPv4";
+  }
+
+  JObject jip(ip);
+  JObject jfamily(family);
+  jaddress.SetProperty("address", jip);
+  jaddress.SetProperty("family", jfamily);
+  jaddress.SetProperty("port", JVal::Number(port));
+
+  return jaddress;
+}
+
+
+// Parse a socket address.
+// [0] host - IPv4 or IPv6 address
+// [1] port
+// Returns address object which can be given to `bind` and `connect`, or error
+// code.
+JHANDLER_FUNCTION(ParseAddress, handler) {
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsString());
+  IOTJS_ASSERT(handler.GetArg(1)->IsNumber());
+
+  LocalString host(handler.GetArg(0)->GetCString());
+  int port = handler.GetArg(1)->GetInt32();
+
+  sockaddr_storage storage;
+  int err = ParseSockAddr(host, port, &storage);
+  if (err) {
+    handler.Return(JVal::Number(err));
+    return true;
+  }
+
+  JObject jaddr = CreateAddressObject(
+      reinterpret_cast<const sockaddr*>(&storage));
+  new SockAddrWrap(jaddr, storage);
+
+  handler.Return(jaddr);
+
+  return true;
+}
+
+
+void SetSockAddrMethods(JObject& module) {
+  module.SetMethod("parseAddress", ParseAddress);
+}
+
+
+} // namespace iotjs
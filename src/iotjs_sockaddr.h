@@ -0,0 +1,64 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IOTJS_SOCKADDR_H
+#define IOTJS_SOCKADDR_H
+
+
+#include <uv.h>
+
+#include "iotjs_binding.h"
+#include "iotjs_objectwrap.h"
+
+
+namespace iotjs {
+
+
+// Parsed IPv4 or IPv6 socket address.
+// Javascript keeps these for addresses used over and over, so that connecting
+// or binding again does not parse the address string again.
+class SockAddrWrap : public JObjectWrap {
+ public:
+  SockAddrWrap(JObject& jaddr, const sockaddr_storage& storage);
+
+  static SockAddrWrap* FromJObject(JObject* jaddr);
+
+  const sockaddr* addr() {
+    return reinterpret_cast<const sockaddr*>(&_storage);
+  }
+
+  int family() { return _storage.ss_family; }
+
+ protected:
+  sockaddr_storage _storage;
+};
+
+
+// Parses an IPv4 or IPv6 address string with a port.
+int ParseSockAddr(const char* host, int port, sockaddr_storage* storage);
+
+// Creates an object describing the address, e.g.
+// { address: '127.0.0.1', family: 'IPv4', port: 41234 }
+JObject CreateAddressObject(const sockaddr* addr);
+
+// Sets `parseAddress(host, port)` on `module`. It returns an object holding
+// the parsed address, or an error code.
+void SetSockAddrMethods(JObject& module);
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_SOCKADDR_H */
@@ -0,0 +1,1046 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "iotjs_def.h"
+#include "iotjs_streamwrap.h"
+
+#include "iotjs_buffer_pool.h"
+#include "iotjs_module_buffer.h"
+
+#include <string.h>
+
+
+namespace iotjs {
+
+
+static void AfterAcceptCheckClose(uv_handle_t* handle);
+
+
+StreamWrap::StreamWrap(JObject& jnative,
+                       JObject& jholder,
+                       uv_stream_t* stream)
+    : HandleWrap(jnative, jholder, reinterpret_cast<uv_handle_t*>(stream))
+    , _stream(stream)
+    , _forward_target(NULL)
+    , _forward_source(NULL)
+    , _jforward_callback(NULL)
+    , _forward_paused(false)
+    , _accept_check(NULL)
+    , _jaccepted(NULL)
+    , _accepted_count(0)
+    , _idle_timeout(0)
+    , _last_activity(0)
+    , _idle_notified(false)
+    , _idle_item(NULL)
+    , _jcollect_callback(NULL)
+    , _collect_data(NULL)
+    , _collect_length(0)
+    , _collect_capacity(0)
+    , _collect_max(0) {
+}
+
+
+StreamWrap::~StreamWrap() {
+  Unlink();
+  SetIdleTimeout(0);
+  if (_accept_check != NULL) {
+    // Collected without being closed, the check handle must not call back.
+    uv_close(reinterpret_cast<uv_handle_t*>(_accept_check),
+             AfterAcceptCheckClose);
+  }
+  if (_jaccepted != NULL) {
+    delete _jaccepted;
+  }
+  if (_jcollect_callback != NULL) {
+    delete _jcollect_callback;
+  }
+  if (_collect_data != NULL) {
+    ReleaseBuffer(_collect_data);
+  }
+}
+
+
+StreamWrap* StreamWrap::FromJObject(JObject* jnative) {
+  StreamWrap* wrap = reinterpret_cast<StreamWrap*>(jnative->GetNative());
+  IOTJS_ASSERT(wrap != NULL);
+  return wrap;
+}
+
+
+StreamWrap* StreamWrap::FromStream(uv_stream_t* stream) {
+  StreamWrap* wrap = reinterpret_cast<StreamWrap*>(stream->data);
+  IOTJS_ASSERT(wrap != NULL);
+  IOTJS_ASSERT(wrap->stream_handle() == stream);
+  return wrap;
+}
+
+
+uv_stream_t* StreamWrap::stream_handle() {
+  return _stream;
+}
+
+
+class WriteReqWrap : public ReqWrap {
+ public:
+  explicit WriteReqWrap(JObject& jcallback, JObject& jdata)
+      : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data))
+      , _jdata(jdata) {
+  }
+
+  uv_write_t* write_req() {
+    return &_data;
+  }
+
+ protected:
+  uv_write_t _data;
+
+  // Keeps data being written alive.
+  JObject _jdata;
+};
+
+
+class ShutdownWrap : public ReqWrap {
+ public:
+  explicit ShutdownWrap(JObject& jcallback)
+      : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data)) {
+  }
+
+  uv_shutdown_t* shutdown_req() {
+    return &_data;
+  }
+
+ protected:
+   uv_shutdown_t _data;
+};
+
+
+// Stream close result handler.
+static void AfterClose(uv_handle_t* handle) {
+  HandleWrap* wrap = HandleWrap::FromHandle(handle);
+  IOTJS_ASSERT(wrap != NULL);
+
+  // Handles closed before they were given to a socket have nobody to tell.
+  if (!wrap->has_jholder()) {
+    return;
+  }
+
+  // socket object.
+  JObject jsocket = wrap->jholder();
+  IOTJS_ASSERT(jsocket.IsObject());
+
+  // internal close callback.
+  JObject jonclose = jsocket.GetProperty("_onclose");
+  IOTJS_ASSERT(jonclose.IsFunction());
+
+  MakeCallback(jonclose, jsocket, JArgList::Empty());
+}
+
+
+// Close stream
+JHANDLER_FUNCTION(Close, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  StreamWrap* wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  // No more forwarding from or to a closed stream.
+  wrap->Unlink();
+  wrap->CloseAccept();
+  wrap->SetIdleTimeout(0);
+
+  // close uv handle, `AfterClose` will be called after socket closed.
+  wrap->Close(AfterClose);
+
+  return true;
+}
+
+
+void AfterConnect(uv_connect_t* req, int status) {
+  ConnectReqWrap* req_wrap = reinterpret_cast<ConnectReqWrap*>(req->data);
+  StreamWrap* stream_wrap = StreamWrap::FromStream(req->handle);
+  IOTJS_ASSERT(req_wrap != NULL);
+
+  JObject jsocket = stream_wrap->jholder();
+
+  // Take callback function object.
+  //  function afterConnect(status)
+  JObject jcallback = req_wrap->jcallback();
+  IOTJS_ASSERT(jcallback.IsFunction());
+
+  // Only parameter is status code.
+  JArgList args(1);
+  args.Add(JVal::Number(status));
+
+  // Make callback.
+  MakeCallback(jcallback, jsocket, args);
+
+  // Release request wrapper.
+  delete req_wrap;
+}
+
+
+static void MakeConnectionCallback(JObject& jserver,
+                                   int status,
+                                   JObject& jclient_handle) {
+  // `onconnection` callback.
+  JObject jonconnection = jserver.GetProperty("_onconnection");
+  IOTJS_ASSERT(jonconnection.IsFunction());
+
+  // The callback takes two parameter
+  // [0] status
+  // [1] client stream handle object
+  JArgList args(2);
+  args.Add(JVal::Number(status));
+  args.Add(jclient_handle);
+
+  MakeCallback(jonconnection, jserver, args);
+}
+
+
+// A client wants to connect to this server.
+// Parameters:
+//   * uv_stream_t* handle - server handle
+//   * int status - status code
+static void OnConnection(uv_stream_t* handle, int status) {
+  // Server stream wrapper.
+  StreamWrap* stream_wrap = StreamWrap::FromStream(handle);
+
+  // Server object.
+  JObject jserver = stream_wrap->jholder();
+  IOTJS_ASSERT(jserver.IsObject());
+
+  if (status == 0) {
+    // Create client handle wrapper of the same kind as the server's.
+    JObject jclient_handle = stream_wrap->CreateClientHandle();
+    IOTJS_ASSERT(jclient_handle.IsObject());
+
+    StreamWrap* client_wrap = StreamWrap::FromJObject(&jclient_handle);
+
+    status = uv_accept(handle, client_wrap->stream_handle());
+    if (status == 0) {
+      if (stream_wrap->batch_accept()) {
+        stream_wrap->PushAccepted(jclient_handle);
+      } else {
+        MakeConnectionCallback(jserver, 0, jclient_handle);
+      }
+      return;
+    }
+
+    client_wrap->Close(NULL);
+  }
+
+  // Clients accepted before the error come first.
+  stream_wrap->FlushAccepted();
+  MakeConnectionCallback(jserver, status, JObject::Undefined());
+}
+
+
+// Jerry API does not provide functionality for creating object via specific
+// constructor, `Object.create()` gives the object the handle methods instead.
+JObject StreamWrap::CreateInstance(JObject* jconstructor) {
+  JObject jglobal(JObject::Global());
+  JObject jobject = jglobal.GetProperty("Object");
+  JObject jcreate = jobject.GetProperty("create");
+  IOTJS_ASSERT(jcreate.IsFunction());
+
+  JObject jprototype = jconstructor->GetProperty("prototype");
+
+  JArgList args(1);
+  args.Add(jprototype);
+
+  return jcreate.CallOk(jobject, args);
+}
+
+
+static void OnAcceptCheck(uv_check_t* handle) {
+  StreamWrap* stream_wrap = reinterpret_cast<StreamWrap*>(handle->data);
+  IOTJS_ASSERT(stream_wrap != NULL);
+  stream_wrap->FlushAccepted();
+}
+
+
+static void AfterAcceptCheckClose(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_check_t*>(handle);
+}
+
+
+int StreamWrap::Listen(int backlog, bool batch) {
+  if (batch && _accept_check == NULL) {
+    _accept_check = new uv_check_t;
+    uv_check_init(_stream->loop, _accept_check);
+    uv_unref(reinterpret_cast<uv_handle_t*>(_accept_check));
+    _accept_check->data = this;
+  }
+
+  return uv_listen(_stream, backlog, OnConnection);
+}
+
+
+void StreamWrap::PushAccepted(JObject& jclient) {
+  if (_jaccepted == NULL) {
+    _jaccepted = new JObject(JObject::Array());
+    uv_check_start(_accept_check, OnAcceptCheck);
+  }
+
+  _jaccepted->SetElement(_accepted_count, jclient);
+  _accepted_count += 1;
+}
+
+
+void StreamWrap::FlushAccepted() {
+  if (_jaccepted == NULL) {
+    return;
+  }
+
+  // The callback may accept more clients into a new batch.
+  JObject* jaccepted = _jaccepted;
+  _jaccepted = NULL;
+  _accepted_count = 0;
+  uv_check_stop(_accept_check);
+
+  JObject jserver = jholder();
+  IOTJS_ASSERT(jserver.IsObject());
+
+  // Server.prototype._onconnections = function(clientHandles)
+  JObject jonconnections = jserver.GetProperty("_onconnections");
+  IOTJS_ASSERT(jonconnections.IsFunction());
+
+  JArgList args(1);
+  args.Add(*jaccepted);
+
+  MakeCallback(jonconnections, jserver, args);
+
+  delete jaccepted;
+}
+
+
+void StreamWrap::CloseAccept() {
+  if (_jaccepted != NULL) {
+    for (int i = 0; i < _accepted_count; ++i) {
+      JObject jclient = _jaccepted->GetElement(i);
+      StreamWrap::FromJObject(&jclient)->Close(NULL);
+    }
+    delete _jaccepted;
+    _jaccepted = NULL;
+    _accepted_count = 0;
+  }
+  if (_accept_check != NULL) {
+    uv_close(reinterpret_cast<uv_handle_t*>(_accept_check),
+             AfterAcceptCheckClose);
+    _accept_check = NULL;
+  }
+}
+
+
+// Start listening.
+// [0] backlog
+// [1] batch - optional, deliver accepted clients in batches
+JHANDLER_FUNCTION(Listen, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() >= 1);
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  int backlog = handler.GetArg(0)->GetInt32();
+  bool batch = handler.GetArgLength() > 1 && handler.GetArg(1)->GetBoolean();
+
+  int err = stream_wrap->Listen(backlog, batch);
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+static void AfterWrite(uv_write_t* req, int status) {
+  WriteReqWrap* req_wrap = reinterpret_cast<WriteReqWrap*>(req->data);
+  StreamWrap* stream_wrap = StreamWrap::FromStream(req->handle);
+  IOTJS_ASSERT(req_wrap != NULL);
+
+  // holder socket.
+  JObject jsocket = stream_wrap->jholder();
+
+  // Take callback function object.
+  JObject jcallback = req_wrap->jcallback();
+
+  // Only parameter is status code.
+  JArgList args(1);
+  args.Add(JVal::Number(status));
+
+  // Make callback.
+  MakeCallback(jcallback, jsocket, args);
+
+  // Release request wrapper.
+  delete req_wrap;
+
+  stream_wrap->AfterWriteDone();
+}
+
+
+int StreamWrap::DoWrite(uv_buf_t* bufs,
+                        size_t nbufs,
+                        JObject& jdata,
+                        JObject& jcallback) {
+  WriteReqWrap* req_wrap = new WriteReqWrap(jcallback, jdata);
+
+  int err = uv_write(req_wrap->write_req(),
+                     _stream,
+                     bufs,
+                     nbufs,
+                     AfterWrite);
+
+  req_wrap->Dispatched();
+  if (err) {
+    delete req_wrap;
+  }
+
+  return err;
+}
+
+
+int StreamWrap::DoTryWrite(uv_buf_t** bufs, size_t* nbufs) {
+  uv_buf_t* vbufs = *bufs;
+  size_t count = *nbufs;
+
+  int err = uv_try_write(_stream, vbufs, count);
+  if (err == UV_ENOSYS || err == UV_EAGAIN) {
+    // Nothing written, not an error.
+    return 0;
+  }
+  if (err < 0) {
+    return err;
+  }
+
+  Touch();
+
+  // Skip fully written buffers and adjust the partially written one.
+  size_t written = err;
+  for (; count > 0; ++vbufs, --count) {
+    if (vbufs[0].len > written) {
+      vbufs[0].base += written;
+      vbufs[0].len -= written;
+      break;
+    }
+    written -= vbufs[0].len;
+  }
+
+  *bufs = vbufs;
+  *nbufs = count;
+
+  return 0;
+}
+
+
+int StreamWrap::WriteBuffers(uv_buf_t* bufs,
+                            size_t nbufs,
+                            JObject& jdata,
+                            JObject& jcallback) {
+  // Writing directly avoids a request and a loop iteration for the callback
+  // when the data fits in the socket buffer, which is the common case.
+  int err = DoTryWrite(&bufs, &nbufs);
+  if (err < 0 || nbufs == 0) {
+    return err;
+  }
+
+  size_t queued = 0;
+  for (size_t i = 0; i < nbufs; ++i) {
+    queued += bufs[i].len;
+  }
+
+  err = DoWrite(bufs, nbufs, jdata, jcallback);
+  if (err < 0) {
+    return err;
+  }
+
+  return static_cast<int>(queued);
+}
+
+
+// Write a buffer.
+// [0] buffer
+// [1] callback
+// Returns number of bytes left for the asynchronous write, or error code.
+// The callback is called only if the returned value is greater than zero.
+JHANDLER_FUNCTION(Write, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+  IOTJS_ASSERT(handler.GetArg(1)->IsFunction());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  JObject* jbuffer = handler.GetArg(0);
+  Buffer* buffer_wrap = Buffer::FromJBuffer(*jbuffer);
+
+  uv_buf_t buf = uv_buf_init(buffer_wrap->buffer(), buffer_wrap->length());
+
+  int ret = stream_wrap->WriteBuffers(&buf, 1, *jbuffer, *handler.GetArg(1));
+
+  handler.Return(JVal::Number(ret));
+
+  return true;
+}
+
+
+// Write buffers at once.
+// [0] array of buffers
+// [1] callback
+// Returns the same as `write`.
+JHANDLER_FUNCTION(Writev, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+  IOTJS_ASSERT(handler.GetArg(1)->IsFunction());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  JObject* jbuffers = handler.GetArg(0);
+  int nbufs = jbuffers->GetProperty("length").GetInt32();
+  IOTJS_ASSERT(nbufs > 0);
+
+  // libuv copies the descriptors, the data is kept alive by the request.
+  uv_buf_t* bufs = new uv_buf_t[nbufs];
+  for (int i = 0; i < nbufs; ++i) {
+    JObject jbuffer = jbuffers->GetElement(i);
+    Buffer* buffer_wrap = Buffer::FromJBuffer(jbuffer);
+    bufs[i] = uv_buf_init(buffer_wrap->buffer(), buffer_wrap->length());
+  }
+
+  int ret = stream_wrap->WriteBuffers(bufs,
+                                      nbufs,
+                                      *jbuffers,
+                                      *handler.GetArg(1));
+
+  delete [] bufs;
+
+  handler.Return(JVal::Number(ret));
+
+  return true;
+}
+
+
+void StreamWrap::OnAlloc(size_t suggested_size, uv_buf_t* buf) {
+  if (_jcollect_callback != NULL) {
+    CollectAlloc(suggested_size, buf);
+    return;
+  }
+
+  if (suggested_size > IOTJS_MAX_READ_BUFFER_SIZE) {
+    suggested_size = IOTJS_MAX_READ_BUFFER_SIZE;
+  }
+
+  // A stream can be read in smaller pieces, use the rest of the current slab
+  // unless it became too small.
+  GetReadBufferPool()->Alloc(suggested_size, suggested_size / 4, buf);
+}
+
+
+void StreamWrap::OnRead(ssize_t nread, const uv_buf_t* buf) {
+  if (nread > 0) {
+    Touch();
+  }
+
+  if (_forward_target != NULL && nread > 0) {
+    ForwardRead(buf, static_cast<size_t>(nread));
+    return;
+  }
+
+  if (_jcollect_callback != NULL) {
+    CollectRead(nread);
+    return;
+  }
+
+  JObject jsocket = jholder();
+  IOTJS_ASSERT(jsocket.IsObject());
+
+  // Socket.prototype._onread = function(nread, isEOF, buffer)
+  JObject jonread = jsocket.GetProperty("_onread");
+  IOTJS_ASSERT(jonread.IsFunction());
+
+  JArgList jargs(3);
+  jargs.Add(JVal::Number((int)nread));
+  jargs.Add(JVal::Bool(false));
+
+  if (nread <= 0) {
+    // Unused memory stays in the pool.
+    if (nread < 0) {
+      if (nread == UV__EOF) {
+        jargs.Set(1, JVal::Bool(true));
+      }
+      MakeCallback(jonread, jsocket, jargs);
+    }
+    return;
+  }
+
+  JObject jbuffer(GetReadBufferPool()->Take(buf, static_cast<size_t>(nread)));
+
+  jargs.Add(jbuffer);
+  MakeCallback(jonread, jsocket, jargs);
+}
+
+
+static void OnAlloc(uv_handle_t* handle,
+                    size_t suggested_size,
+                    uv_buf_t* buf) {
+  StreamWrap* stream_wrap = reinterpret_cast<StreamWrap*>(handle->data);
+  IOTJS_ASSERT(stream_wrap != NULL);
+  stream_wrap->OnAlloc(suggested_size, buf);
+}
+
+
+static void OnRead(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf) {
+  StreamWrap::FromStream(handle)->OnRead(nread, buf);
+}
+
+
+int StreamWrap::ReadStart() {
+  return uv_read_start(_stream, iotjs::OnAlloc, iotjs::OnRead);
+}
+
+
+JHANDLER_FUNCTION(ReadStart, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  int err = stream_wrap->ReadStart();
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+int StreamWrap::ReadStop() {
+  return uv_read_stop(_stream);
+}
+
+
+JHANDLER_FUNCTION(ReadStop, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  int err = stream_wrap->ReadStop();
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+int StreamWrap::Forward(StreamWrap* target, JObject& jcallback) {
+  if (target == this ||
+      _forward_target != NULL ||
+      target->_forward_source != NULL) {
+    return UV_EINVAL;
+  }
+
+  _forward_target = target;
+  _jforward_callback = new JObject(jcallback);
+  target->_forward_source = this;
+
+  return 0;
+}
+
+
+void StreamWrap::StopForward() {
+  if (_forward_target == NULL) {
+    return;
+  }
+
+  _forward_target->_forward_source = NULL;
+  _forward_target = NULL;
+
+  delete _jforward_callback;
+  _jforward_callback = NULL;
+
+  if (_forward_paused) {
+    _forward_paused = false;
+    if (!uv_is_closing(reinterpret_cast<uv_handle_t*>(_stream))) {
+      ReadStart();
+    }
+  }
+}
+
+
+// Data is read straight into the memory of the resulting buffer, which grows
+// twice as large when full.
+void StreamWrap::CollectAlloc(size_t suggested_size, uv_buf_t* buf) {
+  if (_collect_capacity - _collect_length < suggested_size) {
+    size_t capacity = _collect_capacity * 2;
+    if (capacity < _collect_length + suggested_size) {
+      capacity = _collect_length + suggested_size;
+    }
+    // One byte more than the limit tells that the output was too long.
+    if (capacity > _collect_max + 1) {
+      capacity = _collect_max + 1;
+    }
+
+    if (capacity > _collect_capacity) {
+      char* data = AllocBuffer(capacity);
+      if (_collect_data != NULL) {
+        memcpy(data, _collect_data, _collect_length);
+        ReleaseBuffer(_collect_data);
+      }
+      _collect_data = data;
+      _collect_capacity = capacity;
+    }
+  }
+
+  *buf = uv_buf_init(_collect_data + _collect_length,
+                     _collect_capacity - _collect_length);
+}
+
+
+void StreamWrap::CollectRead(ssize_t nread) {
+  if (nread > 0) {
+    _collect_length += nread;
+    if (_collect_length > _collect_max) {
+      FinishCollect(UV_ENOBUFS);
+    }
+  } else if (nread == UV__EOF) {
+    FinishCollect(0);
+  } else if (nread < 0) {
+    FinishCollect(nread);
+  }
+}
+
+
+void StreamWrap::FinishCollect(int status) {
+  ReadStop();
+
+  if (_collect_length > _collect_max) {
+    _collect_length = _collect_max;
+  }
+
+  // The buffer takes the memory read into.
+  JObject jbuffer = CreateBuffer(0);
+  if (_collect_length > 0) {
+    Buffer::FromJBuffer(jbuffer)->Own(_collect_data, _collect_length);
+  } else if (_collect_data != NULL) {
+    ReleaseBuffer(_collect_data);
+  }
+  _collect_data = NULL;
+  _collect_length = 0;
+  _collect_capacity = 0;
+
+  JObject* jcallback = _jcollect_callback;
+  _jcollect_callback = NULL;
+
+  JArgList args(2);
+  args.Add(JVal::Number(status));
+  args.Add(jbuffer);
+  MakeCallback(*jcallback, jnative(), args);
+
+  delete jcallback;
+}
+
+
+int StreamWrap::Collect(size_t max_length, JObject& jcallback) {
+  if (_jcollect_callback != NULL || _forward_target != NULL) {
+    return UV_EBUSY;
+  }
+
+  _collect_max = max_length;
+
+  int err = ReadStart();
+  if (err == 0) {
+    _jcollect_callback = new JObject(jcallback);
+  }
+  return err;
+}
+
+
+void StreamWrap::Unlink() {
+  StopForward();
+  if (_forward_source != NULL) {
+    _forward_source->StopForward();
+  }
+}
+
+
+// Stops forwarding and reports `err` with the forwarding callback.
+static void AbortForward(StreamWrap* source, StreamWrap* target,
+                         JObject& jcallback, int err) {
+  JObject jcallback_copy(jcallback);
+  source->StopForward();
+
+  JArgList args(1);
+  args.Add(JVal::Number(err));
+  MakeCallback(jcallback_copy, target->jholder(), args);
+}
+
+
+// Writes `nread` bytes just read into `buf` to the forwarding target.
+void StreamWrap::ForwardRead(const uv_buf_t* buf, size_t nread) {
+  StreamWrap* target = _forward_target;
+
+  uv_buf_t data = uv_buf_init(buf->base, nread);
+  uv_buf_t* bufs = &data;
+  size_t nbufs = 1;
+
+  int err = target->DoTryWrite(&bufs, &nbufs);
+  if (err < 0) {
+    AbortForward(this, target, *_jforward_callback, err);
+    return;
+  }
+  if (nbufs == 0) {
+    // All written, the memory stays in the pool for the next read.
+    return;
+  }
+
+  // The rest is queued, the Buffer object keeps the memory alive meanwhile.
+  JObject jbuffer(GetReadBufferPool()->Take(buf, nread));
+
+  err = target->DoWrite(bufs, nbufs, jbuffer, *_jforward_callback);
+  if (err < 0) {
+    AbortForward(this, target, *_jforward_callback, err);
+    return;
+  }
+
+  // The target can not keep up, stop reading until its queue is empty.
+  _forward_paused = true;
+  ReadStop();
+}
+
+
+void StreamWrap::AfterWriteDone() {
+  Touch();
+
+  StreamWrap* source = _forward_source;
+  if (source != NULL && source->_forward_paused &&
+      _stream->write_queue_size == 0) {
+    source->_forward_paused = false;
+    source->ReadStart();
+  }
+}
+
+
+void StreamWrap::Touch() {
+  if (_idle_item != NULL) {
+    _last_activity = uv_now(_stream->loop);
+    _idle_notified = false;
+  }
+}
+
+
+void StreamWrap::SetIdleTimeout(uint64_t timeout) {
+  if (_idle_item != NULL) {
+    Environment::GetEnv()->UnwatchIdle(_idle_item);
+    _idle_item = NULL;
+  }
+
+  _idle_timeout = timeout;
+  if (timeout > 0) {
+    _idle_item = Environment::GetEnv()->WatchIdle(this, timeout);
+    Touch();
+  }
+}
+
+
+bool StreamWrap::IsIdle(uint64_t now) {
+  return !_idle_notified && now - _last_activity >= _idle_timeout;
+}
+
+
+void StreamWrap::OnIdleTimeout(uint64_t now) {
+  // Closed or changed by an earlier callback of the same sweep.
+  if (_idle_item == NULL || !IsIdle(now)) {
+    return;
+  }
+
+  // Once per idle period.
+  _idle_notified = true;
+
+  JObject jsocket = jholder();
+  IOTJS_ASSERT(jsocket.IsObject());
+
+  JObject jontimeout = jsocket.GetProperty("_ontimeout");
+  IOTJS_ASSERT(jontimeout.IsFunction());
+
+  MakeCallback(jontimeout, jsocket, JArgList::Empty());
+}
+
+
+// Set the idle timeout.
+// [0] timeout in milliseconds, 0 to disable
+JHANDLER_FUNCTION(SetTimeout, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  int timeout = handler.GetArg(0)->GetInt32();
+  stream_wrap->SetIdleTimeout(timeout > 0 ? timeout : 0);
+
+  return true;
+}
+
+
+// Read the whole stream into a single buffer.
+// [0] largest number of bytes kept
+// [1] function(status, buffer) called at the end of the stream
+JHANDLER_FUNCTION(Collect, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(0)->IsNumber());
+  IOTJS_ASSERT(handler.GetArg(1)->IsFunction());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  double max_length = handler.GetArg(0)->GetNumber();
+  if (max_length < 0) {
+    max_length = 0;
+  }
+
+  int err = stream_wrap->Collect(static_cast<size_t>(max_length),
+                                 *handler.GetArg(1));
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+// Whether the stream keeps the event loop alive.
+// [0] false to let the loop end while only this stream is active
+JHANDLER_FUNCTION(SetRef, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+  uv_handle_t* handle =
+      reinterpret_cast<uv_handle_t*>(stream_wrap->stream_handle());
+
+  if (handler.GetArg(0)->GetBoolean()) {
+    uv_ref(handle);
+  } else {
+    uv_unref(handle);
+  }
+
+  return true;
+}
+
+
+// Start or stop forwarding data read from this stream to another stream.
+// [0] target stream handle, or null to stop
+// [1] function(status) called with the status of queued writes to the target
+JHANDLER_FUNCTION(Forward, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  if (handler.GetArgLength() < 1 || !handler.GetArg(0)->IsObject()) {
+    stream_wrap->StopForward();
+    handler.Return(JVal::Number(0));
+    return true;
+  }
+
+  IOTJS_ASSERT(handler.GetArgLength() == 2);
+  IOTJS_ASSERT(handler.GetArg(1)->IsFunction());
+
+  StreamWrap* target = StreamWrap::FromJObject(handler.GetArg(0));
+
+  int err = stream_wrap->Forward(target, *handler.GetArg(1));
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+static void AfterShutdown(uv_shutdown_t* req, int status) {
+  ShutdownWrap* req_wrap = reinterpret_cast<ShutdownWrap*>(req->data);
+  StreamWrap* stream_wrap = StreamWrap::FromStream(req->handle);
+  IOTJS_ASSERT(req_wrap != NULL);
+
+  JObject jsocket = stream_wrap->jholder();
+  IOTJS_ASSERT(jsocket.IsObject());
+
+  // function onShutdown(status)
+  JObject jonshutdown(req_wrap->jcallback());
+  IOTJS_ASSERT(jonshutdown.IsFunction());
+
+  JArgList args(1);
+  args.Add(JVal::Number(status));
+
+  MakeCallback(jonshutdown, jsocket, args);
+
+  delete req_wrap;
+}
+
+
+int StreamWrap::Shutdown(JObject& jcallback) {
+  ShutdownWrap* req_wrap = new ShutdownWrap(jcallback);
+
+  int err = uv_shutdown(req_wrap->shutdown_req(), _stream, AfterShutdown);
+  req_wrap->Dispatched();
+
+  if (err) {
+    delete req_wrap;
+  }
+
+  return err;
+}
+
+
+JHANDLER_FUNCTION(Shutdown, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsFunction());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  int err = stream_wrap->Shutdown(*handler.GetArg(0));
+
+  handler.Return(JVal::Number(err));
+
+  return true;
+}
+
+
+JHANDLER_FUNCTION(SetHolder, handler) {
+  IOTJS_ASSERT(handler.GetThis()->IsObject());
+  IOTJS_ASSERT(handler.GetArgLength() == 1);
+  IOTJS_ASSERT(handler.GetArg(0)->IsObject());
+
+  StreamWrap* stream_wrap = StreamWrap::FromJObject(handler.GetThis());
+
+  JObject* jholder = handler.GetArg(0);
+
+  stream_wrap->set_jholder(*jholder);
+
+  return true;
+}
+
+
+void SetStreamMethods(JObject& prototype) {
+  prototype.SetMethod("close", Close);
+  prototype.SetMethod("listen", Listen);
+  prototype.SetMethod("write", Write);
+  prototype.SetMethod("writev", Writev);
+  prototype.SetMethod("readStart", ReadStart);
+  prototype.SetMethod("readStop", ReadStop);
+  prototype.SetMethod("shutdown", Shutdown);
+  prototype.SetMethod("forward", Forward);
+  prototype.SetMethod("collect", Collect);
+  prototype.SetMethod("setTimeout", SetTimeout);
+  prototype.SetMethod("setRef", SetRef);
+  prototype.SetMethod("_setHolder", SetHolder);
+}
+
+
+} // namespace iotjs
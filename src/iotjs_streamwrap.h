@@ -0,0 +1,189 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IOTJS_STREAMWRAP_H
+#define IOTJS_STREAMWRAP_H
+
+
+#include <uv.h>
+
+#include "iotjs_binding.h"
+#include "iotjs_handlewrap.h"
+#include "iotjs_reqwrap.h"
+
+
+namespace iotjs {
+
+
+// UV stream handle wrapper.
+// Base of TCP and pipe handle wrappers. Owns the read and write paths shared by
+// every kind of stream: reads go into pooled buffers that are handed to
+// javascript without copying, and writes of several buffers are done with a
+// single vectored request.
+class StreamWrap : public HandleWrap {
+ public:
+  StreamWrap(JObject& jnative, /* Native object */
+             JObject& jholder, /* Object hodling the native object */
+             uv_stream_t* stream);
+  virtual ~StreamWrap();
+
+  static StreamWrap* FromJObject(JObject* jnative);
+  static StreamWrap* FromStream(uv_stream_t* stream);
+
+  uv_stream_t* stream_handle();
+
+  // Starts reading. Data is delivered to `_onread` of the holder.
+  int ReadStart();
+
+  // Stops reading, data stays in the kernel until `ReadStart()`.
+  int ReadStop();
+
+  // Writes `nbufs` buffers with a single request. `jdata` holding the buffers
+  // is kept alive until the request completes, then `jcallback` is called
+  // with the status.
+  int DoWrite(uv_buf_t* bufs, size_t nbufs, JObject& jdata, JObject& jcallback);
+
+  // Writes as much as possible without blocking. `*bufs` and `*nbufs` are
+  // advanced past the written data, `*nbufs` becomes 0 if all was written.
+  int DoTryWrite(uv_buf_t** bufs, size_t* nbufs);
+
+  // Writes without blocking as much as possible and the rest with a request,
+  // see `DoWrite()`. Returns the number of bytes left to the request, zero if
+  // all was written and `jcallback` will not be called, or error code.
+  int WriteBuffers(uv_buf_t* bufs,
+                   size_t nbufs,
+                   JObject& jdata,
+                   JObject& jcallback);
+
+  // Shuts down the writing side. `jcallback` is called with the status.
+  int Shutdown(JObject& jcallback);
+
+  // Writes data read from this stream to `target` without calling javascript.
+  // Reading stops while `target` has queued writes. `jcallback` is called with
+  // the status of those writes.
+  int Forward(StreamWrap* target, JObject& jcallback);
+  void StopForward();
+
+  // Reads until the end of the stream into a single buffer without calling
+  // javascript. `jcallback` is called with the status and the buffer, the
+  // status is UV_ENOBUFS if more than `max_length` bytes arrived.
+  int Collect(size_t max_length, JObject& jcallback);
+
+  // Detaches the stream from forwarding in both directions.
+  void Unlink();
+
+  // Called when a write to this stream completed. Records the activity and
+  // resumes the stream forwarding to this one if the write queue became empty.
+  void AfterWriteDone();
+
+  virtual void OnAlloc(size_t suggested_size, uv_buf_t* buf);
+  virtual void OnRead(ssize_t nread, const uv_buf_t* buf);
+
+  // Creates the handle for a client accepted by this server, of the same kind.
+  // The holder is set when javascript creates the socket for it.
+  virtual JObject CreateClientHandle() = 0;
+
+  // Starts listening. In batch mode clients accepted in a loop iteration are
+  // delivered to `_onconnections` of the holder at once from the check phase,
+  // otherwise each to `_onconnection`.
+  int Listen(int backlog, bool batch);
+
+  // Appends an accepted client handle to the batch.
+  void PushAccepted(JObject& jclient);
+
+  // Delivers the batch of accepted clients.
+  void FlushAccepted();
+
+  // Drops the batch and stops batching.
+  void CloseAccept();
+
+  bool batch_accept() { return _accept_check != NULL; }
+
+  // Calls `_ontimeout` of the holder once the stream has neither read nor
+  // written for `timeout` milliseconds, zero disables.
+  void SetIdleTimeout(uint64_t timeout);
+  uint64_t idle_timeout() { return _idle_timeout; }
+
+  bool IsIdle(uint64_t now);
+  void OnIdleTimeout(uint64_t now);
+
+ protected:
+  // Creates an object inheriting the prototype of `jconstructor` without
+  // calling it, the wrap is attached by the caller.
+  static JObject CreateInstance(JObject* jconstructor);
+
+  uv_stream_t* _stream;
+
+ private:
+  void ForwardRead(const uv_buf_t* buf, size_t nread);
+
+  void CollectAlloc(size_t suggested_size, uv_buf_t* buf);
+  void CollectRead(ssize_t nread);
+  void FinishCollect(int status);
+
+  // Records activity for the idle timeout.
+  void Touch();
+
+  StreamWrap* _forward_target;
+  StreamWrap* _forward_source;
+  JObject* _jforward_callback;
+  bool _forward_paused;
+
+  uv_check_t* _accept_check;
+  JObject* _jaccepted;
+  int _accepted_count;
+
+  uint64_t _idle_timeout;
+  uint64_t _last_activity;
+  bool _idle_notified;
+  LinkedListItem<StreamWrap*>* _idle_item;
+
+  JObject* _jcollect_callback;
+  char* _collect_data;
+  size_t _collect_length;
+  size_t _collect_capacity;
+  size_t _collect_max;
+};
+
+
+class ConnectReqWrap : public ReqWrap {
+ public:
+  explicit ConnectReqWrap(JObject& jcallback)
+      : ReqWrap(jcallback, reinterpret_cast<uv_req_t*>(&_data)) {
+  }
+
+  uv_connect_t* connect_req() {
+    return &_data;
+  }
+
+ protected:
+  uv_connect_t _data;
+};
+
+
+// Connection request result handler.
+void AfterConnect(uv_connect_t* req, int status);
+
+
+// Sets methods common to stream handles on the prototype of the handle:
+// close, listen, write, writev, readStart, readStop, shutdown, forward,
+// setTimeout and _setHolder.
+void SetStreamMethods(JObject& prototype);
+
+
+} // namespace iotjs
+
+
+#endif /* IOTJS_STREAMWRAP_H */
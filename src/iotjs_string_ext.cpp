@@ -243,6 +243,52 @@ namespace iotjs {
   MAGICSTR_EX_DEF(MAGICSTREXITEM_AX_P, "ax+") \
   MAGICSTR_EX_DEF(MAGICSTREXITEM_XA_P, "xa+") \
   \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_CONTENT_LENGTH_U, "Content-Length") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_CONTENT_LENGTH, "content-length") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_CONTENT_TYPE_U, "Content-Type") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_CONTENT_TYPE, "content-type") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_TRANSFER_ENCODING_U, \
+                                                          "Transfer-Encoding") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_TRANSFER_ENCODING, "transfer-encoding") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_CONNECTION_U, "Connection") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_CONNECTION, "connection") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_HOST_U, "Host") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_HOST, "host") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_USER_AGENT_U, "User-Agent") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_USER_AGENT, "user-agent") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_ACCEPT_U, "Accept") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_ACCEPT, "accept") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_ACCEPT_ENCODING_U, "Accept-Encoding") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_ACCEPT_ENCODING, "accept-encoding") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_DATE_U, "Date") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_DATE, "date") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_UPGRADE_U, "Upgrade") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_UPGRADE, "upgrade") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_KEEP_ALIVE, "keep-alive") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_CHUNKED, "chunked") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_ANY_TYPE, "*/*") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_TEXT_PLAIN, "text/plain") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_APPLICATION_JSON, "application/json") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_GET_U, "GET") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_HEAD_U, "HEAD") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_POST_U, "POST") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_PUT_U, "PUT") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_DELETE_U, "DELETE") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_OPTIONS_U, "OPTIONS") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_OK_U, "OK") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_METHOD, "method") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_URL, "url") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_HEADERS, "headers") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_STATUSCODE_UL, "statusCode") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_STATUSMESSAGE_UL, "statusMessage") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_VERSIONMAJOR_UL, "versionMajor") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_VERSIONMINOR_UL, "versionMinor") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_SHOULDKEEPALIVE_UL, "shouldKeepAlive") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_UONHEADERS, "_onheaders") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_UONBODY, "_onbody") \
+  MAGICSTR_EX_DEF(MAGICSTREXITEM_HTTP_UONMESSAGECOMPLETE, \
+                                                         "_onmessagecomplete") \
+  \
   MAGICSTR_EX_DEF(MAGICSTREXITEM_BAD_ARGUMENTS_U, "Bad arguments") \
   MAGICSTR_EX_DEF(MAGICSTREXITEM_NO_MODULE_FOUND, "No module found") \
   \
@@ -84,4 +84,63 @@ LocalString::operator char* () const {
 }
 
 
+StringBuilder::StringBuilder()
+    : _data(NULL)
+    , _length(0)
+    , _capacity(0) {
+}
+
+
+StringBuilder::~StringBuilder() {
+  if (_data != NULL) {
+    ReleaseBuffer(_data);
+  }
+}
+
+
+void StringBuilder::Reserve(size_t len) {
+  if (_length + len <= _capacity) {
+    return;
+  }
+  size_t capacity = _capacity > 0 ? _capacity * 2 : 256;
+  while (capacity < _length + len) {
+    capacity *= 2;
+  }
+  _data = ReallocBuffer(_data, capacity);
+  IOTJS_ASSERT(_data != NULL);
+  _capacity = capacity;
+}
+
+
+void StringBuilder::Append(char c) {
+  Reserve(1);
+  _data[_length++] = c;
+}
+
+
+void StringBuilder::Append(const char* str, size_t len) {
+  Reserve(len);
+  memcpy(_data + _length, str, len);
+  _length += len;
+}
+
+
+void StringBuilder::Append(const char* str) {
+  Append(str, strlen(str));
+}
+
+
+void StringBuilder::Truncate(size_t len) {
+  IOTJS_ASSERT(len <= _length);
+  _length = len;
+}
+
+
+const char* StringBuilder::CString() {
+  Reserve(1);
+  _data[_length] = '\0';
+  return _data;
+}
+
+
 } // namespace iotjs
@@ -47,6 +47,34 @@ class LocalString {
 };
 
 
+// Growable byte buffer used for building strings.
+class StringBuilder {
+ public:
+  StringBuilder();
+  ~StringBuilder();
+
+  char* data() { return _data; }
+  size_t length() { return _length; }
+
+  void Append(char c);
+  void Append(const char* str, size_t len);
+  void Append(const char* str);
+
+  // Drops everything after the first `len` bytes.
+  void Truncate(size_t len);
+
+  // Returns the contents as a null terminated string.
+  const char* CString();
+
+ private:
+  void Reserve(size_t len);
+
+  char* _data;
+  size_t _length;
+  size_t _capacity;
+};
+
+
 template<class T>
 struct LinkedListItem {
   LinkedListItem<T>(LinkedListItem* p, LinkedListItem* n, T d)
@@ -157,6 +185,7 @@ public:
       _tail = item->prev;
     }
     _size -= 1;
+    delete item;
   }
 
   void Clear() {
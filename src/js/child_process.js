@@ -0,0 +1,290 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+// Runs programs in child processes. Pipes to the child are stream handles
+// like sockets: output of the child is read into pooled buffers handed to
+// the readable streams without copying, or collected natively into a single
+// buffer by `exec()`.
+
+var EventEmitter = require('events').EventEmitter;
+var constants = require('constants');
+var net = require('net');
+var util = require('util');
+
+var Pipe = process.binding(process.binding.pipe);
+var ProcessWrap = process.binding(process.binding.processwrap);
+
+
+// Default largest output of a command run by `exec()`.
+var DEFAULT_MAX_BUFFER = 1024 * 1024;
+
+
+function ChildProcess() {
+  EventEmitter.call(this);
+
+  this.pid = 0;
+  this.exitCode = null;
+  this.signalCode = null;
+
+  this.stdin = null;
+  this.stdout = null;
+  this.stderr = null;
+  this.stdio = [];
+
+  this._handle = null;
+  this._closesNeeded = 1;
+}
+
+util.inherits(ChildProcess, EventEmitter);
+
+
+// Returns the `stdio` option of the process binding, with new pipe handles in
+// place of 'pipe'. Pipe handles given are passed as they are.
+function stdioOption(stdio) {
+  if (util.isNullOrUndefined(stdio)) {
+    stdio = 'pipe';
+  }
+  if (util.isString(stdio)) {
+    stdio = [stdio, stdio, stdio];
+  }
+
+  var result = [];
+  for (var i = 0; i < stdio.length; ++i) {
+    var entry = stdio[i];
+    if (util.isNullOrUndefined(entry) || entry === 'pipe') {
+      result.push(new Pipe(null));
+    } else if (entry === 'inherit') {
+      result.push(i);
+    } else if (entry === 'ignore' ||
+               util.isNumber(entry) ||
+               entry instanceof Pipe) {
+      result.push(entry);
+    } else {
+      throw new TypeError('Invalid stdio option: ' + entry);
+    }
+  }
+  return result;
+}
+
+
+// Starts the child, returns 0 or an error code.
+//  options.file - program to run, searched in PATH
+//  options.args - arguments including the program name
+//  options.cwd, options.env - working directory and environment
+//  options.stdio - 'pipe', 'inherit', 'ignore' or an array of those or of
+//                  descriptors for each descriptor of the child. Streams are
+//                  made for the pipes.
+ChildProcess.prototype.spawn = function(options) {
+  var self = this;
+  var stdio = stdioOption(options.stdio);
+
+  var envPairs;
+  if (options.env) {
+    envPairs = [];
+    for (var name in options.env) {
+      envPairs.push(name + '=' + options.env[name]);
+    }
+  }
+
+  var handle = new ProcessWrap(this);
+  var err = handle.spawn({
+    file: options.file,
+    args: options.args,
+    cwd: options.cwd,
+    envPairs: envPairs,
+    stdio: stdio
+  });
+  if (err) {
+    handle.close();
+    for (var i = 0; i < stdio.length; ++i) {
+      if (stdio[i] instanceof Pipe) {
+        stdio[i].close();
+      }
+    }
+    return err;
+  }
+
+  this._handle = handle;
+  this.pid = handle.pid;
+
+  var onclose = function() {
+    maybeClose(self);
+  };
+
+  // Pipe handles given by the caller are left to it.
+  var given = util.isArray(options.stdio) ? options.stdio : [];
+  for (var i = 0; i < stdio.length; ++i) {
+    var socket = null;
+    if (stdio[i] instanceof Pipe && !(given[i] instanceof Pipe)) {
+      socket = net._createConnectedSocket(stdio[i]);
+      socket.on('close', onclose);
+      this._closesNeeded++;
+    }
+    this.stdio.push(socket);
+  }
+  this.stdin = this.stdio[0];
+  this.stdout = this.stdio[1];
+  this.stderr = this.stdio[2];
+
+  return 0;
+};
+
+
+ChildProcess.prototype.kill = function(signal) {
+  if (this._handle) {
+    var err = this._handle.kill(util.isNumber(signal) ? signal :
+                                                        constants.SIGTERM);
+    return err == 0;
+  }
+  return false;
+};
+
+
+ChildProcess.prototype._onexit = function(exitCode, signal) {
+  this._handle.close();
+  this._handle = null;
+
+  if (signal) {
+    this.signalCode = signal;
+  } else {
+    this.exitCode = exitCode;
+  }
+
+  // Nobody reads the input of the child anymore.
+  if (this.stdin) {
+    this.stdin.destroy();
+  }
+
+  this.emit('exit', this.exitCode, this.signalCode);
+  maybeClose(this);
+};
+
+
+// 'close' is emitted after 'exit' once all streams of the child are closed.
+function maybeClose(child) {
+  if (--child._closesNeeded == 0) {
+    child.emit('close', child.exitCode, child.signalCode);
+  }
+}
+
+
+// child_process.spawn(file[, args][, options])
+//  options.cwd, options.env - working directory and environment
+//  options.stdio - see `ChildProcess.prototype.spawn()`, 'pipe' by default
+exports.spawn = function(file, args, options) {
+  if (!util.isArray(args)) {
+    options = args;
+    args = [];
+  }
+  options = options || {};
+
+  var child = new ChildProcess();
+  var err = child.spawn({
+    file: file,
+    args: [file].concat(args),
+    cwd: options.cwd,
+    env: options.env,
+    stdio: options.stdio || 'pipe'
+  });
+
+  if (err) {
+    process.nextTick(function() {
+      child.emit('error', new Error('spawn ' + file + ' failed - status: ' +
+                                    err));
+    });
+  }
+
+  return child;
+};
+
+
+// child_process.exec(command[, options], callback)
+// Runs `command` with the shell and calls `callback(err, stdout, stderr)`
+// with its output. Each output of the child is read natively into a single
+// buffer, strings are made of them unless `options.encoding` is 'buffer'.
+//  options.cwd, options.env - working directory and environment
+//  options.maxBuffer - largest output kept, the child is killed beyond it
+exports.exec = function(command, options, callback) {
+  if (util.isFunction(options)) {
+    callback = options;
+    options = {};
+  }
+  options = options || {};
+
+  var maxBuffer = util.isNumber(options.maxBuffer) ? options.maxBuffer :
+                                                     DEFAULT_MAX_BUFFER;
+  var pipes = [new Pipe(null), new Pipe(null)];
+  var output = [null, null];
+  var error = null;
+  var pending = 3;
+
+  var child = new ChildProcess();
+  var err = child.spawn({
+    file: '/bin/sh',
+    args: ['/bin/sh', '-c', command],
+    cwd: options.cwd,
+    env: options.env,
+    stdio: ['ignore', pipes[0], pipes[1]]
+  });
+  if (err) {
+    process.nextTick(function() {
+      callback(new Error('exec failed - status: ' + err), null, null);
+    });
+    return child;
+  }
+
+  function done() {
+    if (--pending > 0) {
+      return;
+    }
+    if (!error && (child.exitCode !== 0 || child.signalCode)) {
+      error = new Error('Command failed: ' + command);
+      error.code = child.exitCode;
+      error.signal = child.signalCode;
+    }
+    if (options.encoding === 'buffer') {
+      callback(error, output[0], output[1]);
+    } else {
+      callback(error, output[0].toString(), output[1].toString());
+    }
+  }
+
+  pipes.forEach(function(pipe, i) {
+    var err = pipe.collect(maxBuffer, function(status, buffer) {
+      output[i] = buffer;
+      pipe.close();
+      if (status && !error) {
+        error = new Error(buffer.length >= maxBuffer ?
+                          'maxBuffer exceeded' : 'read error: ' + status);
+        child.kill();
+      }
+      done();
+    });
+    if (err) {
+      output[i] = new Buffer(0);
+      pipe.close();
+      done();
+    }
+  });
+
+  child.on('exit', done);
+
+  return child;
+};
+
+
+exports.ChildProcess = ChildProcess;
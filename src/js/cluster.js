@@ -0,0 +1,114 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Runs copies of the main script in child processes. Servers of the workers
+// listen on the same port with SO_REUSEPORT, so accepting and handling
+// connections is spread over the cores by the kernel.
+
+var EventEmitter = require('events').EventEmitter;
+var constants = require('constants');
+var net = require('net');
+var util = require('util');
+
+var ProcessWrap = process.binding(process.binding.processwrap);
+
+
+// Environment variable telling a worker its id.
+var WORKER_ID_ENV = 'IOTJS_WORKER_ID';
+
+
+var cluster = new EventEmitter();
+var workerId = process.env[WORKER_ID_ENV];
+var nextWorkerId = 0;
+
+cluster.isWorker = !util.isUndefined(workerId);
+cluster.isMaster = !cluster.isWorker;
+cluster.workers = {};
+
+
+function Worker(id) {
+  EventEmitter.call(this);
+
+  this.id = id;
+  this.pid = 0;
+  this._handle = null;
+}
+
+util.inherits(Worker, EventEmitter);
+
+
+Worker.prototype.kill = function(signal) {
+  if (this._handle) {
+    this._handle.kill(util.isNumber(signal) ? signal : constants.SIGTERM);
+  }
+};
+
+
+Worker.prototype._onexit = function(exitCode, signal) {
+  this._handle.close();
+  this._handle = null;
+
+  delete cluster.workers[this.id];
+
+  this.emit('exit', exitCode, signal);
+  cluster.emit('exit', this, exitCode, signal);
+};
+
+
+// Start a worker running the main script.
+//  env - additional environment variables of the worker.
+cluster.fork = function(env) {
+  if (!cluster.isMaster) {
+    throw new Error('fork() is only available in the master');
+  }
+
+  var worker = new Worker(++nextWorkerId);
+
+  var envPairs = util._envPairs(env);
+  envPairs.push(WORKER_ID_ENV + '=' + worker.id);
+
+  // Workers run the main script with the same arguments.
+  var handle = new ProcessWrap(worker);
+  var err = handle.spawn({
+    file: process.execPath,
+    args: [process.execPath].concat(process.argv.slice(1)),
+    envPairs: envPairs
+  });
+  if (err) {
+    handle.close();
+    throw new Error('fork failed - status: ' + err);
+  }
+
+  worker._handle = handle;
+  worker.pid = handle.pid;
+  cluster.workers[worker.id] = worker;
+
+  process.nextTick(function() {
+    cluster.emit('fork', worker);
+  });
+
+  return worker;
+};
+
+
+if (cluster.isWorker) {
+  cluster.worker = new Worker(Number(workerId));
+  // Servers of the workers share the port, the kernel balances connections.
+  net._reusePort = true;
+}
+
+
+module.exports = cluster;
@@ -0,0 +1,173 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+// Fast LZ compression of buffers. Data is compressed to a frame of
+// independently compressed blocks, all work is done natively on buffer
+// memory and large buffers are processed on the threadpool.
+
+var util = require('util');
+var Transform = require('stream').Transform;
+
+var compressBuiltin = process.binding(process.binding.compress);
+
+
+// Buffers smaller than this are processed right away even when a callback is
+// given, handing them to the threadpool costs more than the work.
+var THREADPOOL_THRESHOLD = 64 * 1024;
+
+
+function toBuffer(data) {
+  if (util.isString(data)) {
+    return new Buffer(data);
+  } else if (!util.isBuffer(data)) {
+    throw new TypeError('data must be a string or a buffer');
+  }
+  return data;
+}
+
+
+function run(fn, data, callback) {
+  var err = null;
+  var result;
+
+  data = toBuffer(data);
+
+  if (!util.isFunction(callback)) {
+    throw new TypeError('callback must be a function');
+  }
+
+  try {
+    if (data.length < THREADPOOL_THRESHOLD) {
+      result = fn(data);
+    } else if (fn(data, callback) == 0) {
+      return;
+    } else {
+      err = new Error('Failed to queue work');
+    }
+  } catch (e) {
+    err = e;
+  }
+
+  process.nextTick(function() {
+    callback(err, result);
+  });
+}
+
+
+// compress.compress(data, callback)
+// Calls `callback(err, frame)` with the compressed frame of `data`.
+exports.compress = function(data, callback) {
+  run(compressBuiltin.compress, data, callback);
+};
+
+
+// compress.decompress(frame, callback)
+// Calls `callback(err, data)` with the data of a compressed frame.
+exports.decompress = function(frame, callback) {
+  run(compressBuiltin.decompress, frame, callback);
+};
+
+
+exports.compressSync = function(data) {
+  return compressBuiltin.compress(toBuffer(data));
+};
+
+
+exports.decompressSync = function(frame) {
+  return compressBuiltin.decompress(toBuffer(frame));
+};
+
+
+function pushAll(stream, chunks) {
+  for (var i = 0; i < chunks.length; ++i) {
+    stream.push(chunks[i]);
+  }
+}
+
+
+// Transform stream compressing what is written to it. A block is pushed each
+// time `BLOCK_SIZE` bytes have been written, the rest at the end.
+function Compress(options) {
+  if (!(this instanceof Compress)) {
+    return new Compress(options);
+  }
+
+  this._handle = new compressBuiltin.Compressor();
+
+  Transform.call(this, options);
+}
+
+util.inherits(Compress, Transform);
+
+
+Compress.prototype._transform = function(chunk, callback) {
+  pushAll(this, this._handle.feed(chunk));
+  callback();
+};
+
+
+Compress.prototype._flush = function(callback) {
+  pushAll(this, this._handle.flush());
+  callback();
+};
+
+
+// Transform stream decompressing a frame written to it in chunks of any
+// size. The data of each block is pushed as soon as it is complete.
+function Decompress(options) {
+  if (!(this instanceof Decompress)) {
+    return new Decompress(options);
+  }
+
+  this._handle = new compressBuiltin.Decompressor();
+
+  Transform.call(this, options);
+}
+
+util.inherits(Decompress, Transform);
+
+
+Decompress.prototype._transform = function(chunk, callback) {
+  var res = this._handle.feed(chunk);
+  if (res instanceof Error) {
+    callback(res);
+  } else {
+    pushAll(this, res);
+    callback();
+  }
+};
+
+
+Decompress.prototype._flush = function(callback) {
+  callback(this._handle.flush());
+};
+
+
+exports.createCompress = function(options) {
+  return new Compress(options);
+};
+
+
+exports.createDecompress = function(options) {
+  return new Decompress(options);
+};
+
+
+exports.BLOCK_SIZE = compressBuiltin.BLOCK_SIZE;
+
+exports.Compress = Compress;
+exports.Decompress = Decompress;
@@ -0,0 +1,158 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+// Message digests computed natively over buffer memory: md5, sha1, sha256
+// and crc32, and HMAC with the first three.
+
+var util = require('util');
+
+var cryptoBuiltin = process.binding(process.binding.crypto);
+
+
+var HASHES = ['crc32', 'md5', 'sha1', 'sha256'];
+
+
+// Buffers smaller than this are hashed right away by `digest()`, handing them
+// to the threadpool costs more than the work.
+var THREADPOOL_THRESHOLD = 64 * 1024;
+
+
+function Hash(algorithm, key) {
+  if (!(this instanceof Hash)) {
+    return new Hash(algorithm, key);
+  }
+
+  if (!util.isString(algorithm)) {
+    throw new TypeError('algorithm must be a string');
+  }
+  this._handle = new cryptoBuiltin.Hash(algorithm, key);
+  this._finalized = false;
+}
+
+
+// hash.update(data)
+// `data` is a buffer or a string, hashed as UTF-8.
+Hash.prototype.update = function(data) {
+  if (this._finalized) {
+    throw new Error('Digest already called');
+  }
+  if (util.isString(data)) {
+    data = new Buffer(data);
+  } else if (!util.isBuffer(data)) {
+    throw new TypeError('data must be a string or a buffer');
+  }
+
+  this._handle.update(data);
+  return this;
+};
+
+
+// hash.digest([encoding])
+// Returns a buffer, or a string if `encoding` is 'hex'.
+Hash.prototype.digest = function(encoding) {
+  if (this._finalized) {
+    throw new Error('Digest already called');
+  }
+  this._finalized = true;
+
+  return this._handle.digest(encoding == 'hex');
+};
+
+
+function Hmac(algorithm, key) {
+  if (!(this instanceof Hmac)) {
+    return new Hmac(algorithm, key);
+  }
+
+  if (util.isString(key)) {
+    key = new Buffer(key);
+  } else if (!util.isBuffer(key)) {
+    throw new TypeError('key must be a string or a buffer');
+  }
+  Hash.call(this, algorithm, key);
+}
+
+util.inherits(Hmac, Hash);
+
+
+exports.createHash = function(algorithm) {
+  return new Hash(algorithm);
+};
+
+
+exports.createHmac = function(algorithm, key) {
+  return new Hmac(algorithm, key);
+};
+
+
+exports.getHashes = function() {
+  return HASHES.slice();
+};
+
+
+// crypto.crc32(data[, previous])
+// Returns CRC32 of `data` as a number. Passing the CRC32 of preceding data
+// continues it.
+exports.crc32 = function(data, previous) {
+  if (util.isString(data)) {
+    data = new Buffer(data);
+  } else if (!util.isBuffer(data)) {
+    throw new TypeError('data must be a string or a buffer');
+  }
+  return cryptoBuiltin.crc32(data, previous || 0);
+};
+
+
+// crypto.digest(algorithm, data[, encoding], callback)
+// Calls `callback(err, digest)` with the digest of `data`, a buffer or a hex
+// string if `encoding` is 'hex'. Large data is hashed on the threadpool.
+exports.digest = function(algorithm, data, encoding, callback) {
+  if (util.isFunction(encoding)) {
+    callback = encoding;
+    encoding = undefined;
+  }
+  if (!util.isFunction(callback)) {
+    throw new TypeError('callback must be a function');
+  }
+  if (util.isString(data)) {
+    data = new Buffer(data);
+  }
+
+  var hex = encoding == 'hex';
+  var err = null;
+  var result;
+
+  try {
+    if (!util.isBuffer(data) || data.length < THREADPOOL_THRESHOLD) {
+      result = new Hash(algorithm).update(data).digest(encoding);
+    } else if (cryptoBuiltin.digest(algorithm, data, hex, callback) == 0) {
+      return;
+    } else {
+      err = new Error('Failed to queue work');
+    }
+  } catch (e) {
+    err = e;
+  }
+
+  process.nextTick(function() {
+    callback(err, result);
+  });
+};
+
+
+exports.Hash = Hash;
+exports.Hmac = Hmac;
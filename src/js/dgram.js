@@ -0,0 +1,247 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+var EventEmitter = require('events').EventEmitter;
+var util = require('util');
+
+var UDP = process.binding(process.binding.udp);
+
+
+var BIND_STATE_UNBOUND = 0;
+var BIND_STATE_BOUND = 1;
+
+
+function Socket(type, listener) {
+  if (!(this instanceof Socket)) {
+    return new Socket(type, listener);
+  }
+
+  EventEmitter.call(this);
+
+  var options = util.isObject(type) ? type : { type: type };
+  if (options.type != 'udp4' && options.type != 'udp6') {
+    throw new Error('Bad socket type specified. Valid types are: udp4, udp6');
+  }
+
+  this.type = options.type;
+  this._reuseAddr = options.reuseAddr === true;
+  this._handle = new UDP(this);
+  this._bindState = BIND_STATE_UNBOUND;
+  this._receiving = false;
+
+  if (util.isFunction(listener)) {
+    this.on('message', listener);
+  }
+}
+
+util.inherits(Socket, EventEmitter);
+
+
+exports.createSocket = function(type, listener) {
+  return new Socket(type, listener);
+};
+
+
+Socket.prototype.bind = function(port, address, callback) {
+  var self = this;
+
+  if (util.isFunction(port)) {
+    callback = port;
+    port = 0;
+    address = undefined;
+  } else if (util.isFunction(address)) {
+    callback = address;
+    address = undefined;
+  }
+
+  if (util.isObject(port)) {
+    address = port.address;
+    port = port.port;
+  }
+
+  checkHandle(self);
+
+  if (self._bindState != BIND_STATE_UNBOUND) {
+    throw new Error('Socket is already bound');
+  }
+
+  if (util.isFunction(callback)) {
+    self.once('listening', callback);
+  }
+
+  var flags = self._reuseAddr ? UDP.REUSEADDR : 0;
+  var anyAddress = self.type == 'udp6' ? '::' : '0.0.0.0';
+  var err = self._handle.bind(address || anyAddress, port || 0, flags);
+  if (err) {
+    process.nextTick(function() {
+      self.emit('error', new Error('bind failed - status: ' + err));
+    });
+    return self;
+  }
+
+  self._bindState = BIND_STATE_BOUND;
+  startReceiving(self);
+
+  process.nextTick(function() {
+    if (self._handle) {
+      self.emit('listening');
+    }
+  });
+
+  return self;
+};
+
+
+// Send a datagram.
+//  socket.send(msg, [offset, length,] port, address[, callback])
+//  `msg` can be a Buffer, a string, or an array of them. Elements of an array
+//  are sent together as a single datagram, an empty array sends an empty one.
+Socket.prototype.send = function(msg, offset, length, port, address,
+                                 callback) {
+  var self = this;
+
+  if (!util.isNumber(port) || !util.isString(address)) {
+    // Called without offset and length.
+    callback = port;
+    address = length;
+    port = offset;
+    offset = undefined;
+    length = undefined;
+  }
+
+  var list;
+  if (util.isArray(msg)) {
+    list = msg.map(toBuffer);
+  } else if (util.isNumber(offset) && util.isNumber(length)) {
+    var buffer = new Buffer(length);
+    toBuffer(msg).copy(buffer, 0, offset, offset + length);
+    list = [buffer];
+  } else {
+    list = [toBuffer(msg)];
+  }
+
+  if (!util.isNumber(port) || port <= 0 || port > 65535) {
+    throw new RangeError('Port should be > 0 and < 65536');
+  }
+  if (!util.isString(address)) {
+    throw new TypeError('invalid argument');
+  }
+
+  checkHandle(self);
+
+  if (self._bindState == BIND_STATE_UNBOUND) {
+    self.bind(0);
+  }
+
+  var err = self._handle.send(list, port, address, function(status) {
+    afterSend(self, status, callback);
+  });
+  if (err) {
+    process.nextTick(function() {
+      afterSend(self, err, callback);
+    });
+  }
+};
+
+
+Socket.prototype.close = function(callback) {
+  if (util.isFunction(callback)) {
+    this.once('close', callback);
+  }
+  checkHandle(this);
+  this._handle.close();
+  this._handle = null;
+  return this;
+};
+
+
+Socket.prototype.address = function() {
+  checkHandle(this);
+  var address = this._handle.getsockname();
+  if (util.isNumber(address)) {
+    throw new Error('getsockname failed - status: ' + address);
+  }
+  return address;
+};
+
+
+Socket.prototype.setBroadcast = function(flag) {
+  checkHandle(this);
+  var err = this._handle.setBroadcast(!!flag);
+  if (err) {
+    throw new Error('setBroadcast failed - status: ' + err);
+  }
+};
+
+
+// Called with datagrams received in a loop iteration.
+//  batch - [buffer0, rinfo0, buffer1, rinfo1, ...]
+Socket.prototype._onmessage = function(status, batch) {
+  if (status < 0) {
+    this.emit('error', new Error('receive error - status: ' + status));
+    return;
+  }
+
+  for (var i = 0; i < batch.length && this._handle; i += 2) {
+    this.emit('message', batch[i], batch[i + 1]);
+  }
+};
+
+
+Socket.prototype._onclose = function() {
+  this.emit('close');
+};
+
+
+function checkHandle(socket) {
+  if (!socket._handle) {
+    throw new Error('Not running');
+  }
+}
+
+
+function startReceiving(socket) {
+  if (!socket._receiving) {
+    var err = socket._handle.recvStart();
+    if (err) {
+      throw new Error('recvStart failed - status: ' + err);
+    }
+    socket._receiving = true;
+  }
+}
+
+
+function afterSend(socket, status, callback) {
+  var err = status ? new Error('send failed - status: ' + status) : null;
+  if (util.isFunction(callback)) {
+    callback(err);
+  } else if (err) {
+    socket.emit('error', err);
+  }
+}
+
+
+function toBuffer(msg) {
+  if (util.isBuffer(msg)) {
+    return msg;
+  } else if (util.isString(msg)) {
+    return new Buffer(msg);
+  }
+  throw new TypeError('First argument must be a buffer or a string');
+}
+
+
+exports.Socket = Socket;
@@ -16,8 +16,10 @@
 
 var fs = exports;
 var constants = require('constants');
+var EventEmitter = require('events').EventEmitter;
 var util = require('util');
 var fsBuiltin = process.binding(process.binding.fs);
+var FsEvent = process.binding(process.binding.fsevent);
 
 
 var O_APPEND = constants.O_APPEND;
@@ -176,6 +178,116 @@ fs.writeSync = function(fd, buffer, offset, length, position) {
 };
 
 
+// Priority classes of asynchronous requests.
+fs.PRIORITY_NORMAL = fsBuiltin.PRIORITY_NORMAL;
+fs.PRIORITY_HIGH = fsBuiltin.PRIORITY_HIGH;
+
+
+// Requests on `fd` will be queued in the lane of `priority`. Requests in the
+// high priority lane are dispatched before any of the normal lane. Closing
+// `fd` puts it back in the normal lane. open() and stat() are not made on a
+// descriptor and are always queued in the normal lane.
+fs.setPriority = function(fd, priority) {
+  fsBuiltin.setPriority(checkArgNumber(fd, 'fd'),
+                        checkArgNumber(priority, 'priority'));
+};
+
+
+// Returns counters of the asynchronous request scheduler.
+//  * queued - number of requests waiting to be dispatched.
+//  * queuedHigh - number of those in the high priority lane.
+//  * inflight - number of requests running on the threadpool.
+//  * dispatched - total number of requests dispatched.
+//  * coalesced - number of writes merged into a preceding one.
+//  * totalWait, maxWait - time requests spent in queue, in milliseconds.
+fs.getSchedulerStats = function() {
+  return fsBuiltin.schedulerStats();
+};
+
+
+// Default window in milliseconds during which file system events are merged
+// into a single 'change' event.
+var WATCH_DEBOUNCE = 50;
+
+
+function FSWatcher() {
+  EventEmitter.call(this);
+
+  this._handle = new FsEvent(this);
+}
+
+util.inherits(FSWatcher, EventEmitter);
+
+
+FSWatcher.prototype.start = function(filename, recursive, debounce) {
+  var err = this._handle.start(filename, recursive, debounce);
+  if (err) {
+    this._handle.close();
+    this._handle = null;
+    throw new Error('watch ' + filename + ' failed - status: ' + err);
+  }
+};
+
+
+FSWatcher.prototype.close = function() {
+  if (this._handle) {
+    this._handle.close();
+    this._handle = null;
+  }
+};
+
+
+// Called with events merged during the debounce window. `filename` is null
+// if the events were on more than one file.
+FSWatcher.prototype._onchange = function(status, events, filename, count) {
+  if (status < 0) {
+    this.close();
+    this.emit('error', new Error('watch error - status: ' + status));
+    return;
+  }
+
+  var eventType = (events & FsEvent.RENAME) ? 'rename' : 'change';
+  this.emit('change', eventType, filename);
+};
+
+
+FSWatcher.prototype._onclose = function() {
+  this.emit('close');
+};
+
+
+// Watch for changes on `filename`, which could be a file or a directory.
+//  options
+//   * recursive - watch subdirectories. default: false.
+//   * debounce - milliseconds to merge a burst of events into one 'change'
+//                event. 0 for reporting every event. default: 50.
+fs.watch = function(filename, options, listener) {
+  checkArgString(filename, 'filename');
+
+  if (util.isFunction(options)) {
+    listener = options;
+    options = {};
+  }
+  options = options || {};
+
+  var recursive = options.recursive === true;
+  var debounce = util.isNumber(options.debounce) ? options.debounce
+                                                 : WATCH_DEBOUNCE;
+
+  var watcher = new FSWatcher();
+  watcher.start(filename, recursive, debounce);
+
+  if (util.isFunction(listener)) {
+    watcher.on('change', listener);
+  }
+
+  return watcher;
+};
+
+
+fs.FSWatcher = FSWatcher;
+
+
 function convertFlags(flag) {
   if (util.isString(flag)) {
     switch (flag) {
@@ -0,0 +1,624 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+// HTTP/1.1 server. Messages are parsed by the native HTTPParser, this module
+// only maps its callbacks to request and response objects.
+
+var EventEmitter = require('events').EventEmitter;
+var net = require('net');
+var stream = require('stream');
+var util = require('util');
+
+var HTTPParser = process.binding(process.binding.httpparser);
+
+
+var STATUS_CODES = {
+  100: 'Continue',
+  101: 'Switching Protocols',
+  200: 'OK',
+  201: 'Created',
+  202: 'Accepted',
+  204: 'No Content',
+  206: 'Partial Content',
+  301: 'Moved Permanently',
+  302: 'Found',
+  304: 'Not Modified',
+  400: 'Bad Request',
+  401: 'Unauthorized',
+  403: 'Forbidden',
+  404: 'Not Found',
+  405: 'Method Not Allowed',
+  408: 'Request Timeout',
+  411: 'Length Required',
+  413: 'Payload Too Large',
+  500: 'Internal Server Error',
+  501: 'Not Implemented',
+  502: 'Bad Gateway',
+  503: 'Service Unavailable',
+  504: 'Gateway Timeout'
+};
+
+
+// Idle time in milliseconds after which server connections are closed.
+var DEFAULT_TIMEOUT = 2 * 60 * 1000;
+
+
+var hasOwnProperty = Object.prototype.hasOwnProperty;
+
+
+// Received message, a readable stream of the body.
+function IncomingMessage(socket) {
+  stream.Readable.call(this);
+
+  this.socket = socket;
+  this.httpVersion = null;
+  this.headers = {};
+  this.rawHeaders = [];
+  this.method = null;
+  this.url = '';
+  this.statusCode = null;
+  this.statusMessage = null;
+  this.complete = false;
+}
+
+util.inherits(IncomingMessage, stream.Readable);
+
+
+// Called when the body buffer has room again.
+IncomingMessage.prototype._read = function() {
+  this.socket.resume();
+};
+
+
+function setIncomingInfo(message, info) {
+  message.httpVersion = info.versionMajor + '.' + info.versionMinor;
+  if (util.isString(info.method)) {
+    message.method = info.method;
+    message.url = info.url;
+  } else {
+    message.statusCode = info.statusCode;
+    message.statusMessage = info.statusMessage;
+  }
+
+  // Header names are lower cased, values of repeated headers joined.
+  var raw = info.headers;
+  message.rawHeaders = raw;
+  for (var i = 0; i < raw.length; i += 2) {
+    var name = raw[i].toLowerCase();
+    if (hasOwnProperty.call(message.headers, name)) {
+      message.headers[name] += ', ' + raw[i + 1];
+    } else {
+      message.headers[name] = raw[i + 1];
+    }
+  }
+}
+
+
+// Response to a request of a server connection.
+function ServerResponse(req, connection, shouldKeepAlive) {
+  EventEmitter.call(this);
+
+  this.socket = req.socket;
+  this.statusCode = 200;
+  this.statusMessage = undefined;
+  this.headersSent = false;
+  this.finished = false;
+  this.shouldKeepAlive = shouldKeepAlive;
+
+  this._connection = connection;
+  this._headers = {};
+  this._hasBody = req.method != 'HEAD';
+  this._http11 = req.httpVersion == '1.1';
+  this._chunked = false;
+
+  // Output held while responses to earlier requests are not finished.
+  this._pending = [];
+}
+
+util.inherits(ServerResponse, EventEmitter);
+
+
+// Throws if the name or a value has a line break, which would let the caller
+// add headers or end the header section (response splitting).
+ServerResponse.prototype.setHeader = function(name, value) {
+  if (this.headersSent) {
+    throw new Error('Can\'t set headers after they are sent');
+  }
+  checkHeaderText(name, 'name');
+  if (util.isArray(value)) {
+    for (var i = 0; i < value.length; ++i) {
+      checkHeaderText(value[i], 'value');
+    }
+  } else {
+    checkHeaderText(value, 'value');
+  }
+  this._headers[name.toLowerCase()] = [name, value];
+};
+
+
+ServerResponse.prototype.getHeader = function(name) {
+  var key = name.toLowerCase();
+  return hasOwnProperty.call(this._headers, key) ?
+         this._headers[key][1] : undefined;
+};
+
+
+ServerResponse.prototype.removeHeader = function(name) {
+  if (this.headersSent) {
+    throw new Error('Can\'t remove headers after they are sent');
+  }
+  delete this._headers[name.toLowerCase()];
+};
+
+
+// response.writeHead(statusCode[, statusMessage][, headers])
+ServerResponse.prototype.writeHead = function(statusCode, reason, headers) {
+  if (this.headersSent) {
+    throw new Error('Can\'t write headers after they are sent');
+  }
+
+  if (util.isObject(reason)) {
+    headers = reason;
+    reason = undefined;
+  }
+
+  this.statusCode = statusCode;
+  if (util.isString(reason)) {
+    this.statusMessage = reason;
+  }
+  if (util.isObject(headers)) {
+    for (var name in headers) {
+      this.setHeader(name, headers[name]);
+    }
+  }
+
+  sendHeader(this);
+};
+
+
+ServerResponse.prototype.write = function(chunk) {
+  if (this.finished) {
+    throw new Error('write after end');
+  }
+  if (!this.headersSent) {
+    sendHeader(this);
+  }
+  if (!this._hasBody || util.isNullOrUndefined(chunk) || chunk.length == 0) {
+    return true;
+  }
+
+  if (this._chunked) {
+    var length = util.isBuffer(chunk) ? chunk.length
+                                      : Buffer.byteLength(chunk);
+    send(this, length.toString(16) + '\r\n');
+    send(this, chunk);
+    return send(this, '\r\n');
+  }
+
+  return send(this, chunk);
+};
+
+
+// Ends the response with `data` as the body, status and headers being those
+// of `template`, see `http.createTemplate()`. Unless headers were set on the
+// response, the header is not built again but written along with the body.
+ServerResponse.prototype.endTemplate = function(template, data) {
+  if (this.finished) {
+    return;
+  }
+  if (this.headersSent) {
+    throw new Error('Can\'t write headers after they are sent');
+  }
+
+  this.statusCode = template.statusCode;
+  this.statusMessage = template.statusMessage;
+
+  if (!this._hasBody || !template.hasBody || hasHeaders(this)) {
+    for (var name in template.headers) {
+      this.setHeader(name, template.headers[name]);
+    }
+    this.end(data);
+    return;
+  }
+
+  this.headersSent = true;
+  send(this, new TemplateMessage(this.shouldKeepAlive ? template.keepAlive
+                                                      : template.close,
+                                 data));
+
+  this.finished = true;
+  this._connection.onResponseFinished();
+  this.emit('finish');
+};
+
+
+ServerResponse.prototype.end = function(data) {
+  if (this.finished) {
+    return;
+  }
+
+  if (!this.headersSent) {
+    // The whole body is known, no need for chunked encoding.
+    if (this._hasBody &&
+        util.isUndefined(this.getHeader('content-length')) &&
+        util.isUndefined(this.getHeader('transfer-encoding'))) {
+      var length = 0;
+      if (util.isBuffer(data)) {
+        length = data.length;
+      } else if (util.isString(data)) {
+        length = Buffer.byteLength(data);
+      }
+      this.setHeader('Content-Length', length);
+    }
+    sendHeader(this);
+  }
+
+  if (!util.isNullOrUndefined(data)) {
+    this.write(data);
+  }
+  if (this._chunked) {
+    send(this, '0\r\n\r\n');
+  }
+
+  this.finished = true;
+  this._connection.onResponseFinished();
+  this.emit('finish');
+};
+
+
+function sendHeader(res) {
+  var code = res.statusCode;
+  var reason = res.statusMessage || STATUS_CODES[code] || 'unknown';
+  var head = 'HTTP/1.1 ' + code + ' ' + reason + '\r\n';
+
+  if (code == 204 || code == 304 || (code >= 100 && code < 200)) {
+    res._hasBody = false;
+  }
+
+  var hasLength = false;
+  var hasEncoding = false;
+  var hasConnection = false;
+
+  for (var key in res._headers) {
+    var value = res._headers[key][1];
+    head += headerLines(res._headers[key][0], value);
+
+    if (key == 'content-length') {
+      hasLength = true;
+    } else if (key == 'transfer-encoding') {
+      hasEncoding = true;
+      res._chunked = String(value).toLowerCase().indexOf('chunked') >= 0;
+    } else if (key == 'connection') {
+      hasConnection = true;
+      if (String(value).toLowerCase().indexOf('close') >= 0) {
+        res.shouldKeepAlive = false;
+      }
+    }
+  }
+
+  if (res._hasBody && !hasLength && !hasEncoding) {
+    if (res._http11) {
+      head += 'Transfer-Encoding: chunked\r\n';
+      res._chunked = true;
+    } else {
+      // The end of the body is told by closing the connection.
+      res.shouldKeepAlive = false;
+    }
+  }
+
+  if (!hasConnection) {
+    head += res.shouldKeepAlive ? 'Connection: keep-alive\r\n'
+                                : 'Connection: close\r\n';
+  }
+
+  res.headersSent = true;
+  send(res, head + '\r\n');
+}
+
+
+function checkHeaderText(text, what) {
+  text = String(text);
+  if (text.indexOf('\r') >= 0 || text.indexOf('\n') >= 0) {
+    throw new TypeError('Invalid character in header ' + what);
+  }
+}
+
+
+function headerLines(name, value) {
+  if (!util.isArray(value)) {
+    return name + ': ' + value + '\r\n';
+  }
+
+  var lines = '';
+  for (var i = 0; i < value.length; ++i) {
+    lines += name + ': ' + value[i] + '\r\n';
+  }
+  return lines;
+}
+
+
+function hasHeaders(res) {
+  for (var key in res._headers) {
+    return true;
+  }
+  return false;
+}
+
+
+function send(res, data) {
+  if (res._connection.responses[0] === res) {
+    return writeData(res.socket, data);
+  }
+  res._pending.push(data);
+  return true;
+}
+
+
+// A body to be written with a header template.
+function TemplateMessage(template, body) {
+  this.template = template;
+  this.body = body;
+}
+
+
+function writeData(socket, data) {
+  if (data instanceof TemplateMessage) {
+    return socket.writeTemplate(data.template, data.body);
+  }
+  return socket.write(data);
+}
+
+
+// Response status and headers serialized once for `res.endTemplate()`.
+// `Date`, `Content-Length` and `Connection` are filled in for each response.
+// Header values must not hold template fields like `{date}`.
+function ResponseTemplate(statusCode, reason, headers) {
+  if (util.isObject(reason)) {
+    headers = reason;
+    reason = undefined;
+  }
+
+  this.statusCode = statusCode;
+  this.statusMessage = reason || STATUS_CODES[statusCode] || 'unknown';
+  this.headers = headers || {};
+  this.hasBody = !(statusCode == 204 || statusCode == 304 ||
+                   (statusCode >= 100 && statusCode < 200));
+
+  var head = 'HTTP/1.1 ' + statusCode + ' ' + this.statusMessage + '\r\n';
+  for (var name in this.headers) {
+    var key = name.toLowerCase();
+    if (key == 'date' || key == 'content-length' ||
+        key == 'transfer-encoding' || key == 'connection') {
+      throw new Error('Header ' + name + ' is set by the template');
+    }
+    head += headerLines(name, this.headers[name]);
+  }
+  head += 'Date: {date}\r\nContent-Length: {length}\r\n';
+
+  this.keepAlive = net.createTemplate(head + 'Connection: keep-alive\r\n\r\n');
+  this.close = net.createTemplate(head + 'Connection: close\r\n\r\n');
+}
+
+
+// Server side state of a connection. Responses are sent in the order of the
+// requests, those to pipelined requests are held until the earlier ones are
+// finished.
+function Connection(server, socket) {
+  this.server = server;
+  this.socket = socket;
+
+  this.parser = new HTTPParser(HTTPParser.REQUEST);
+  this.parser._connection = this;
+  this.parser._onheaders = parserOnHeaders;
+  this.parser._onbody = parserOnBody;
+  this.parser._onmessagecomplete = parserOnMessageComplete;
+
+  // Request whose body is being received.
+  this.incoming = null;
+
+  // Responses not finished yet, in the order of requests.
+  this.responses = [];
+
+  // `true` once the peer ended or a response closes the connection.
+  this.ended = false;
+  this.closing = false;
+}
+
+
+Connection.prototype.onResponseFinished = function() {
+  var responses = this.responses;
+
+  while (responses.length > 0 && responses[0].finished) {
+    var done = responses.shift();
+    if (!done.shouldKeepAlive) {
+      this.close();
+      return;
+    }
+    if (responses.length > 0) {
+      var next = responses[0];
+      for (var i = 0; i < next._pending.length; ++i) {
+        writeData(this.socket, next._pending[i]);
+      }
+      next._pending = [];
+    }
+  }
+
+  if (responses.length == 0 && this.ended) {
+    this.close();
+  }
+};
+
+
+Connection.prototype.close = function() {
+  if (!this.closing) {
+    this.closing = true;
+    this.responses = [];
+    this.socket.end();
+  }
+};
+
+
+function parserOnHeaders(info) {
+  var conn = this._connection;
+
+  var req = new IncomingMessage(conn.socket);
+  setIncomingInfo(req, info);
+  conn.incoming = req;
+
+  if (info.upgrade) {
+    // Protocol upgrades are not supported, the connection is closed.
+    conn.closing = true;
+    return false;
+  }
+
+  var res = new ServerResponse(req, conn, info.shouldKeepAlive);
+  conn.responses.push(res);
+
+  conn.server.emit('request', req, res);
+
+  return false;
+}
+
+
+function parserOnBody(chunk) {
+  var conn = this._connection;
+  if (!conn.incoming.push(chunk)) {
+    // Request is not read, stop reading the connection.
+    conn.socket.pause();
+  }
+}
+
+
+function parserOnMessageComplete() {
+  var conn = this._connection;
+  var req = conn.incoming;
+  conn.incoming = null;
+
+  req.complete = true;
+  req.push(null);
+}
+
+
+function onSocketData(data) {
+  var conn = this._httpConnection;
+  if (conn.closing) {
+    return;
+  }
+
+  var ret = conn.parser.execute(data);
+  if (ret instanceof Error) {
+    conn.closing = true;
+    if (!conn.server.emit('clientError', ret, this)) {
+      this.end('HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n');
+    }
+  } else if (conn.closing) {
+    this.destroy();
+  }
+}
+
+
+function onSocketEnd() {
+  var conn = this._httpConnection;
+  if (!conn.closing) {
+    conn.parser.finish();
+  }
+
+  conn.ended = true;
+  if (conn.responses.length == 0) {
+    conn.close();
+  }
+}
+
+
+function onSocketClose() {
+  var conn = this._httpConnection;
+  if (conn.incoming) {
+    conn.incoming.emit('aborted');
+    conn.incoming = null;
+  }
+  conn.closing = true;
+  conn.responses = [];
+}
+
+
+function onSocketTimeout() {
+  if (!this._httpConnection.server.emit('timeout', this)) {
+    this.destroy();
+  }
+}
+
+
+function connectionListener(socket) {
+  socket._httpConnection = new Connection(this, socket);
+
+  if (this.timeout) {
+    socket.setTimeout(this.timeout, onSocketTimeout);
+  }
+
+  socket.on('data', onSocketData);
+  socket.on('end', onSocketEnd);
+  socket.on('close', onSocketClose);
+  socket.on('error', function() {
+    this.destroy();
+  });
+}
+
+
+function Server(requestListener) {
+  if (!(this instanceof Server)) {
+    return new Server(requestListener);
+  }
+
+  // Responses are still sent after the client ended its side.
+  net.Server.call(this, { allowHalfOpen: true });
+
+  if (util.isFunction(requestListener)) {
+    this.on('request', requestListener);
+  }
+
+  this.timeout = DEFAULT_TIMEOUT;
+  this.on('connection', connectionListener);
+}
+
+util.inherits(Server, net.Server);
+
+
+// Sets the idle timeout of connections accepted afterwards.
+Server.prototype.setTimeout = function(msecs, callback) {
+  this.timeout = msecs;
+  if (util.isFunction(callback)) {
+    this.on('timeout', callback);
+  }
+  return this;
+};
+
+
+exports.createServer = function(requestListener) {
+  return new Server(requestListener);
+};
+
+
+// http.createTemplate(statusCode[, statusMessage][, headers])
+exports.createTemplate = function(statusCode, reason, headers) {
+  return new ResponseTemplate(statusCode, reason, headers);
+};
+
+
+exports.Server = Server;
+exports.IncomingMessage = IncomingMessage;
+exports.ServerResponse = ServerResponse;
+exports.STATUS_CODES = STATUS_CODES;
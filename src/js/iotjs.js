@@ -69,6 +69,7 @@
     initProcessNextTick();
     initProcessUncaughtException();
     initProcessExit();
+    initProcessHrtime();
   }
 
 
@@ -172,6 +173,20 @@
   }
 
 
+  function initProcessHrtime() {
+    // process.hrtime([prev]) returns [seconds, nanoseconds] tuple of current
+    // high resolution time, or elapsed time since `prev` if given.
+    process.hrtime = function(prev) {
+      var now = process._hrtime();
+      if (prev) {
+        now -= prev[0] * 1e9 + prev[1];
+      }
+      var sec = Math.floor(now / 1e9);
+      return [sec, now - sec * 1e9];
+    };
+  }
+
+
   function Native(id) {
     this.id = id;
     this.filename = id + '.js';
@@ -223,10 +238,8 @@
   };
 
 
-  // temp impl. before JSON.parse is done
-  process.JSONParse = function(text) {
-      return process.compile("(" + text + ");");
-  };
+  // Used for package.json before modules can be required.
+  process.JSONParse = process.binding(process.binding.json).parse;
 
   start_iotjs();
 
@@ -0,0 +1,166 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+var EventEmitter = require('events').EventEmitter;
+var util = require('util');
+
+var json = process.binding(process.binding.json);
+
+
+var MAX_GAP_LENGTH = 10;
+
+
+// Parses `text`, a string or a Buffer, into a value.
+exports.parse = function(text, reviver) {
+  var value = json.parse(util.isBuffer(text) ? text : String(text));
+  if (util.isFunction(reviver)) {
+    return revive({ '': value }, '', reviver);
+  }
+  return value;
+};
+
+
+// Serializes `value` to a JSON string, undefined if `value` has no JSON
+// representation.
+exports.stringify = function(value, replacer, space) {
+  var gap = '';
+  if (util.isNumber(space)) {
+    for (var i = 0; i < space && i < MAX_GAP_LENGTH; ++i) {
+      gap += ' ';
+    }
+  } else if (util.isString(space)) {
+    gap = space.substring(0, MAX_GAP_LENGTH);
+  }
+
+  if (util.isFunction(replacer) || util.isArray(replacer)) {
+    value = replace({ '': value }, '', replacer, []);
+  }
+
+  return json.stringify(value, gap);
+};
+
+
+// Parser of newline delimited JSON written in chunks, e.g. from a socket:
+//  socket.pipe(new json.RecordParser()).on('record', ...)
+// Emits 'record' for each parsed line and 'error' for lines that are not
+// valid JSON. Lines longer than `options.maxLength` bytes are dropped with an
+// error.
+function RecordParser(options) {
+  if (!(this instanceof RecordParser)) {
+    return new RecordParser(options);
+  }
+
+  EventEmitter.call(this);
+
+  var maxLength = options && options.maxLength;
+  this._parser = new json.RecordParser(util.isNumber(maxLength) ?
+                                       maxLength : 0);
+}
+
+util.inherits(RecordParser, EventEmitter);
+
+
+RecordParser.prototype.write = function(chunk) {
+  emitRecords(this, this._parser.feed(toBuffer(chunk)));
+  return true;
+};
+
+
+RecordParser.prototype.end = function(chunk) {
+  if (!util.isNullOrUndefined(chunk)) {
+    this.write(chunk);
+  }
+  emitRecords(this, this._parser.flush());
+  this.emit('finish');
+};
+
+
+function emitRecords(parser, records) {
+  for (var i = 0; i < records.length; ++i) {
+    if (records[i] instanceof Error) {
+      parser.emit('error', records[i]);
+    } else {
+      parser.emit('record', records[i]);
+    }
+  }
+}
+
+
+function toBuffer(chunk) {
+  return util.isBuffer(chunk) ? chunk : new Buffer(String(chunk));
+}
+
+
+exports.RecordParser = RecordParser;
+
+
+function revive(holder, key, reviver) {
+  var value = holder[key];
+  if (util.isObject(value)) {
+    var keys = Object.keys(value);
+    for (var i = 0; i < keys.length; ++i) {
+      var revived = revive(value, keys[i], reviver);
+      if (util.isUndefined(revived)) {
+        delete value[keys[i]];
+      } else {
+        value[keys[i]] = revived;
+      }
+    }
+  }
+  return reviver.call(holder, key, value);
+}
+
+
+// Returns a copy of `holder[key]` the replacer is applied to. `stack` holds
+// the objects being copied on the way to it.
+function replace(holder, key, replacer, stack) {
+  var value = holder[key];
+  if (util.isObject(value) && util.isFunction(value.toJSON)) {
+    value = value.toJSON(key);
+  }
+  if (util.isFunction(replacer)) {
+    value = replacer.call(holder, key, value);
+  }
+
+  if (!util.isObject(value)) {
+    return value;
+  }
+
+  if (stack.indexOf(value) >= 0) {
+    throw new TypeError('Converting circular structure to JSON');
+  }
+  stack.push(value);
+
+  var copy;
+  if (util.isArray(value)) {
+    copy = [];
+    for (var i = 0; i < value.length; ++i) {
+      copy.push(replace(value, i, replacer, stack));
+    }
+  } else {
+    copy = {};
+    var keys = util.isArray(replacer) ? replacer : Object.keys(value);
+    for (var i = 0; i < keys.length; ++i) {
+      var k = String(keys[i]);
+      if (Object.prototype.hasOwnProperty.call(value, k)) {
+        copy[k] = replace(value, k, replacer, stack);
+      }
+    }
+  }
+
+  stack.pop();
+  return copy;
+}
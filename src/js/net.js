@@ -19,6 +19,41 @@ var stream = require('stream');
 var util = require('util');
 
 var TCP = process.binding(process.binding.tcp);
+var Pipe = process.binding(process.binding.pipe);
+var streamBuiltin = process.binding(process.binding.stream);
+
+var emptyBuffer = new Buffer(0);
+var emptyValues = [];
+
+
+// Maximum number of parsed addresses kept for reuse.
+var ADDRESS_CACHE_SIZE = 64;
+
+var addressCache = {};
+var addressCacheCount = 0;
+
+
+// Returns parsed address of IPv4 or IPv6 `host` with `port`, or error code.
+// Reconnecting to the same host reuses the address parsed the first time.
+function lookupAddress(host, port) {
+  var key = port + ' ' + host;
+  var address = addressCache[key];
+
+  if (!address) {
+    address = TCP.parseAddress(host, port);
+    if (util.isNumber(address)) {
+      return address;
+    }
+    if (addressCacheCount >= ADDRESS_CACHE_SIZE) {
+      addressCache = {};
+      addressCacheCount = 0;
+    }
+    addressCache[key] = address;
+    addressCacheCount++;
+  }
+
+  return address;
+}
 
 
 function createTCP(socket) {
@@ -27,6 +62,12 @@ function createTCP(socket) {
 }
 
 
+function createPipe(socket) {
+  var pipe = new Pipe(socket);
+  return pipe;
+}
+
+
 function SocketState(options) {
   // 'true' during connection handshaking.
   this.connecting = false;
@@ -38,6 +79,22 @@ function SocketState(options) {
   this.readable = true;
 
   this.allowHalfOpen = options && options.allowHalfOpen || false;
+
+  this.noDelay = false;
+  this.keepAlive = false;
+  this.keepAliveDelay = 0;
+
+  // `true` while writes are held until the end of the current tick.
+  this.tickCorked = false;
+
+  // `true` while reading is stopped because the readable buffer is full.
+  this.readStopped = false;
+
+  // Idle timeout in milliseconds, 0 if disabled.
+  this.timeout = 0;
+
+  // Called when a 'data' listener is added while piped to a socket.
+  this.onDataListener = null;
 }
 
 
@@ -68,16 +125,31 @@ function Socket(options) {
 util.inherits(Socket, stream.Duplex);
 
 
+// socket.connect(port[, host][, callback])
+// socket.connect(path[, callback])
+// socket.connect(options[, callback])
 Socket.prototype.connect = function(port, host, callback) {
   var self = this;
   var state = self._socketState;
 
+  if (util.isObject(port)) {
+    callback = host;
+    host = port.host;
+    port = port.path || port.port;
+  }
+
+  var path = util.isString(port) ? port : null;
+  if (path || util.isFunction(host)) {
+    callback = host;
+    host = undefined;
+  }
+
   if (state.connecting || state.connected) {
     return self;
   }
 
   if (!self._handle) {
-    self._handle = createTCP(this);
+    self._handle = path ? createPipe(this) : createTCP(this);
   }
 
   if (util.isFunction(callback)) {
@@ -86,7 +158,20 @@ Socket.prototype.connect = function(port, host, callback) {
 
   state.connecting = true;
 
-  self._handle.connect(host, port, afterConnect);
+  var err;
+  if (path) {
+    err = self._handle.connect(path, afterConnect);
+  } else {
+    var address = lookupAddress(host || '127.0.0.1', port);
+    err = util.isNumber(address) ? address :
+          self._handle.connect(address, afterConnect);
+  }
+
+  if (err) {
+    process.nextTick(function() {
+      afterConnect.call(self, err);
+    });
+  }
 
   return self;
 };
@@ -96,22 +181,185 @@ Socket.prototype.write = function(data, callback) {
   if (!util.isString(data) && !util.isBuffer(data)) {
     throw new TypeError('invalid argument');
   }
-  stream.Duplex.prototype.write.call(this, data, callback);
+  if (!this._socketState.noDelay) {
+    corkUntilNextTick(this);
+  }
+  return stream.Duplex.prototype.write.call(this, data, callback);
 };
 
 
+// A message made of a header template and a body, queued like a buffer.
+// `length` only counts the literal part of the header for the high water mark.
+function TemplateChunk(template, body, values) {
+  this.template = template;
+  this.body = body;
+  this.values = values;
+  this.length = template.length + body.length;
+}
+
+
+TemplateChunk.prototype.render = function() {
+  return this.template.render(this.body.length, this.values);
+};
+
+
+// socket.writeTemplate(template, body[, values][, callback])
+// Writes a message whose header is made from `template` with its fields
+// filled in, see `net.createTemplate()`. `body` is a buffer or a string.
+Socket.prototype.writeTemplate = function(template, body, values, callback) {
+  if (util.isFunction(values)) {
+    callback = values;
+    values = undefined;
+  }
+  if (util.isString(body)) {
+    body = new Buffer(body);
+  } else if (util.isNullOrUndefined(body)) {
+    body = emptyBuffer;
+  } else if (!util.isBuffer(body)) {
+    throw new TypeError('invalid argument');
+  }
+  if (!this._socketState.noDelay) {
+    corkUntilNextTick(this);
+  }
+
+  var chunk = new TemplateChunk(template, body, values || emptyValues);
+  return stream.Duplex.prototype.write.call(this, chunk, callback);
+};
+
+
+// Number of bytes buffered for writing, in the socket and in the handle.
+Object.defineProperty(Socket.prototype, 'bufferSize', {
+  get: function() {
+    return this._writableState.length;
+  }
+});
+
+
 Socket.prototype._write = function(chunk, callback) {
-  var self = this;
+  var cb = createWriteCallback(this, callback);
+  var queued;
+  if (chunk instanceof TemplateChunk) {
+    queued = streamBuiltin.writeTemplate(this._handle, chunk.template,
+                                         chunk.body, chunk.values, cb);
+  } else {
+    queued = this._handle.write(chunk, cb);
+  }
+  afterHandleWrite(this, queued, cb);
+};
 
-  var cb = function(status) {
-    self._onwrite(status);
 
-    if (util.isFunction(callback)) {
-      callback(status);
+// Write several chunks with a single vectored write.
+Socket.prototype._writev = function(chunks, callback) {
+  var buffers = chunks;
+  for (var i = 0; i < chunks.length; ++i) {
+    if (chunks[i] instanceof TemplateChunk) {
+      buffers = expandTemplateChunks(chunks);
+      break;
     }
-  };
+  }
+
+  var cb = createWriteCallback(this, callback);
+  afterHandleWrite(this, this._handle.writev(buffers, cb), cb);
+};
+
+
+// Messages written together with other data have their header rendered.
+function expandTemplateChunks(chunks) {
+  var buffers = [];
+  for (var i = 0; i < chunks.length; ++i) {
+    var chunk = chunks[i];
+    if (chunk instanceof TemplateChunk) {
+      buffers.push(chunk.render());
+      if (chunk.body.length > 0) {
+        buffers.push(chunk.body);
+      }
+    } else {
+      buffers.push(chunk);
+    }
+  }
+  return buffers;
+}
+
+
+// Disable Nagle's algorithm and the write coalescing of this socket, for
+// sending small messages with the lowest latency.
+// By default writes made in a tick are sent together at the end of the tick.
+Socket.prototype.setNoDelay = function(noDelay) {
+  var state = this._socketState;
+
+  state.noDelay = util.isUndefined(noDelay) ? true : !!noDelay;
+  if (this._handle && this._handle.setNoDelay) {
+    this._handle.setNoDelay(state.noDelay);
+  }
+
+  return this;
+};
+
+
+// initialDelay - seconds from the last data received to the first keepalive
+//                probe.
+Socket.prototype.setKeepAlive = function(enable, initialDelay) {
+  var state = this._socketState;
+
+  state.keepAlive = !!enable;
+  state.keepAliveDelay = util.isNumber(initialDelay) ? initialDelay : 0;
+  if (this._handle && this._handle.setKeepAlive) {
+    this._handle.setKeepAlive(state.keepAlive, state.keepAliveDelay);
+  }
+
+  return this;
+};
 
-  this._handle.write(chunk, cb);
+
+// Between two sockets, data is moved by the handles once everything buffered
+// in javascript has been written, without emitting 'data' for each chunk.
+Socket.prototype.pipe = function(dest, options) {
+  stream.Readable.prototype.pipe.call(this, dest, options);
+
+  if (dest instanceof Socket) {
+    forwardHandle(this, dest);
+  }
+
+  return dest;
+};
+
+
+// Data forwarded by the handles is not seen by 'data' listeners, so a new
+// listener stops the forwarding.
+Socket.prototype.on = function(ev, cb) {
+  var res = stream.Duplex.prototype.on.call(this, ev, cb);
+  var state = this._socketState;
+  if (ev === 'data' && state.onDataListener) {
+    state.onDataListener();
+  }
+  return res;
+};
+
+
+// Emit 'timeout' after `msecs` milliseconds without reading or writing. The
+// socket is not closed. Zero disables the timeout.
+Socket.prototype.setTimeout = function(msecs, callback) {
+  var state = this._socketState;
+
+  state.timeout = msecs > 0 ? msecs : 0;
+  if (this._handle) {
+    this._handle.setTimeout(state.timeout);
+  }
+
+  if (util.isFunction(callback)) {
+    if (state.timeout) {
+      this.once('timeout', callback);
+    } else {
+      this.removeListener('timeout', callback);
+    }
+  }
+
+  return this;
+};
+
+
+Socket.prototype._ontimeout = function() {
+  this.emit('timeout');
 };
 
 
@@ -181,7 +429,22 @@ Socket.prototype._onread = function(nread, isEOF, buffer) {
     var err = new Error('read error: ' + nread);
     stream.Readable.prototype.error.call(this, err);
   } else if (nread > 0) {
-    stream.Readable.prototype.push.call(this, buffer);
+    if (!stream.Readable.prototype.push.call(this, buffer) &&
+        !state.readStopped && self._handle) {
+      // Consumer is behind, leave the rest in the kernel until `_read()`.
+      state.readStopped = true;
+      self._handle.readStop();
+    }
+  }
+};
+
+
+// Called by readable stream when the buffer has room again.
+Socket.prototype._read = function() {
+  var state = this._socketState;
+  if (state.readStopped && this._handle) {
+    state.readStopped = false;
+    this._handle.readStart();
   }
 };
 
@@ -197,6 +460,138 @@ Socket.prototype._onclose = function() {
 };
 
 
+function createWriteCallback(socket, callback) {
+  return function(status) {
+    socket._onwrite(status);
+
+    if (util.isFunction(callback)) {
+      callback(status);
+    }
+  };
+}
+
+
+// `queued` is the number of bytes the handle put in its write queue, the rest
+// was written directly. When the data fits in the socket buffer nothing is
+// queued and `cb` is not called by the handle.
+function afterHandleWrite(socket, queued, cb) {
+  if (queued > 0) {
+    // Only what libuv still holds counts against the high water mark.
+    socket._setWriteQueueSize(queued);
+  } else {
+    process.nextTick(function() {
+      cb(queued);
+    });
+  }
+}
+
+
+// Hold writes made during this tick to send them with a single write.
+function corkUntilNextTick(socket) {
+  var state = socket._socketState;
+  if (state.tickCorked) {
+    return;
+  }
+
+  state.tickCorked = true;
+  socket.cork();
+
+  process.nextTick(function() {
+    state.tickCorked = false;
+    socket.uncork();
+  });
+}
+
+
+// Let the handle of `src` write directly to the handle of `dest`.
+// Forwarding starts when both are connected and nothing is left in the
+// readable buffer of `src` nor held in the writable buffer of `dest`, so the
+// order of data is kept. It is done only while nothing else listens to 'data'
+// of `src`.
+function forwardHandle(src, dest) {
+  var forwarding = false;
+
+  function canForward() {
+    var rstate = src._readableState;
+    var wstate = dest._writableState;
+
+    // The listener added by pipe() and `retry` below.
+    var ondata = src._events.data;
+    if (!ondata || ondata.length != 2) {
+      return false;
+    }
+
+    return src._handle && dest._handle &&
+           src._socketState.connected && dest._socketState.connected &&
+           rstate.flowing && rstate.length == 0 &&
+           wstate.buffer.length == 0 && !wstate.corked;
+  }
+
+  // Data goes through javascript again until the extra listener is removed.
+  function onDataListener() {
+    if (forwarding && !canForward()) {
+      if (src._handle) {
+        src._handle.forward(null);
+      }
+      forwarding = false;
+    }
+  }
+
+  function tryForward() {
+    if (!forwarding && canForward()) {
+      forwarding = src._handle.forward(dest._handle, onForwardWrite) == 0;
+    }
+  }
+
+  function retry() {
+    // After the writes of this tick are flushed.
+    process.nextTick(tryForward);
+  }
+
+  function onForwardWrite(status) {
+    if (status < 0) {
+      forwarding = false;
+      emitError(dest, new Error('write error: ' + status));
+    }
+  }
+
+  function onunpipe(readable) {
+    if (readable === src) {
+      stop();
+    }
+  }
+
+  function stop() {
+    if (forwarding && src._handle) {
+      src._handle.forward(null);
+    }
+    forwarding = false;
+
+    if (src._socketState.onDataListener === onDataListener) {
+      src._socketState.onDataListener = null;
+    }
+    src.removeListener('data', retry);
+    src.removeListener('connect', retry);
+    src.removeListener('end', stop);
+    dest.removeListener('connect', retry);
+    dest.removeListener('close', stop);
+    dest.removeListener('unpipe', onunpipe);
+  }
+
+  src._socketState.onDataListener = onDataListener;
+
+  // Data still flowing through javascript means forwarding did not start yet.
+  src.on('data', retry);
+  src.on('connect', retry);
+  src.on('end', stop);
+  dest.on('connect', retry);
+  dest.on('close', stop);
+  dest.on('unpipe', onunpipe);
+
+  retry();
+}
+
+
 function emitError(socket, err) {
   socket.emit('error', err);
 }
@@ -219,6 +614,16 @@ function onSocketConnect(socket) {
   state.connecting = false;
   state.connected = true;
 
+  if (socket._handle.setNoDelay && state.noDelay) {
+    socket._handle.setNoDelay(true);
+  }
+  if (socket._handle.setKeepAlive && state.keepAlive) {
+    socket._handle.setKeepAlive(true, state.keepAliveDelay);
+  }
+  if (state.timeout) {
+    socket._handle.setTimeout(state.timeout);
+  }
+
   socket._readyToWrite();
 
   // `readStart` on next tick, after connection event handled.
@@ -282,6 +687,9 @@ function onShutdown(status) {
 
 
 
+var DEFAULT_BACKLOG = 511;
+
+
 function Server(options, connectionListener) {
   if (!(this instanceof Server)) {
     return new Server(options, connectionListener);
@@ -302,6 +710,9 @@ function Server(options, connectionListener) {
 
   this._handle = null;
   this._sockets = [];
+
+  // Accepted sockets stay writable after the peer ended if `true`.
+  this.allowHalfOpen = options.allowHalfOpen || false;
 }
 
 // Server inherits EventEmitter.
@@ -313,10 +724,42 @@ exports.createServer = function(options, callback) {
 };
 
 
-// This is needed for native handler to create TCP instance.
-// Jerry API does not provide functionality for creating object via specific
-// constructor hence native handler could not create such instance by itself.
-Server.prototype._createTCP = createTCP;
+// Creates a reusable header template for `socket.writeTemplate()`.
+// The text is serialized once, `{length}` is replaced by the byte length of
+// the body, `{date}` by the current HTTP date and `{0}` to `{9}` by the
+// values given with each message, strings or integers.
+exports.createTemplate = function(text) {
+  if (!util.isString(text)) {
+    throw new TypeError('template must be a string');
+  }
+  return new streamBuiltin.Template(text);
+};
+
+
+// Returns a socket on a handle that is connected already, like a pipe to a
+// child process. Reading starts on the next tick.
+exports._createConnectedSocket = function(handle, options) {
+  options = options || {};
+  options.handle = handle;
+
+  var socket = new Socket(options);
+  onSocketConnect(socket);
+  return socket;
+};
+
+
+// Default of the `reusePort` option of server.listen(). Set by the cluster
+// module in workers, which share the port of the server.
+exports._reusePort = false;
+
+
+// net.connect(port[, host][, callback])
+// net.connect(path[, callback])
+// net.connect(options[, callback])
+exports.connect = exports.createConnection = function(port, host, callback) {
+  var socket = new Socket();
+  return socket.connect(port, host, callback);
+};
 
 
 Server.prototype.listen = function() {
@@ -328,38 +771,65 @@ Server.prototype.listen = function() {
     self.once('listening', lastArg);
   }
 
-  var address = "127.0.0.1";
-  var port = util.isNumber(arguments[0]) ? arguments[0] : false;
-  var backlog = util.isNumber(arguments[1]) ? arguments[1] : false;
+  // server.listen(port[, host][, backlog][, callback])
+  var args = Array.prototype.slice.call(arguments);
+  if (util.isNumber(args[0]) && !util.isString(args[1])) {
+    args.splice(1, 0, undefined);
+  }
+
+  var host = util.isString(args[1]) ? args[1] : '127.0.0.1';
+  var port = util.isNumber(args[0]) ? args[0] : false;
+  var backlog = util.isNumber(args[2]) ? args[2] : false;
+  var path = util.isString(args[0]) ? args[0] : false;
+  var reusePort = exports._reusePort;
 
   if (util.isObject(arguments[0])) {
     var opt = arguments[0];
     if (util.isNumber(opt.port)) {
       port = opt.port;
     }
+    if (util.isString(opt.host)) {
+      host = opt.host;
+    }
+    if (util.isString(opt.path)) {
+      path = opt.path;
+    }
     if (util.isNumber(opt.backlog)) {
       backlog = opt.backlog;
     }
+    if (util.isBoolean(opt.reusePort)) {
+      reusePort = opt.reusePort;
+    }
   }
 
-  if (!port || !backlog) {
+  if (path) {
+    backlog = backlog || DEFAULT_BACKLOG;
+  } else if (!port || !backlog) {
     throw new Error('invalid argument');
   }
 
   // Create server handle.
   if (!self._handle) {
-    self._handle = createTCP(self);
+    self._handle = path ? createPipe(self) : createTCP(self);
   }
 
-  // bind port
-  var err = self._handle.bind(address, port);
+  // bind port, or path of unix domain socket. IPv6 hosts like '::' accept
+  // IPv4 connections too.
+  var err;
+  if (path) {
+    err = self._handle.bind(path);
+  } else {
+    var address = lookupAddress(host, port);
+    err = util.isNumber(address) ? address :
+          self._handle.bind(address, reusePort ? TCP.REUSEPORT : 0);
+  }
   if (err) {
     self._handle.close();
     return err;
   }
 
-  // listen
-  err = self._handle.listen(backlog);
+  // listen, clients accepted together are delivered at once.
+  err = self._handle.listen(backlog, true);
   if (err) {
     self._handle.close();
     return err;
@@ -395,18 +865,32 @@ Server.prototype._onconnection = function(status, clientHandle) {
     return;
   }
 
+  onConnection(this, clientHandle);
+};
+
+
+// Called with client handles accepted in a loop iteration.
+Server.prototype._onconnections = function(clientHandles) {
+  for (var i = 0; i < clientHandles.length; ++i) {
+    onConnection(this, clientHandles[i]);
+  }
+};
+
+
+function onConnection(server, clientHandle) {
   // Create socket object for connecting client.
   var socket = new Socket({
     handle: clientHandle,
+    allowHalfOpen: server.allowHalfOpen,
   });
 
-  socket.server = this;
+  socket.server = server;
   onSocketConnect(socket);
 
-  this._sockets.push(socket);
+  server._sockets.push(socket);
 
-  this.emit('connection', socket);
-};
+  server.emit('connection', socket);
+}
 
 
 Server.prototype._onclose = function() {
@@ -31,3 +31,4 @@ exports.Stream = Stream;
 exports.Readable = require('stream_readable');
 exports.Writable = require('stream_writable');
 exports.Duplex = require('stream_duplex');
+exports.Transform = require('stream_transform');
@@ -19,6 +19,10 @@ var util = require('util');
 var assert = require('assert');
 
 
+// Default number of bytes buffered before `push()` starts returning `false`.
+var DEFAULT_HIGH_WATER_MARK = 16 * 1024;
+
+
 function ReadableState(options) {
   options = options || {};
 
@@ -28,6 +32,11 @@ function ReadableState(options) {
   // the sum of length of buffers.
   this.length = 0;
 
+  // `push()` returns `false` when `length` reaches this, the concrete stream
+  // should stop reading until `_read()` is called.
+  this.highWaterMark = util.isNumber(options.highWaterMark) ?
+                       options.highWaterMark : DEFAULT_HIGH_WATER_MARK;
+
   this.defaultEncoding = options.defaultEncoding || 'utf8';
 
   // true if in flowing mode.
@@ -72,6 +81,8 @@ Readable.prototype.read = function(n) {
 
   if (state.ended && state.length == 0) {
     emitEnd(this);
+  } else {
+    maybeReadMore(this);
   }
 
   return res;
@@ -109,7 +120,72 @@ Readable.prototype.resume = function() {
     if (state.length > 0) {
       emitData(this, readBuffer(this));
     }
+    if (state.ended) {
+      emitEnd(this);
+    } else {
+      maybeReadMore(this);
+    }
+  }
+  return this;
+};
+
+
+// Write all data of this stream to `dest`, reading is paused while `dest` is
+// full. `dest.end()` is called at the end unless `options.end` is `false`.
+Readable.prototype.pipe = function(dest, options) {
+  var src = this;
+  var endDest = !options || options.end !== false;
+
+  function ondata(chunk) {
+    if (dest.write(chunk) === false) {
+      src.pause();
+    }
+  }
+
+  function ondrain() {
+    src.resume();
+  }
+
+  function onend() {
+    cleanup();
+    if (endDest) {
+      dest.end();
+    }
   }
+
+  function onunpipe(readable) {
+    if (readable === src) {
+      cleanup();
+      // Keep the data for whoever reads next.
+      src.pause();
+    }
+  }
+
+  function cleanup() {
+    src.removeListener('data', ondata);
+    src.removeListener('end', onend);
+    dest.removeListener('drain', ondrain);
+    dest.removeListener('close', cleanup);
+    dest.removeListener('unpipe', onunpipe);
+  }
+
+  dest.on('drain', ondrain);
+  dest.on('close', cleanup);
+  dest.on('unpipe', onunpipe);
+  src.on('end', onend);
+
+  dest.emit('pipe', src);
+
+  // Starts flowing.
+  src.on('data', ondata);
+
+  return dest;
+};
+
+
+// Stop writing to `dest` given to `pipe()`.
+Readable.prototype.unpipe = function(dest) {
+  dest.emit('unpipe', this);
   return this;
 };
 
@@ -119,6 +195,8 @@ Readable.prototype.error = function(error) {
 };
 
 
+// Returns `false` if the buffer is full, the concrete stream should not push
+// more until `_read()` is called.
 Readable.prototype.push = function(chunk, encoding) {
   var state = this._readableState;
 
@@ -143,6 +221,8 @@ Readable.prototype.push = function(chunk, encoding) {
       emitReadable(this);
     }
   }
+
+  return !state.ended && state.length < state.highWaterMark;
 };
 
 
@@ -168,6 +248,17 @@ function readBuffer(stream, n) {
 };
 
 
+// Ask the concrete stream for more data if the buffer has room.
+function maybeReadMore(stream) {
+  var state = stream._readableState;
+  if (!state.ended &&
+      state.length < state.highWaterMark &&
+      util.isFunction(stream._read)) {
+    stream._read();
+  }
+};
+
+
 function emitEnd(stream) {
   var state = stream._readableState;
 
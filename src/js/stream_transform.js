@@ -0,0 +1,126 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+var util = require('util');
+var Duplex = require('stream_duplex');
+
+
+function TransformState() {
+  // Completes the write being transformed, held while the readable side is
+  // full until `_read()` is called.
+  this.pending = null;
+}
+
+
+// Duplex stream whose readable side is computed from what is written.
+// Concrete streams implement `_transform(chunk, callback)` and optionally
+// `_flush(callback)`. Both may push data with `push()`, or pass it to
+// `callback(err, data)`.
+function Transform(options) {
+  if (!(this instanceof Transform)) {
+    return new Transform(options);
+  }
+
+  Duplex.call(this, options);
+
+  this._transformState = new TransformState();
+
+  var self = this;
+  this.once('finish', function() {
+    onFinish(self);
+  });
+
+  this._readyToWrite();
+}
+
+util.inherits(Transform, Duplex);
+
+
+// This function object never to be called. Concrete stream should override
+// this method.
+Transform.prototype._transform = function(chunk, callback) {
+  throw new Error('unreachable');
+};
+
+
+Transform.prototype._flush = function(callback) {
+  callback();
+};
+
+
+Transform.prototype._write = function(chunk, callback) {
+  var self = this;
+
+  this._transform(chunk, function(err, data) {
+    if (!util.isNullOrUndefined(data)) {
+      self.push(data);
+    }
+
+    var done = function() {
+      afterTransform(self, err, callback);
+    };
+
+    // Take no more writes until the reader catches up.
+    var readableState = self._readableState;
+    if (readableState.length < readableState.highWaterMark) {
+      done();
+    } else {
+      self._transformState.pending = done;
+    }
+  });
+};
+
+
+Transform.prototype._read = function() {
+  var state = this._transformState;
+  var pending = state.pending;
+  if (pending) {
+    state.pending = null;
+    pending();
+  }
+};
+
+
+function afterTransform(stream, err, callback) {
+  if (err) {
+    stream.emit('error', err);
+  }
+
+  stream._onwrite(err);
+
+  if (util.isFunction(callback)) {
+    callback(err);
+  }
+}
+
+
+// Everything written is transformed, push what `_flush()` gives and end the
+// readable side.
+function onFinish(stream) {
+  stream._flush(function(err, data) {
+    if (err) {
+      stream.emit('error', err);
+    }
+    if (!util.isNullOrUndefined(data)) {
+      stream.push(data);
+    }
+    stream.push(null);
+  });
+}
+
+
+module.exports = Transform;
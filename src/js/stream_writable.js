@@ -22,6 +22,10 @@ var Duplex = stream.Duplex;
 var streamBuiltin = process.binding(process.binding.stream);
 
 
+// Default number of bytes buffered before `write()` starts returning `false`.
+var DEFAULT_HIGH_WATER_MARK = 16 * 1024;
+
+
 function WriteReq(chunk, callback) {
   this.chunk = chunk;
   this.callback = callback;
@@ -29,9 +33,25 @@ function WriteReq(chunk, callback) {
 
 
 function WritableState(options) {
+  options = options || {};
+
   // buffer of WriteReq
   this.buffer = [];
 
+  // bytes buffered and being written.
+  this.length = 0;
+
+  // bytes of the chunks being written.
+  this.writelen = 0;
+
+  // `write()` returns `false` when `length` reaches this.
+  this.highWaterMark = util.isNumber(options.highWaterMark) ?
+                       options.highWaterMark : DEFAULT_HIGH_WATER_MARK;
+
+  // `true` if `write()` returned `false`, 'drain' will be emitted when all
+  // data is written.
+  this.needDrain = false;
+
   // 'true' if stream is ready to write.
   this.ready = false;
 
@@ -43,6 +63,9 @@ function WritableState(options) {
 
   // become `true` when there are no date to write.
   this.ended = false;
+
+  // number of `cork()` calls not yet balanced by `uncork()`.
+  this.corked = 0;
 }
 
 
@@ -107,6 +130,25 @@ Writable.prototype.end = function(chunk, callback) {
 };
 
 
+// Hold writes in the buffer until `uncork()`. Writes held are flushed at once
+// with `_writev()` if the concrete stream implements it.
+Writable.prototype.cork = function() {
+  var state = this._writableState;
+  state.corked++;
+};
+
+
+Writable.prototype.uncork = function() {
+  var state = this._writableState;
+  if (state.corked) {
+    state.corked--;
+    if (!state.corked) {
+      writeBuffered(this);
+    }
+  }
+};
+
+
 // When stream is ready to write, concrete stream implementation should call
 // this method to inform it.
 Writable.prototype._readyToWrite = function() {
@@ -117,12 +159,33 @@ Writable.prototype._readyToWrite = function() {
 };
 
 
+// Concrete stream implementation may call this during a write to tell that
+// only `size` bytes of the chunks being written are still pending, the rest
+// has been handed to the underlying system.
+Writable.prototype._setWriteQueueSize = function(size) {
+  var state = this._writableState;
+
+  if (size < state.writelen) {
+    state.length -= state.writelen - size;
+    state.writelen = size;
+  }
+};
+
+
 // A chunk of data has been written down to stream.
 Writable.prototype._onwrite = function(status) {
   var state = this._writableState;
 
   state.writing = false;
+  state.length -= state.writelen;
+  state.writelen = 0;
+
   writeBuffered(this);
+
+  if (state.needDrain && state.length == 0) {
+    state.needDrain = false;
+    this.emit('drain');
+  }
 };
 
 
@@ -131,7 +194,9 @@ function writeAfterEnd(stream, callback) {
   var err = new Error('write after end');
   stream.emit('error', err);
   process.nextTick(function(){
-    callback(err);
+    if (util.isFunction(callback)) {
+      callback(err);
+    }
   });
 }
 
@@ -143,26 +208,46 @@ function writeOrBuffer(stream, chunk, callback) {
     chunk = new Buffer(chunk);
   }
 
-  if (!state.ready || state.writing || state.buffer.length > 0) {
-    // stream not yet ready or there is pending request to write.
+  state.length += chunk.length;
+
+  // Tell the producer to wait for 'drain' once too much is pending.
+  var ret = state.length < state.highWaterMark;
+  if (!ret) {
+    state.needDrain = true;
+  }
+
+  if (!state.ready ||
+      state.writing ||
+      state.corked ||
+      state.buffer.length > 0) {
+    // stream not yet ready, corked, or there is pending request to write.
     // push this request into write queue.
     state.buffer.push(new WriteReq(chunk, callback));
   } else {
     // here means there is no pending data. write out.
     doWrite(stream, chunk, callback);
   }
+
+  return ret;
 }
 
 
 function writeBuffered(stream) {
   var state = stream._writableState;
-  if (!state.writing) {
-    if (state.buffer.length == 0) {
-      onEmptyBuffer(stream);
-    } else {
-      var req = state.buffer.shift();
-      doWrite(stream, req.chunk, req.callback);
-    }
+  if (state.writing || state.corked) {
+    return;
+  }
+
+  if (state.buffer.length == 0) {
+    onEmptyBuffer(stream);
+  } else if (state.buffer.length > 1 && util.isFunction(stream._writev)) {
+    // Write out everything buffered at once.
+    var reqs = state.buffer;
+    state.buffer = [];
+    doWritev(stream, reqs);
+  } else {
+    var req = state.buffer.shift();
+    doWrite(stream, req.chunk, req.callback);
   }
 }
 
@@ -176,12 +261,37 @@ function doWrite(stream, chunk, callback) {
 
   // The stream is now writing.
   state.writing = true;
+  state.writelen = chunk.length;
 
   // Write down the chunk data.
   stream._write(chunk, callback, stream._onwrite);
 }
 
 
+function doWritev(stream, reqs) {
+  var state = stream._writableState;
+
+  state.writing = true;
+
+  var chunks = [];
+  for (var i = 0; i < reqs.length; ++i) {
+    chunks.push(reqs[i].chunk);
+    state.writelen += reqs[i].chunk.length;
+  }
+
+  var callback = function(status) {
+    for (var i = 0; i < reqs.length; ++i) {
+      if (util.isFunction(reqs[i].callback)) {
+        reqs[i].callback(status);
+      }
+    }
+  };
+
+  // Write down the chunks with a single call.
+  stream._writev(chunks, callback, stream._onwrite);
+}
+
+
 // No more data to write. if this stream is being finishing, emit 'finish'.
 function onEmptyBuffer(stream) {
   var state = stream._writableState;
@@ -196,6 +306,7 @@ function onEmptyBuffer(stream) {
 function endWritable(stream, callback) {
   var state = stream._writableState;
   state.ending = true;
+  state.corked = 0;
   if (callback) {
     stream.once('finish', callback);
   }
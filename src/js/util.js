@@ -31,6 +31,12 @@ function isNullOrUndefined(arg) {
 exports.isNullOrUndefined = isNullOrUndefined;
 
 
+function isBoolean(arg) {
+  return typeof arg === 'boolean';
+};
+exports.isBoolean = isBoolean;
+
+
 function isNumber(arg) {
   return typeof arg === 'number';
 };
@@ -75,3 +81,21 @@ function inherits(ctor, superCtor) {
   });
 };
 exports.inherits = inherits;
+
+
+// Environment of a child process as `name=value` strings: the variables of
+// this process, overridden and extended by `env`.
+function _envPairs(env) {
+  var pairs = [];
+  var name;
+  for (name in process.env) {
+    if (!env || !(name in env)) {
+      pairs.push(name + '=' + process.env[name]);
+    }
+  }
+  for (name in env) {
+    pairs.push(name + '=' + env[name]);
+  }
+  return pairs;
+};
+exports._envPairs = _envPairs;
@@ -0,0 +1,224 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+// Runs scripts in workers exchanging messages with the main script. The
+// engine is a single instance per process, so a worker is a child process
+// running its own engine and event loop, connected to its parent by a pipe.
+// Messages are JSON values or buffers. Buffers are written straight from
+// their memory and read into the buffer handed to the receiver.
+
+var EventEmitter = require('events').EventEmitter;
+var constants = require('constants');
+var json = require('json');
+var net = require('net');
+var util = require('util');
+
+var Pipe = process.binding(process.binding.pipe);
+var ProcessWrap = process.binding(process.binding.processwrap);
+var workerBuiltin = process.binding(process.binding.worker);
+
+
+// Environment variable telling a worker the descriptor of its channel.
+var WORKER_FD_ENV = 'IOTJS_WORKER_FD';
+
+// Descriptor of the channel in the worker, the one after standard error.
+var CHANNEL_FD = 3;
+
+
+// One end of the channel between a worker and its parent.
+//  keepAlive - if `false` the channel keeps the event loop alive only while
+//              there are 'message' listeners.
+function MessagePort(socket, keepAlive) {
+  EventEmitter.call(this);
+
+  var self = this;
+  var parser = new workerBuiltin.MessageParser();
+
+  this._socket = socket;
+  this._keepAlive = keepAlive;
+  this._closed = false;
+
+  if (!keepAlive) {
+    socket._handle.setRef(false);
+  }
+
+  socket.on('data', function(chunk) {
+    var messages = parser.feed(chunk);
+    if (messages instanceof Error) {
+      self.emit('error', messages);
+      self.close();
+      return;
+    }
+    for (var i = 0; i < messages.length; ++i) {
+      self.emit('message', messages[i]);
+    }
+  });
+  socket.on('error', function(err) {
+    self.emit('error', err);
+  });
+  socket.on('end', function() {
+    self.close();
+  });
+  socket.on('close', function() {
+    self._closed = true;
+    self.emit('close');
+  });
+}
+
+util.inherits(MessagePort, EventEmitter);
+
+
+MessagePort.prototype.on = function(ev, listener) {
+  var res = EventEmitter.prototype.on.call(this, ev, listener);
+  if (ev === 'message' && !this._keepAlive && !this._closed) {
+    this._socket._handle.setRef(true);
+  }
+  return res;
+};
+
+
+// port.postMessage(value)
+// `value` is a buffer, or a value JSON can represent.
+MessagePort.prototype.postMessage = function(value) {
+  if (this._closed) {
+    throw new Error('port is closed');
+  }
+
+  var type = workerBuiltin.BUFFER;
+  var payload = value;
+  if (!util.isBuffer(value)) {
+    var text = json.stringify(value);
+    if (!util.isString(text)) {
+      throw new TypeError('value can not be sent');
+    }
+    type = workerBuiltin.JSON;
+    payload = new Buffer(text);
+  }
+
+  // Both writes go out together at the end of the tick.
+  this._socket.write(workerBuiltin.header(type, payload.length));
+  this._socket.write(payload);
+};
+
+
+MessagePort.prototype.close = function() {
+  if (!this._closed) {
+    this._closed = true;
+    this._socket.destroy();
+  }
+};
+
+
+// new Worker(filename[, options])
+// Starts a worker running the script `filename`.
+//  options.env - additional environment variables of the worker.
+function Worker(filename, options) {
+  if (!(this instanceof Worker)) {
+    return new Worker(filename, options);
+  }
+  if (!util.isString(filename)) {
+    throw new TypeError('filename must be a string');
+  }
+
+  EventEmitter.call(this);
+
+  var env = options && options.env;
+  var envPairs = util._envPairs(env);
+  envPairs.push(WORKER_FD_ENV + '=' + CHANNEL_FD);
+
+  var pipe = new Pipe(null);
+  var handle = new ProcessWrap(this);
+  var err = handle.spawn({
+    file: process.execPath,
+    args: [process.execPath, filename],
+    envPairs: envPairs,
+    stdio: [0, 1, 2, pipe]
+  });
+  if (err) {
+    handle.close();
+    pipe.close();
+    throw new Error('worker failed - status: ' + err);
+  }
+
+  var self = this;
+  var port = new MessagePort(net._createConnectedSocket(pipe), true);
+  port.on('message', function(value) {
+    self.emit('message', value);
+  });
+  port.on('error', function(err) {
+    self.emit('error', err);
+  });
+  port.on('close', function() {
+    maybeExit(self);
+  });
+
+  this.pid = handle.pid;
+  this._handle = handle;
+  this._port = port;
+  this._exitCode = null;
+  this._signalCode = null;
+  // The process may end before its last messages are read, 'exit' waits for
+  // the channel to close as well.
+  this._closesNeeded = 2;
+}
+
+util.inherits(Worker, EventEmitter);
+
+
+Worker.prototype.postMessage = function(value) {
+  this._port.postMessage(value);
+};
+
+
+Worker.prototype.terminate = function() {
+  if (this._handle) {
+    this._handle.kill(constants.SIGTERM);
+  }
+};
+
+
+Worker.prototype._onexit = function(exitCode, signal) {
+  this._handle.close();
+  this._handle = null;
+  this._exitCode = exitCode;
+  this._signalCode = signal;
+
+  maybeExit(this);
+};
+
+
+function maybeExit(worker) {
+  if (--worker._closesNeeded == 0) {
+    worker.emit('exit', worker._exitCode, worker._signalCode);
+  }
+}
+
+
+var channelFd = process.env[WORKER_FD_ENV];
+
+exports.isMainThread = util.isUndefined(channelFd);
+exports.parentPort = null;
+
+if (!exports.isMainThread) {
+  var pipe = new Pipe(null);
+  pipe.open(Number(channelFd));
+  exports.parentPort = new MessagePort(net._createConnectedSocket(pipe), false);
+  // Not inherited by processes this worker starts.
+  delete process.env[WORKER_FD_ENV];
+}
+
+exports.Worker = Worker;
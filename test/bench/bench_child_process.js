@@ -0,0 +1,64 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+// Measures throughput of reading the output of a child process, through a
+// stream and collected by exec().
+// Usage: iotjs bench_child_process.js [megabytes]
+
+var child_process = require('child_process');
+
+
+var megabytes = parseInt(process.argv[2]) || 64;
+var command = 'head -c ' + megabytes * 1024 * 1024 + ' /dev/zero';
+
+
+function report(name, bytes, start) {
+  var elapsed = process.hrtime(start);
+  var seconds = elapsed[0] + elapsed[1] / 1e9;
+  console.log('  ' + name + ': ' +
+              Math.round(bytes / (1024 * 1024) / seconds * 10) / 10 +
+              ' MB/s');
+}
+
+
+function benchStream(next) {
+  var start = process.hrtime();
+  var bytes = 0;
+  var child = child_process.spawn('/bin/sh', ['-c', command]);
+  child.stdout.on('data', function(chunk) {
+    bytes += chunk.length;
+  });
+  child.on('close', function() {
+    report('spawn stdout', bytes, start);
+    next();
+  });
+}
+
+
+function benchExec() {
+  var start = process.hrtime();
+  child_process.exec(command, {
+    encoding: 'buffer',
+    maxBuffer: megabytes * 1024 * 1024
+  }, function(err, stdout) {
+    report('exec', stdout.length, start);
+  });
+}
+
+
+console.log(megabytes + ' MB');
+benchStream(benchExec);
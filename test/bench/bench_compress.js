@@ -0,0 +1,67 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+// Measures compression and decompression throughput of text like payloads.
+// Usage: iotjs bench_compress.js [iterations]
+
+var compress = require('compress');
+
+
+var iterations = parseInt(process.argv[2]) || 20;
+
+
+function payload(size) {
+  var words = ['{"sensor":', '"temp"', ',"value":', '21.5', '}\n', 'id'];
+  var buffer = new Buffer(size);
+  var offset = 0;
+  for (var i = 0; offset < size; ++i) {
+    var word = words[(i * 5 + (i >> 2)) % words.length];
+    offset += buffer.write(word, offset, word.length);
+  }
+  return buffer;
+}
+
+
+function bench(name, bytes, count, fn) {
+  var start = process.hrtime();
+  for (var i = 0; i < count; ++i) {
+    fn();
+  }
+  var elapsed = process.hrtime(start);
+  var seconds = elapsed[0] + elapsed[1] / 1e9;
+  var mb = bytes * count / (1024 * 1024);
+  console.log('  ' + name + ': ' + Math.round(mb / seconds * 10) / 10 +
+              ' MB/s');
+}
+
+
+function run(data, count) {
+  var frame = compress.compressSync(data);
+  console.log(data.length + ' bytes, ratio ' +
+              Math.round(frame.length / data.length * 1000) / 1000);
+
+  bench('compressSync', data.length, count, function() {
+    compress.compressSync(data);
+  });
+  bench('decompressSync', data.length, count, function() {
+    compress.decompressSync(frame);
+  });
+}
+
+
+run(payload(4 * 1024), iterations * 64);
+run(payload(1024 * 1024), iterations);
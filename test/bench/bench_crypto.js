@@ -0,0 +1,65 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Measures digest throughput over firmware sized chunks of 4 KB and 256 KB.
+// Usage: iotjs bench_crypto.js [iterations]
+
+var crypto = require('crypto');
+
+
+var iterations = parseInt(process.argv[2]) || 50;
+
+
+function chunk(size) {
+  var buffer = new Buffer(size);
+  for (var i = 0; i < size; ++i) {
+    buffer.write(String.fromCharCode(65 + i % 26), i, 1);
+  }
+  return buffer;
+}
+
+
+function bench(name, buffer, count, fn) {
+  var start = process.hrtime();
+  for (var i = 0; i < count; ++i) {
+    fn(buffer);
+  }
+  var elapsed = process.hrtime(start);
+  var seconds = elapsed[0] + elapsed[1] / 1e9;
+  var mb = buffer.length * count / (1024 * 1024);
+  console.log('  ' + name + ': ' + Math.round(mb / seconds * 10) / 10 +
+              ' MB/s');
+}
+
+
+function run(buffer, count) {
+  console.log(buffer.length + ' bytes');
+  crypto.getHashes().forEach(function(algorithm) {
+    bench(algorithm, buffer, count, function(data) {
+      crypto.createHash(algorithm).update(data).digest();
+    });
+  });
+  bench('hmac sha256', buffer, count, function(data) {
+    crypto.createHmac('sha256', 'secret').update(data).digest();
+  });
+  bench('crc32()', buffer, count, function(data) {
+    crypto.crc32(data);
+  });
+}
+
+
+run(chunk(4 * 1024), iterations * 64);
+run(chunk(256 * 1024), iterations);
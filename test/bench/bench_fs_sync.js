@@ -0,0 +1,58 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures per call overhead of synchronous fs operations.
+// Usage: iotjs bench_fs_sync.js [iterations]
+
+var fs = require('fs');
+
+
+var iterations = parseInt(process.argv[2]) || 10000;
+var filePath = "../resources/greeting.txt";
+var tmpPath = "../tmp/bench_fs_sync.txt";
+var buffer = new Buffer(64);
+
+
+function bench(name, fn) {
+  var start = process.hrtime();
+  for (var i = 0; i < iterations; ++i) {
+    fn();
+  }
+  var elapsed = process.hrtime(start);
+  var ns = elapsed[0] * 1e9 + elapsed[1];
+  var us = Math.round(ns / iterations / 10) / 100;
+  console.log(name + ': ' + us + ' us/call');
+}
+
+
+bench('statSync', function() {
+  fs.statSync(filePath);
+});
+
+bench('openSync+closeSync', function() {
+  fs.closeSync(fs.openSync(filePath, 'r'));
+});
+
+var rfd = fs.openSync(filePath, 'r');
+bench('readSync', function() {
+  fs.readSync(rfd, buffer, 0, buffer.length, 0);
+});
+fs.closeSync(rfd);
+
+var wfd = fs.openSync(tmpPath, 'w');
+bench('writeSync', function() {
+  fs.writeSync(wfd, buffer, 0, buffer.length, 0);
+});
+fs.closeSync(wfd);
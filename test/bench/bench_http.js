@@ -0,0 +1,130 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Keep-alive load over loopback against the http server. The server runs in
+// a cluster worker, the master generates the load and reports requests per
+// second and latency percentiles.
+// Usage: iotjs bench_http.js [requests] [connections] [template]
+// With `template` responses are written from a pre-serialized header.
+
+var cluster = require('cluster');
+var http = require('http');
+var net = require('net');
+
+var HTTPParser = process.binding(process.binding.httpparser);
+
+
+var port = 1248;
+
+
+if (cluster.isWorker) {
+  var body = new Buffer('{"status":"ok","value":42}');
+  var template = http.createTemplate(200,
+                                     { 'Content-Type': 'application/json' });
+  http.createServer(function(req, res) {
+    if (req.url == '/template') {
+      res.endTemplate(template, body);
+    } else {
+      res.setHeader('Content-Type', 'application/json');
+      res.end(body);
+    }
+  }).listen(port);
+  return;
+}
+
+
+var requests = parseInt(process.argv[2]) || 20000;
+var connections = parseInt(process.argv[3]) || 8;
+var path = process.argv[4] == 'template' ? '/template' : '/status';
+var request = new Buffer('GET ' + path + ' HTTP/1.1\r\n' +
+                         'Host: localhost\r\n\r\n');
+
+var latencies = [];
+var started = 0;
+var finished = 0;
+var start;
+
+var worker = cluster.fork();
+
+
+function toMs(time) {
+  return time[0] * 1e3 + time[1] / 1e6;
+}
+
+
+function connect() {
+  var socket = net.connect(port, '127.0.0.1');
+  var parser = new HTTPParser(HTTPParser.RESPONSE);
+  var sentAt;
+
+  function next() {
+    if (started == requests) {
+      socket.end();
+      return;
+    }
+    started++;
+    sentAt = process.hrtime();
+    socket.write(request);
+  }
+
+  parser._onmessagecomplete = function() {
+    latencies.push(toMs(process.hrtime(sentAt)));
+    if (++finished == requests) {
+      report();
+    }
+    next();
+  };
+
+  socket.on('connect', function() {
+    if (!start) {
+      start = process.hrtime();
+    }
+    next();
+  });
+  socket.on('data', function(data) {
+    parser.execute(data);
+  });
+  socket.on('error', function() {
+    // The worker is not listening yet.
+    if (!start) {
+      setTimeout(connect, 100);
+    }
+  });
+}
+
+
+function report() {
+  var seconds = toMs(process.hrtime(start)) / 1e3;
+  latencies.sort(function(a, b) { return a - b; });
+
+  function percentile(p) {
+    var ms = latencies[Math.min(latencies.length - 1,
+                                Math.floor(latencies.length * p))];
+    return Math.round(ms * 1000) / 1000;
+  }
+
+  console.log(connections + ' connections, ' + requests + ' requests');
+  console.log('requests/sec: ' + Math.round(requests / seconds));
+  console.log('latency p50: ' + percentile(0.5) + ' ms');
+  console.log('latency p99: ' + percentile(0.99) + ' ms');
+
+  worker.kill();
+}
+
+
+for (var i = 0; i < connections; ++i) {
+  connect();
+}
@@ -0,0 +1,87 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures JSON parsing and serialization of config and telemetry documents
+// of about 2 KB and 200 KB, against evaluating the text as javascript.
+// Usage: iotjs bench_json.js [iterations]
+
+var json = require('json');
+
+
+var iterations = parseInt(process.argv[2]) || 100;
+
+
+function config(entries) {
+  var doc = { name: 'gateway', version: '1.0.3', debug: false, modules: [] };
+  for (var i = 0; i < entries; ++i) {
+    doc.modules.push({
+      id: i,
+      name: 'module' + i,
+      enabled: i % 3 != 0,
+      options: { interval: 1000 + i, path: '/dev/sensor' + i, scale: 0.5 }
+    });
+  }
+  return doc;
+}
+
+
+function telemetry(samples) {
+  var doc = { device: 'node-17', start: 1433116800, samples: [] };
+  for (var i = 0; i < samples; ++i) {
+    doc.samples.push({
+      t: 1433116800 + i,
+      temp: 21.5 + (i % 10) / 10,
+      humidity: 40 + i % 7,
+      status: i % 50 ? 'ok' : 'warn'
+    });
+  }
+  return doc;
+}
+
+
+function bench(name, count, fn) {
+  var start = process.hrtime();
+  for (var i = 0; i < count; ++i) {
+    fn();
+  }
+  var elapsed = process.hrtime(start);
+  var ns = elapsed[0] * 1e9 + elapsed[1];
+  var us = Math.round(ns / count / 10) / 100;
+  console.log(name + ': ' + us + ' us/call');
+}
+
+
+function run(label, doc, count) {
+  var text = json.stringify(doc);
+  var buffer = new Buffer(text);
+  console.log(label + ' (' + text.length + ' bytes)');
+
+  bench('  eval', count, function() {
+    process.compile('(' + text + ');');
+  });
+  bench('  parse string', count, function() {
+    json.parse(text);
+  });
+  bench('  parse buffer', count, function() {
+    json.parse(buffer);
+  });
+  bench('  stringify', count, function() {
+    json.stringify(doc);
+  });
+}
+
+
+run('config', config(16), iterations * 10);
+run('telemetry', telemetry(2500), iterations);
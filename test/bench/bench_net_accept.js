@@ -0,0 +1,70 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures how fast a server accepts connections when many clients connect
+// at once, like devices reconnecting after a broker restart.
+// Usage: iotjs bench_net_accept.js [connections] [rounds]
+
+var net = require('net');
+
+
+var connections = parseInt(process.argv[2]) || 500;
+var rounds = parseInt(process.argv[3]) || 5;
+var port = 1242;
+var backlog = 511;
+
+var server = net.createServer();
+var accepted = 0;
+var round = 0;
+var start;
+var total = 0;
+
+server.listen(port, backlog);
+
+server.on('connection', function(socket) {
+  socket.destroy();
+  if (++accepted == connections) {
+    var elapsed = process.hrtime(start);
+    var sec = elapsed[0] + elapsed[1] / 1e9;
+    var rate = Math.round(connections / sec);
+    console.log('round ' + round + ': ' + rate + ' connections/sec');
+    total += rate;
+    nextRound();
+  }
+});
+
+
+function storm() {
+  accepted = 0;
+  start = process.hrtime();
+  for (var i = 0; i < connections; ++i) {
+    var client = net.connect(port, '127.0.0.1');
+    client.on('end', client.destroy);
+    client.on('error', function() {});
+  }
+}
+
+
+function nextRound() {
+  if (++round > rounds) {
+    console.log('average: ' + Math.round(total / rounds) + ' connections/sec');
+    server.close();
+    return;
+  }
+  storm();
+}
+
+
+nextRound();
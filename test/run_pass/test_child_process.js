@@ -0,0 +1,97 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+var assert = require('assert');
+var child_process = require('child_process');
+
+
+var results = {};
+
+
+// Output of a child read from a stream.
+var echo = child_process.spawn('echo', ['hello', 'world']);
+var echoed = '';
+echo.stdout.on('data', function(chunk) {
+  assert(chunk instanceof Buffer);
+  echoed += chunk.toString();
+});
+echo.on('exit', function(code, signal) {
+  results.echoExit = code;
+});
+echo.on('close', function(code) {
+  results.echo = echoed;
+});
+
+
+// Input written to a child comes back.
+var cat = child_process.spawn('cat');
+var catted = '';
+cat.stdout.on('data', function(chunk) {
+  catted += chunk.toString();
+});
+cat.on('close', function(code) {
+  results.cat = catted;
+  results.catExit = code;
+});
+cat.stdin.write('line 1\n');
+cat.stdin.end('line 2\n');
+
+
+// Output collected by exec.
+child_process.exec('echo out; echo err 1>&2; exit 3',
+                   function(err, stdout, stderr) {
+  assert(err instanceof Error);
+  results.execCode = err.code;
+  results.execOut = stdout;
+  results.execErr = stderr;
+});
+
+child_process.exec('head -c 100000 /dev/zero', { encoding: 'buffer' },
+                   function(err, stdout, stderr) {
+  assert.equal(err, null);
+  assert(stdout instanceof Buffer);
+  results.execLength = stdout.length;
+  results.execErrLength = stderr.length;
+});
+
+child_process.exec('head -c 100000 /dev/zero',
+                   { encoding: 'buffer', maxBuffer: 1000 },
+                   function(err, stdout, stderr) {
+  assert(err instanceof Error);
+  results.maxBufferLength = stdout.length;
+});
+
+
+var missing = child_process.spawn('/nonexistent/program');
+missing.on('error', function(err) {
+  results.missing = true;
+});
+
+
+process.on('exit', function() {
+  assert.equal(results.echoExit, 0);
+  assert.equal(results.echo, 'hello world\n');
+  assert.equal(results.cat, 'line 1\nline 2\n');
+  assert.equal(results.catExit, 0);
+  assert.equal(results.execCode, 3);
+  assert.equal(results.execOut, 'out\n');
+  assert.equal(results.execErr, 'err\n');
+  assert.equal(results.execLength, 100000);
+  assert.equal(results.execErrLength, 0);
+  assert.equal(results.maxBufferLength, 1000);
+  assert.equal(results.missing, true);
+});
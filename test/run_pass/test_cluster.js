@@ -0,0 +1,59 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var cluster = require('cluster');
+var net = require('net');
+var assert = require('assert');
+
+
+var port = 1241;
+var workers = 2;
+
+if (cluster.isMaster) {
+  var exitCodes = [];
+
+  // The master listens too, workers can bind the same port only with
+  // SO_REUSEPORT.
+  var server = net.createServer();
+  server.listen({ port: port, backlog: 5, reusePort: true });
+
+  // Workers are started with the same arguments as the master.
+  for (var i = 0; i < workers; ++i) {
+    cluster.fork({ MASTER_ARGV: process.argv.slice(1).join(' ') });
+  }
+
+  cluster.on('exit', function(worker, exitCode, signal) {
+    exitCodes.push(exitCode);
+    if (exitCodes.length == workers) {
+      server.close();
+    }
+  });
+
+  process.on('exit', function() {
+    assert.equal(exitCodes.length, workers);
+    for (var i = 0; i < workers; ++i) {
+      assert.equal(exitCodes[i], 0);
+    }
+  });
+} else {
+  assert(cluster.worker.id >= 1 && cluster.worker.id <= workers);
+  assert.equal(process.argv.slice(1).join(' '), process.env.MASTER_ARGV);
+
+  var server = net.createServer();
+  var err = server.listen(port, 5);
+  server.close();
+
+  process.exit(err ? 1 : 0);
+}
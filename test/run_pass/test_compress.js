@@ -0,0 +1,122 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+var assert = require('assert');
+var compress = require('compress');
+
+
+function text(size) {
+  var words = ['sensor ', 'value ', 'temperature ', 'humidity ', '42 '];
+  var result = '';
+  for (var i = 0; result.length < size; ++i) {
+    result += words[(i * 7 + (i >> 3)) % words.length];
+  }
+  return result.substring(0, size);
+}
+
+
+function piece(buffer, start, end) {
+  var result = new Buffer(end - start);
+  buffer.copy(result, 0, start, end);
+  return result;
+}
+
+
+// One-shot round trips, empty input and input of several blocks.
+var small = text(1000);
+var large = text(3 * compress.BLOCK_SIZE + 123);
+
+[ '', small, large ].forEach(function(data) {
+  var frame = compress.compressSync(data);
+  assert(frame instanceof Buffer);
+  assert.equal(compress.decompressSync(frame).toString(), data);
+});
+assert(compress.compressSync(large).length < large.length / 2);
+
+assert.throws(function() {
+  compress.decompressSync(new Buffer('not a compressed frame'));
+}, Error);
+
+// A one byte block claiming 64 KB of data.
+assert.throws(function() {
+  compress.decompressSync(new Buffer('\x01\x00\x00\x00\x00\x00\x01\x00\x00'));
+}, Error);
+
+
+// Callbacks, the large buffer is processed on the threadpool.
+var calls = 0;
+[ small, large ].forEach(function(data) {
+  compress.compress(data, function(err, frame) {
+    assert.equal(err, null);
+    compress.decompress(frame, function(err, result) {
+      assert.equal(err, null);
+      assert.equal(result.toString(), data);
+      calls++;
+    });
+  });
+});
+
+compress.decompress(new Buffer('garbage'), function(err, result) {
+  assert(err instanceof Error);
+  calls++;
+});
+
+
+// Streams, written in chunks that do not line up with blocks.
+var frame = compress.compressSync(large);
+var compressed = [];
+var decompressed = [];
+var errors = 0;
+
+var compressor = compress.createCompress();
+compressor.on('data', function(chunk) {
+  compressed.push(chunk);
+});
+compressor.on('end', function() {
+  var result = compress.decompressSync(Buffer.concat(compressed));
+  assert.equal(result.toString(), large);
+});
+for (var i = 0; i < large.length; i += 5000) {
+  compressor.write(large.substring(i, i + 5000));
+}
+compressor.end();
+
+var decompressor = compress.createDecompress();
+decompressor.on('data', function(chunk) {
+  decompressed.push(chunk);
+});
+decompressor.on('end', function() {
+  assert.equal(Buffer.concat(decompressed).toString(), large);
+});
+for (var i = 0; i < frame.length; i += 3) {
+  decompressor.write(piece(frame, i, Math.min(i + 3, frame.length)));
+}
+decompressor.end();
+
+var truncated = compress.createDecompress();
+truncated.on('error', function(err) {
+  errors++;
+});
+truncated.on('data', function(chunk) {});
+truncated.end(piece(frame, 0, frame.length - 1));
+
+
+process.on('exit', function() {
+  assert.equal(calls, 3);
+  assert.equal(compressed.length, 4);
+  assert.equal(errors, 1);
+});
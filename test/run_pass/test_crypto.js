@@ -0,0 +1,122 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+var assert = require('assert');
+var crypto = require('crypto');
+
+
+function hex(algorithm, data) {
+  return crypto.createHash(algorithm).update(data).digest('hex');
+}
+
+
+assert.equal(hex('md5', ''), 'd41d8cd98f00b204e9800998ecf8427e');
+assert.equal(hex('md5', 'abc'), '900150983cd24fb0d6963f7d28e17f72');
+assert.equal(hex('sha1', 'abc'), 'a9993e364706816aba3e25717850c26c9cd0d89d');
+assert.equal(hex('sha256', 'abc'),
+             'ba7816bf8f01cfea414140de5dae2223' +
+             'b00361a396177a9cb410ff61f20015ad');
+assert.equal(hex('crc32', '123456789'), 'cbf43926');
+
+
+// Data fed in pieces that do not line up with blocks.
+var text = '';
+for (var i = 0; i < 1000; ++i) {
+  text += 'a';
+}
+var sha1 = crypto.createHash('sha1');
+var sha256 = crypto.createHash('sha256');
+for (var i = 0; i < 1000; i += 7) {
+  var piece = new Buffer(text.substring(i, i + 7));
+  sha1.update(piece);
+  sha256.update(piece);
+}
+assert.equal(sha1.digest('hex'), '291e9a6c66994949b57ba5e650361e98fc36b1ba');
+var digest = sha256.digest();
+assert(digest instanceof Buffer);
+assert.equal(digest.length, 32);
+assert.equal(hex('sha256', text),
+             '41edece42d63e8d9bf515a9ba6932e1c' +
+             '20cbc9f5a5d134645adb5db1b9737ea3');
+
+assert.throws(function() {
+  sha256.digest();
+}, Error);
+assert.throws(function() {
+  crypto.createHash('sha3');
+}, Error);
+
+
+// HMAC, RFC 2202 and RFC 4231 test case 2, and a key longer than a block.
+var data = 'what do ya want for nothing?';
+assert.equal(crypto.createHmac('md5', 'Jefe').update(data).digest('hex'),
+             '750c783e6ab0b503eaa86e310a5db738');
+assert.equal(crypto.createHmac('sha1', 'Jefe').update(data).digest('hex'),
+             'effcdf6ae5eb2fa2d27416d5f184df9c259a7c79');
+assert.equal(crypto.createHmac('sha256', new Buffer('Jefe'))
+                   .update(data).digest('hex'),
+             '5bdcc146bf60754e6a042426089575c7' +
+             '5a003f089d2739839dec58b964ec3843');
+
+var longKey = '';
+for (var i = 0; i < 100; ++i) {
+  longKey += 'k';
+}
+assert.equal(crypto.createHmac('sha256', longKey).update('abc').digest('hex'),
+             'b58b2b694fdba0dd76da3ebe99174f72' +
+             '8d327560f36ece224e90867972479922');
+
+assert.throws(function() {
+  crypto.createHmac('crc32', 'key');
+}, Error);
+
+
+// CRC32 continued over chunks.
+assert.equal(crypto.crc32('hello world'), 222957957);
+assert.equal(crypto.crc32(' world', crypto.crc32('hello')), 222957957);
+
+
+// Digests computed asynchronously, the large one on the threadpool.
+var large = new Buffer(100 * 1024);
+for (var i = 0; i < large.length; i += text.length) {
+  large.write(text, i, text.length);
+}
+var digests = 0;
+crypto.digest('sha1', 'abc', 'hex', function(err, digest) {
+  assert.equal(err, null);
+  assert.equal(digest, 'a9993e364706816aba3e25717850c26c9cd0d89d');
+  digests++;
+});
+crypto.digest('sha256', large, function(err, digest) {
+  assert.equal(err, null);
+  assert(digest instanceof Buffer);
+  assert.equal(digest.length, 32);
+  digests++;
+});
+crypto.digest('md5', large, 'hex', function(err, digest) {
+  assert.equal(err, null);
+  assert.equal(digest, hex('md5', large));
+  digests++;
+});
+crypto.digest('sha3', large, function(err, digest) {
+  assert(err instanceof Error);
+  digests++;
+});
+
+process.on('exit', function() {
+  assert.equal(digests, 4);
+});
@@ -0,0 +1,92 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var dgram = require('dgram');
+var assert = require('assert');
+
+
+var port = 41234;
+var count = 6;
+var received = [];
+var sent = 0;
+var closed = 0;
+var batches = 0;
+
+var server = dgram.createSocket('udp4');
+
+// Datagrams received in the same loop iteration are delivered together.
+var onmessage = server._onmessage;
+server._onmessage = function(status, batch) {
+  batches++;
+  onmessage.call(this, status, batch);
+};
+
+server.on('message', function(msg, rinfo) {
+  received.push(msg.toString());
+  assert.equal(rinfo.address, '127.0.0.1');
+  assert.equal(rinfo.size, msg.length);
+
+  if (received.length == count) {
+    server.close();
+    client.close();
+  }
+});
+
+server.on('close', function() {
+  closed++;
+});
+
+var client = dgram.createSocket('udp4');
+
+client.on('close', function() {
+  closed++;
+});
+
+server.bind(port, '127.0.0.1', function() {
+  assert.equal(server.address().port, port);
+
+  for (var i = 0; i < count - 2; ++i) {
+    client.send(new Buffer('msg' + i), port, '127.0.0.1', function(err) {
+      assert.equal(err, null);
+      sent++;
+    });
+  }
+
+  // Several buffers sent as a single datagram.
+  client.send(['msg', new Buffer('' + (count - 2))], port, '127.0.0.1',
+              function(err) {
+    assert.equal(err, null);
+    sent++;
+  });
+
+  // An empty list is an empty datagram.
+  client.send([], port, '127.0.0.1', function(err) {
+    assert.equal(err, null);
+    sent++;
+  });
+});
+
+
+process.on('exit', function() {
+  assert.equal(sent, count);
+  assert.equal(received.length, count);
+  for (var i = 0; i < count - 1; ++i) {
+    assert.notEqual(received.indexOf('msg' + i), -1);
+  }
+  assert.notEqual(received.indexOf(''), -1);
+  assert.equal(closed, 2);
+  // All datagrams are sent in one tick, more than one arrives per callback.
+  assert.equal(batches < count, true);
+});
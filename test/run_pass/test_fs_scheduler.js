@@ -0,0 +1,101 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var fs = require('fs');
+var assert = require('assert');
+
+
+var filePath = "../tmp/test_fs_scheduler.txt";
+var lines = ['one\n', 'two\n', 'three\n', 'four\n', 'five\n'];
+var expected = lines.join('');
+
+var written = [];
+
+
+var fd = fs.openSync(filePath, 'w');
+
+// Writes issued back to back on the same fd are completed in order even if
+// some of them are merged into a single write.
+for (var i = 0; i < lines.length; ++i) {
+  (function(idx) {
+    var buffer = new Buffer(lines[idx]);
+    fs.write(fd, buffer, 0, buffer.length, function(err, bytes) {
+      assert.equal(err, null);
+      assert.equal(bytes, lines[idx].length);
+      written.push(idx);
+      if (written.length == lines.length) {
+        fs.close(fd, onClose);
+      }
+    });
+  })(i);
+}
+
+
+// Reads the file twice on `fd`. Only one request per fd is in flight, so the
+// second read waits in the lane of the fd.
+function readTwice(fd, callback) {
+  var done = 0;
+  for (var i = 0; i < 2; ++i) {
+    (function() {
+      var buffer = new Buffer(expected.length);
+      fs.read(fd, buffer, 0, buffer.length, 0, function(err, bytesRead) {
+        assert.equal(err, null);
+        assert.equal(bytesRead, expected.length);
+        assert.equal(buffer.toString(), expected);
+        if (++done == 2) {
+          callback();
+        }
+      });
+    })();
+  }
+}
+
+
+function onClose(err) {
+  assert.equal(err, null);
+
+  var rfd = fs.openSync(filePath, 'r');
+
+  // Requests on a high priority fd.
+  fs.setPriority(rfd, fs.PRIORITY_HIGH);
+
+  readTwice(rfd, function() {
+    fs.closeSync(rfd);
+
+    // The descriptor is reused for the next file opened, which should not
+    // inherit the priority of the closed one.
+    var fd = fs.openSync(filePath, 'r');
+    assert.equal(fd, rfd);
+
+    readTwice(fd, function() {
+      fs.closeSync(fd);
+    });
+    assert.equal(fs.getSchedulerStats().queued, 1);
+    assert.equal(fs.getSchedulerStats().queuedHigh, 0);
+  });
+  assert.equal(fs.getSchedulerStats().queuedHigh, 1);
+}
+
+
+process.on('exit', function() {
+  assert.equal(written.join(','), '0,1,2,3,4');
+
+  var stats = fs.getSchedulerStats();
+  assert.equal(stats.queued, 0);
+  assert.equal(stats.inflight, 0);
+  // open(sync) is not counted. five writes, one close and four reads.
+  assert.equal(stats.dispatched, 10);
+  assert.equal(stats.maxWait >= 0, true);
+});
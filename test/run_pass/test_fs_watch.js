@@ -0,0 +1,50 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var fs = require('fs');
+var assert = require('assert');
+
+
+var filePath = "../tmp/test_fs_watch.txt";
+var changes = 0;
+var closed = false;
+
+fs.closeSync(fs.openSync(filePath, 'w'));
+
+var watcher = fs.watch(filePath, { debounce: 100 }, function(event, name) {
+  changes++;
+});
+
+watcher.on('close', function() {
+  closed = true;
+});
+
+// A burst of writes is reported as a single change.
+var buffer = new Buffer('IoT.js');
+var fd = fs.openSync(filePath, 'w');
+for (var i = 0; i < 5; ++i) {
+  fs.writeSync(fd, buffer, 0, buffer.length);
+}
+fs.closeSync(fd);
+
+setTimeout(function() {
+  watcher.close();
+}, 500);
+
+
+process.on('exit', function() {
+  assert.equal(changes, 1);
+  assert.equal(closed, true);
+});
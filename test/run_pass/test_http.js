@@ -0,0 +1,168 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+var assert = require('assert');
+var http = require('http');
+var net = require('net');
+
+var HTTPParser = process.binding(process.binding.httpparser);
+
+
+// Parser fed one byte at a time.
+var requests = [];
+var bodies = [];
+var parser = new HTTPParser(HTTPParser.REQUEST);
+parser._onheaders = function(info) {
+  requests.push(info);
+  bodies.push('');
+};
+parser._onbody = function(chunk) {
+  bodies[bodies.length - 1] += chunk.toString();
+};
+
+var raw = '\r\nPOST /upload?x=1 HTTP/1.1\r\nHost: a\r\n' +
+          'Transfer-Encoding: chunked\r\n\r\n' +
+          '5\r\nhello\r\n6;ext=1\r\n world\r\n0\r\nTrailer: x\r\n\r\n' +
+          'GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n';
+for (var i = 0; i < raw.length; ++i) {
+  assert.equal(parser.execute(new Buffer(raw[i])), 1);
+}
+assert.equal(parser.finish(), 0);
+
+assert.equal(requests.length, 2);
+assert.equal(requests[0].method, 'POST');
+assert.equal(requests[0].url, '/upload?x=1');
+assert.equal(requests[0].headers[0], 'Host');
+assert.equal(requests[0].headers[1], 'a');
+assert.equal(requests[0].shouldKeepAlive, true);
+assert.equal(bodies[0], 'hello world');
+assert.equal(requests[1].versionMinor, 0);
+assert.equal(requests[1].shouldKeepAlive, true);
+
+var bad = new HTTPParser(HTTPParser.REQUEST);
+assert(bad.execute(new Buffer('GET / HTTP/1.1\r\nBad Header: x\r\n\r\n'))
+       instanceof Error);
+bad.reinitialize(HTTPParser.REQUEST);
+assert(bad.execute(new Buffer('POST / HTTP/1.1\r\nContent-Length: 1\r\n' +
+                              'Transfer-Encoding: chunked\r\n\r\n'))
+       instanceof Error);
+bad.reinitialize(HTTPParser.REQUEST);
+assert(bad.execute(new Buffer('POST / HTTP/1.1\r\n' +
+                              'Transfer-Encoding: gzip\r\n\r\n'))
+       instanceof Error);
+bad.reinitialize(HTTPParser.REQUEST);
+assert(bad.execute(new Buffer('POST / HTTP/1.1\r\n' +
+                              'Transfer-Encoding: chunked\r\n' +
+                              'Transfer-Encoding: chunked\r\n\r\n'))
+       instanceof Error);
+
+// A response with other codings than chunked is read until the end.
+var eofInfo = null;
+var eofBody = '';
+var eofComplete = false;
+var eof = new HTTPParser(HTTPParser.RESPONSE);
+eof._onheaders = function(info) {
+  eofInfo = info;
+};
+eof._onbody = function(chunk) {
+  eofBody += chunk.toString();
+};
+eof._onmessagecomplete = function() {
+  eofComplete = true;
+};
+var eofRaw = 'HTTP/1.1 200 OK\r\nTransfer-Encoding: gzip\r\n\r\nabc';
+assert.equal(eof.execute(new Buffer(eofRaw)), eofRaw.length);
+assert.equal(eofInfo.shouldKeepAlive, false);
+assert.equal(eofComplete, false);
+assert.equal(eof.finish(), 0);
+assert.equal(eofBody, 'abc');
+assert.equal(eofComplete, true);
+
+
+// Server answering pipelined keep-alive requests in order.
+var port = 1247;
+var served = [];
+
+var server = http.createServer(function(req, res) {
+  var body = '';
+  req.on('data', function(chunk) {
+    body += chunk.toString();
+  });
+  req.on('end', function() {
+    served.push(req.method + ' ' + req.url);
+    if (req.url == '/slow') {
+      // Finished after the next response, which must wait.
+      setTimeout(function() {
+        res.end('slow');
+      }, 50);
+    } else if (req.url == '/echo') {
+      res.writeHead(201, { 'X-Length': body.length });
+      res.write(body);
+      res.end();
+    } else {
+      // Line breaks would split the response.
+      assert.throws(function() {
+        res.setHeader('X-Split', 'a\r\nX-Injected: b');
+      }, TypeError);
+      assert.throws(function() {
+        res.setHeader('X-Split\n', 'a');
+      }, TypeError);
+      res.end('fast');
+    }
+  });
+});
+server.listen(port, 5);
+
+var responses = [];
+var responseBodies = [];
+var client = new HTTPParser(HTTPParser.RESPONSE);
+client._onheaders = function(info) {
+  responses.push(info);
+  responseBodies.push('');
+};
+client._onbody = function(chunk) {
+  responseBodies[responseBodies.length - 1] += chunk.toString();
+};
+client._onmessagecomplete = function() {
+  if (responses.length == 3) {
+    socket.end();
+  }
+};
+
+var socket = net.connect(port, '127.0.0.1', function() {
+  socket.write('GET /slow HTTP/1.1\r\nHost: a\r\n\r\n' +
+               'POST /echo HTTP/1.1\r\nContent-Length: 5\r\n\r\nabcde' +
+               'GET /fast HTTP/1.1\r\n\r\n');
+});
+socket.on('data', function(data) {
+  assert.equal(client.execute(data), data.length);
+});
+socket.on('close', function() {
+  server.close();
+});
+
+
+process.on('exit', function() {
+  assert.equal(served.length, 3);
+  assert.equal(responses.length, 3);
+  assert.equal(responses[0].statusCode, 200);
+  assert.equal(responseBodies[0], 'slow');
+  assert.equal(responses[1].statusCode, 201);
+  assert.equal(responses[1].statusMessage, 'Created');
+  assert.equal(responseBodies[1], 'abcde');
+  assert.equal(responses[2].shouldKeepAlive, true);
+  assert.equal(responseBodies[2], 'fast');
+});
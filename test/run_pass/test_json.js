@@ -0,0 +1,95 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+var assert = require('assert');
+var json = require('json');
+
+
+// Parsing.
+var text = '{ "name": "iotjs", "version": 1, "ratio": -0.25e1, ' +
+           '"tags": ["a", "b\\n", "\\u00e9"], "nested": { "ok": true, ' +
+           '"none": null, "off": false }, "empty": {}, "list": [] }';
+
+function check(obj) {
+  assert.equal(obj.name, 'iotjs');
+  assert.equal(obj.version, 1);
+  assert.equal(obj.ratio, -2.5);
+  assert.equal(obj.tags.length, 3);
+  assert.equal(obj.tags[1], 'b\n');
+  assert.equal(obj.tags[2], 'é');
+  assert.equal(obj.nested.ok, true);
+  assert.equal(obj.nested.none, null);
+  assert.equal(obj.nested.off, false);
+  assert.equal(Object.keys(obj.empty).length, 0);
+  assert.equal(obj.list.length, 0);
+}
+
+check(json.parse(text));
+check(json.parse(new Buffer(text)));
+check(process.JSONParse(text));
+
+assert.equal(json.parse(' 12345678901 '), 12345678901);
+assert.equal(json.parse('"plain"'), 'plain');
+
+var bad = ['', '{', '[1,]', '{"a" 1}', '01', '1.', '"\u0001"', 'tru',
+           '{"a":1} x', 'nul'];
+bad.forEach(function(t) {
+  assert.throws(function() { json.parse(t); }, SyntaxError);
+});
+
+var revived = json.parse('{"a":1,"b":2}', function(key, value) {
+  return key == 'a' ? undefined : value;
+});
+assert.equal(revived.a, undefined);
+assert.equal(revived.b, 2);
+
+
+// Serializing.
+assert.equal(json.stringify({ a: 1, b: 'x"y', c: [true, null] }),
+             '{"a":1,"b":"x\\"y","c":[true,null]}');
+assert.equal(json.stringify([undefined, function() {}]), '[null,null]');
+assert.equal(json.stringify({ a: undefined, b: 1 }), '{"b":1}');
+assert.equal(json.stringify(undefined), undefined);
+assert.equal(json.stringify('\t\u0001'), '"\\t\\u0001"');
+assert.equal(json.stringify(1.5), '1.5');
+assert.equal(json.stringify(1e-7), '1e-7');
+assert.equal(json.stringify(NaN), 'null');
+assert.equal(json.stringify({ a: [1] }, null, 2), '{\n  "a": [\n    1\n  ]\n}');
+assert.equal(json.stringify({ toJSON: function() { return 'x'; } }), '"x"');
+assert.equal(json.stringify({ a: 1, b: 2 }, ['b']), '{"b":2}');
+assert.equal(json.stringify({ a: 1, b: 2 }, function(key, value) {
+  return key == 'a' ? undefined : value;
+}), '{"b":2}');
+
+var circular = {};
+circular.self = circular;
+assert.throws(function() { json.stringify(circular); }, TypeError);
+assert.throws(function() {
+  json.stringify(circular, function(key, value) { return value; });
+}, TypeError);
+assert.throws(function() { json.stringify([circular], ['self']); },
+              TypeError);
+
+// Objects referred twice are not circular.
+var shared = { a: 1 };
+assert.equal(json.stringify([shared, shared], function(key, value) {
+  return value;
+}), '[{"a":1},{"a":1}]');
+
+
+// Round trip.
+check(json.parse(json.stringify(json.parse(text))));
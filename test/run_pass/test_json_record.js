@@ -0,0 +1,94 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+var net = require('net');
+var assert = require('assert');
+var json = require('json');
+
+
+// Records split at arbitrary points across chunks.
+var parser = new json.RecordParser();
+var records = [];
+var errors = 0;
+parser.on('record', function(record) { records.push(record); });
+parser.on('error', function(err) { errors++; });
+
+parser.write('{"id":1,"v":"a"}\n{"id":');
+parser.write('2,"v":"b"}\r\n\n');
+parser.write(new Buffer('{"id":3'));
+parser.write('}\nnot json\n[4');
+parser.end(']');
+
+assert.equal(records.length, 4);
+assert.equal(records[0].id, 1);
+assert.equal(records[1].v, 'b');
+assert.equal(records[2].id, 3);
+assert.equal(records[3][0], 4);
+assert.equal(errors, 1);
+
+
+// Overlong lines are dropped up to the next newline.
+var limited = new json.RecordParser({ maxLength: 16 });
+var kept = [];
+var tooLong = 0;
+limited.on('record', function(record) { kept.push(record); });
+limited.on('error', function(err) {
+  assert(err instanceof RangeError);
+  tooLong++;
+});
+limited.write('{"a":"0123456789');
+limited.write('0123456789"}\n{"b":1}\n');
+limited.end();
+assert.equal(kept.length, 1);
+assert.equal(kept[0].b, 1);
+assert.equal(tooLong, 1);
+
+
+// Records from a socket.
+var port = 1246;
+var total = 50;
+var received = [];
+
+var server = net.createServer(function(socket) {
+  var text = '';
+  for (var i = 0; i < total; ++i) {
+    text += '{"seq":' + i + ',"temp":21.5}\n';
+  }
+  // Write in pieces not aligned to the lines.
+  for (var pos = 0; pos < text.length; pos += 7) {
+    socket.write(text.substring(pos, pos + 7));
+  }
+  socket.end();
+});
+server.listen(port, 5);
+
+var socket = net.connect(port, '127.0.0.1');
+var stream = new json.RecordParser();
+stream.on('record', function(record) {
+  received.push(record.seq);
+});
+stream.on('finish', function() {
+  server.close();
+});
+socket.pipe(stream);
+
+
+process.on('exit', function() {
+  assert.equal(received.length, total);
+  for (var i = 0; i < total; ++i) {
+    assert.equal(received[i], i);
+  }
+});
@@ -0,0 +1,55 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var net = require('net');
+var assert = require('assert');
+
+
+var port = 1243;
+var clients = 20;
+var connections = 0;
+var replies = 0;
+
+var server = net.createServer();
+server.listen(port, 32);
+
+server.on('connection', function(socket) {
+  // Every client connecting at once gets its own socket.
+  socket.end('' + connections++);
+  if (connections == clients) {
+    server.close();
+  }
+});
+
+
+for (var i = 0; i < clients; ++i) {
+  (function() {
+    var data = '';
+    var socket = net.connect(port, '127.0.0.1');
+    socket.on('data', function(chunk) {
+      data += chunk;
+    });
+    socket.on('end', function() {
+      assert(Number(data) < clients);
+      replies++;
+    });
+  })();
+}
+
+
+process.on('exit', function() {
+  assert.equal(connections, clients);
+  assert.equal(replies, clients);
+});
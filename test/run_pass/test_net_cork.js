@@ -0,0 +1,65 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var net = require('net');
+var assert = require('assert');
+
+
+var port = 1237;
+var server = net.createServer();
+var received = '';
+var receivedWhileCorked = '';
+var callbacks = 0;
+
+server.listen(port, 5);
+
+server.on('connection', function(socket) {
+  socket.on('data', function(data) {
+    received += data;
+  });
+  socket.on('end', function() {
+    socket.end();
+    server.close();
+  });
+});
+
+
+var socket = net.connect(port, '127.0.0.1', function() {
+  assert.equal(socket.setKeepAlive(true, 10), socket);
+
+  // Corked writes are held until uncork.
+  socket.cork();
+  socket.write('a', function() { callbacks++; });
+  socket.write('b', function() { callbacks++; });
+  socket.write('c', function() { callbacks++; });
+
+  setTimeout(function() {
+    receivedWhileCorked = received;
+    socket.uncork();
+
+    // Writes go out one by one without delay.
+    assert.equal(socket.setNoDelay(), socket);
+    socket.write('d', function() { callbacks++; });
+    socket.end('e');
+  }, 100);
+});
+
+
+process.on('exit', function(code) {
+  assert.equal(code, 0);
+  assert.equal(receivedWhileCorked, '');
+  assert.equal(received, 'abcde');
+  assert.equal(callbacks, 4);
+});
@@ -0,0 +1,72 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var net = require('net');
+var assert = require('assert');
+
+
+var port = 1245;
+var hosts = ['::1', '127.0.0.1', '::1'];
+var received = [];
+
+// Dual-stack server, takes IPv4 clients as well.
+var server = net.createServer();
+server.listen({ port: port, host: '::', backlog: 5 });
+
+server.on('connection', function(socket) {
+  var data = '';
+  socket.on('data', function(chunk) {
+    data += chunk;
+  });
+  socket.on('end', function() {
+    received.push(data);
+    socket.end();
+    if (received.length == hosts.length) {
+      server.close();
+    }
+  });
+});
+
+
+// Connect one after another, the last reuses the parsed address of the first.
+function connectNext(i) {
+  if (i == hosts.length) {
+    return;
+  }
+  var socket = net.connect(port, hosts[i], function() {
+    socket.end(hosts[i]);
+  });
+  socket.on('end', function() {
+    connectNext(i + 1);
+  });
+}
+
+connectNext(0);
+
+
+var errors = 0;
+var bad = net.connect(port, 'not an address');
+bad.on('error', function() {
+  errors++;
+});
+
+
+process.on('exit', function() {
+  assert.equal(received.length, hosts.length);
+  for (var i = 0; i < hosts.length; ++i) {
+    assert.equal(received[i], hosts[i]);
+  }
+  assert.equal(errors, 1);
+});
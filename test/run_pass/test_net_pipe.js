@@ -0,0 +1,57 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var net = require('net');
+var assert = require('assert');
+
+
+var path = '../tmp/test_net_pipe.sock';
+var server = net.createServer();
+var serverClosed = false;
+var msg = '';
+
+server.listen(path, function() {
+  var socket = net.connect(path, function() {
+    socket.write('Hello IoT.js');
+  });
+
+  socket.on('data', function(data) {
+    msg += data;
+  });
+
+  socket.on('end', function() {
+    socket.end();
+  });
+});
+
+server.on('connection', function(socket) {
+  socket.on('data', function(data) {
+    socket.end('Echo: ' + data);
+  });
+  socket.on('close', function() {
+    server.close();
+  });
+});
+
+server.on('close', function() {
+  serverClosed = true;
+});
+
+
+process.on('exit', function(code) {
+  assert.equal(code, 0);
+  assert.equal(msg, 'Echo: Hello IoT.js');
+  assert.equal(serverClosed, true);
+});
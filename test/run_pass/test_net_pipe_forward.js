@@ -0,0 +1,69 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var net = require('net');
+var assert = require('assert');
+
+
+var echoPort = 1239;
+var proxyPort = 1240;
+var size = 256 * 1024;
+var received = [];
+var receivedLength = 0;
+
+// Echo server, a socket piped to itself can not be forwarded natively.
+var echoServer = net.createServer(function(socket) {
+  socket.pipe(socket);
+  echoServer.close();
+});
+echoServer.listen(echoPort, 5);
+
+// Proxy between two sockets.
+var proxyServer = net.createServer(function(client) {
+  var upstream = net.connect(echoPort, '127.0.0.1');
+  client.pipe(upstream);
+  upstream.pipe(client);
+  proxyServer.close();
+});
+proxyServer.listen(proxyPort, 5);
+
+
+// 4KB of different characters, written `count` times.
+var piece = '';
+for (var i = 0; piece.length < 4096; ++i) {
+  piece += String.fromCharCode(0x21 + i % 94);
+}
+var count = size / 4096;
+
+var socket = net.connect(proxyPort, '127.0.0.1', function() {
+  for (var i = 0; i < count; ++i) {
+    socket.write(piece);
+  }
+  socket.end();
+});
+
+socket.on('data', function(chunk) {
+  received.push(chunk);
+  receivedLength += chunk.length;
+});
+
+
+process.on('exit', function() {
+  assert.equal(receivedLength, size);
+  var all = Buffer.concat(received).toString();
+  for (var i = 0; i < count; ++i) {
+    assert.equal(all.substr(i * 4096, 4096), piece);
+  }
+});
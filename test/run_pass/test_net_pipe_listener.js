@@ -0,0 +1,80 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var net = require('net');
+var assert = require('assert');
+
+
+var echoPort = 1251;
+var proxyPort = 1252;
+var size = 64 * 1024;
+var receivedLength = 0;
+var clientSeen = 0;
+var upstreamSeen = 0;
+var upstream = null;
+
+var echoServer = net.createServer(function(socket) {
+  socket.pipe(socket);
+  echoServer.close();
+});
+echoServer.listen(echoPort, 5);
+
+// Proxy between two sockets. Data of the client is also counted by another
+// listener, so it is not forwarded by the handles.
+var proxyServer = net.createServer(function(client) {
+  upstream = net.connect(echoPort, '127.0.0.1');
+  client.pipe(upstream);
+  upstream.pipe(client);
+  client.on('data', function(chunk) {
+    clientSeen += chunk.length;
+  });
+  proxyServer.close();
+});
+proxyServer.listen(proxyPort, 5);
+
+
+var piece = '';
+while (piece.length < 4096) {
+  piece += 'abcdefgh';
+}
+
+function writeHalf() {
+  for (var i = 0; i < size / 2 / piece.length; ++i) {
+    socket.write(piece);
+  }
+}
+
+var socket = net.connect(proxyPort, '127.0.0.1', writeHalf);
+
+socket.on('data', function(chunk) {
+  var before = receivedLength;
+  receivedLength += chunk.length;
+  if (before < size / 2 && receivedLength >= size / 2) {
+    // The echoed data may have been forwarded by now, a listener added to
+    // the upstream socket must still see what comes next.
+    upstream.on('data', function(chunk) {
+      upstreamSeen += chunk.length;
+    });
+    writeHalf();
+    socket.end();
+  }
+});
+
+
+process.on('exit', function() {
+  assert.equal(receivedLength, size);
+  assert.equal(clientSeen, size);
+  assert.equal(upstreamSeen, size / 2);
+});
@@ -0,0 +1,66 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var net = require('net');
+var assert = require('assert');
+
+
+var port = 1238;
+var chunkSize = 64 * 1024;
+var chunks = 8;
+var server = net.createServer();
+var bufferedWhilePaused = -1;
+var received = 0;
+
+server.listen(port, 5);
+
+server.on('connection', function(socket) {
+  var str = 'a';
+  while (str.length < chunkSize) {
+    str += str;
+  }
+  var chunk = new Buffer(str);
+  for (var i = 0; i < chunks; ++i) {
+    socket.write(chunk);
+  }
+  socket.end();
+  server.close();
+});
+
+
+var socket = net.connect(port, '127.0.0.1', function() {
+  // Nobody reads for a while, the socket should stop reading once its buffer
+  // is over the high water mark instead of taking everything in.
+  setTimeout(function() {
+    bufferedWhilePaused = socket._readableState.length;
+
+    socket.on('data', function(data) {
+      received += data.length;
+    });
+    socket.resume();
+  }, 200);
+});
+
+socket.on('end', function() {
+  socket.end();
+});
+
+
+process.on('exit', function() {
+  assert.notEqual(bufferedWhilePaused, -1);
+  assert(bufferedWhilePaused < socket._readableState.highWaterMark +
+                               chunkSize);
+  assert.equal(received, chunkSize * chunks);
+});
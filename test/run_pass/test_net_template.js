@@ -0,0 +1,124 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+var assert = require('assert');
+var http = require('http');
+var net = require('net');
+
+var HTTPParser = process.binding(process.binding.httpparser);
+
+
+// Fields are filled in, unknown names in braces are kept as text.
+var frame = net.createTemplate('MESSAGE\ndestination:{0}\nid:{1}\n' +
+                               'content-length:{length}\n{x}\n');
+assert.equal(frame.render(5, ['/queue/a', 42]).toString(),
+             'MESSAGE\ndestination:/queue/a\nid:42\ncontent-length:5\n{x}\n');
+
+var dated = net.createTemplate('Date: {date}');
+assert(/^Date: \w{3}, \d\d \w{3} \d{4} \d\d:\d\d:\d\d GMT$/.test(
+       dated.render(0, []).toString()));
+
+assert.throws(function() {
+  net.createTemplate('{0}{1}{2}{3}{4}{5}{6}{7}{8}');
+}, RangeError);
+
+
+// Frames written with templates, mixed with plain writes.
+var port = 1249;
+var received = '';
+
+var server = net.createServer(function(socket) {
+  socket.writeTemplate(frame, 'first', ['/queue/a', 1]);
+  socket.write('--\n');
+  socket.writeTemplate(frame, new Buffer('second'), ['/queue/b', 2],
+                       function() {
+    socket.end();
+  });
+});
+server.listen(port, 5);
+
+var socket = net.connect(port, '127.0.0.1');
+socket.on('data', function(data) {
+  received += data.toString();
+});
+socket.on('end', function() {
+  server.close();
+  testHttp();
+});
+
+
+// Responses from a template, in order of pipelined requests.
+var httpPort = 1250;
+var okTemplate = http.createTemplate(200, { 'Content-Type': 'text/plain' });
+var responses = [];
+var responseBodies = [];
+
+function testHttp() {
+  var httpServer = http.createServer(function(req, res) {
+    if (req.url == '/slow') {
+      setTimeout(function() {
+        res.endTemplate(okTemplate, 'slow');
+      }, 50);
+    } else if (req.url == '/header') {
+      res.setHeader('X-Extra', 'yes');
+      res.endTemplate(okTemplate, 'header');
+    } else {
+      res.endTemplate(okTemplate, 'fast');
+    }
+  });
+  httpServer.listen(httpPort, 5);
+
+  var client = new HTTPParser(HTTPParser.RESPONSE);
+  client._onheaders = function(info) {
+    responses.push(info);
+    responseBodies.push('');
+  };
+  client._onbody = function(chunk) {
+    responseBodies[responseBodies.length - 1] += chunk.toString();
+  };
+
+  var httpSocket = net.connect(httpPort, '127.0.0.1', function() {
+    httpSocket.write('GET /slow HTTP/1.1\r\n\r\n' +
+                     'GET /fast HTTP/1.1\r\n\r\n' +
+                     'GET /header HTTP/1.1\r\nConnection: close\r\n\r\n');
+  });
+  httpSocket.on('data', function(data) {
+    assert.equal(client.execute(data), data.length);
+  });
+  httpSocket.on('close', function() {
+    httpServer.close();
+  });
+}
+
+
+process.on('exit', function() {
+  assert.equal(received,
+               'MESSAGE\ndestination:/queue/a\nid:1\ncontent-length:5\n{x}\n' +
+               'first--\n' +
+               'MESSAGE\ndestination:/queue/b\nid:2\ncontent-length:6\n{x}\n' +
+               'second');
+
+  assert.equal(responses.length, 3);
+  assert.equal(responseBodies.join(' '), 'slow fast header');
+  assert.equal(responses[0].shouldKeepAlive, true);
+  assert.equal(responses[0].headers[0], 'Content-Type');
+  assert.equal(responses[0].headers[2], 'Date');
+  assert.equal(responses[0].headers[4], 'Content-Length');
+  assert.equal(responses[0].headers[5], '4');
+  assert.equal(responses[2].shouldKeepAlive, false);
+  assert.notEqual(responses[2].headers.indexOf('X-Extra'), -1);
+});
@@ -0,0 +1,61 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var net = require('net');
+var assert = require('assert');
+
+
+var port = 1244;
+var timeouts = 0;
+var dataBeforeTimeout = 0;
+var received = 0;
+
+var server = net.createServer();
+server.listen(port, 5);
+
+server.on('connection', function(socket) {
+  // Data is sent every 50ms for a while, the 200ms timeout should not fire
+  // until the peer is silent.
+  socket.setTimeout(200, function() {
+    timeouts++;
+    dataBeforeTimeout = received;
+    socket.destroy();
+    server.close();
+  });
+  socket.on('data', function(data) {
+    received += data.length;
+  });
+});
+
+
+var socket = net.connect(port, '127.0.0.1', function() {
+  var count = 0;
+  var timer = setInterval(function() {
+    socket.write('ping');
+    if (++count == 8) {
+      clearInterval(timer);
+    }
+  }, 50);
+});
+
+socket.on('end', function() {
+  socket.end();
+});
+
+
+process.on('exit', function() {
+  assert.equal(timeouts, 1);
+  assert.equal(dataBeforeTimeout, 8 * 4);
+});
@@ -0,0 +1,66 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var net = require('net');
+var assert = require('assert');
+
+
+var port = 1236;
+var count = 100;
+var server = net.createServer();
+var received = '';
+var expected = '';
+var callbacks = [];
+
+server.listen(port, 5);
+
+server.on('connection', function(socket) {
+  socket.on('data', function(data) {
+    received += data;
+  });
+  socket.on('end', function() {
+    socket.end();
+    server.close();
+  });
+});
+
+
+var socket = net.connect(port, '127.0.0.1', function() {
+  // Small writes complete without waiting for the loop, their callbacks are
+  // still called asynchronously and in order.
+  var sync = true;
+  for (var i = 0; i < count; ++i) {
+    expected += 'chunk' + i + ';';
+    (function(i) {
+      socket.write('chunk' + i + ';', function(status) {
+        assert.equal(status, 0);
+        assert.equal(sync, false);
+        callbacks.push(i);
+      });
+    })(i);
+  }
+  sync = false;
+  socket.end();
+});
+
+
+process.on('exit', function(code) {
+  assert.equal(code, 0);
+  assert.equal(received, expected);
+  assert.equal(callbacks.length, count);
+  for (var i = 0; i < count; ++i) {
+    assert.equal(callbacks[i], i);
+  }
+});
@@ -0,0 +1,27 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+var assert = require('assert');
+
+
+var start = process.hrtime();
+assert.equal(start.length, 2);
+assert.equal(start[1] >= 0 && start[1] < 1e9, true);
+
+setTimeout(function() {
+  var elapsed = process.hrtime(start);
+  var ms = elapsed[0] * 1e3 + elapsed[1] / 1e6;
+  assert.equal(ms >= 9, true);
+}, 10);
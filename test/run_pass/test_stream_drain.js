@@ -0,0 +1,67 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+var Writable = require('stream').Writable;
+var util = require('util');
+var assert = require('assert');
+
+
+// Writable completing each write on a timer, like a slow peer.
+function SlowWritable(options) {
+  Writable.call(this, options);
+  this.written = '';
+  this._readyToWrite();
+}
+
+util.inherits(SlowWritable, Writable);
+
+SlowWritable.prototype._write = function(chunk, callback) {
+  var self = this;
+  setTimeout(function() {
+    self.written += chunk.toString();
+    self._onwrite(0);
+    if (callback) {
+      callback(0);
+    }
+  }, 10);
+};
+
+
+var writable = new SlowWritable({ highWaterMark: 10 });
+var drains = 0;
+
+writable.on('drain', function() {
+  drains++;
+  assert.equal(writable._writableState.length, 0);
+});
+
+// 4 bytes each, the third write reaches the high water mark.
+assert.equal(writable.write('abcd'), true);
+assert.equal(writable.write('efgh'), true);
+assert.equal(writable.write('ijkl'), false);
+assert.equal(writable.write('mnop'), false);
+
+writable.once('drain', function() {
+  // Writable again after draining.
+  assert.equal(writable.write('qrst'), true);
+  writable.end();
+});
+
+
+process.on('exit', function() {
+  assert.equal(writable.written, 'abcdefghijklmnopqrst');
+  assert.equal(drains, 1);
+});
@@ -0,0 +1,69 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+var assert = require('assert');
+var worker = require('worker');
+
+
+if (worker.isMainThread) {
+  var child = new worker.Worker(process.argv[1]);
+  var replies = [];
+  var exitCode = -1;
+
+  child.on('message', function(value) {
+    replies.push(value);
+  });
+  child.on('exit', function(code, signal) {
+    exitCode = code;
+  });
+
+  var data = new Buffer(100000);
+  for (var i = 0; i < data.length; i += 10) {
+    data.write('0123456789', i, 10);
+  }
+
+  child.postMessage({ numbers: [1, 2, 3], text: 'sum' });
+  child.postMessage(data);
+  child.postMessage('done');
+
+  process.on('exit', function() {
+    assert.equal(exitCode, 0);
+    assert.equal(replies.length, 2);
+    assert.equal(replies[0].sum, 6);
+    assert(replies[1] instanceof Buffer);
+    assert.equal(replies[1].length, data.length);
+    assert.equal(replies[1].toString(), data.toString());
+  });
+} else {
+  assert(worker.parentPort);
+  // The channel is not passed on to processes the worker starts.
+  assert.equal(process.env.IOTJS_WORKER_FD, undefined);
+
+  worker.parentPort.on('message', function(value) {
+    if (value === 'done') {
+      worker.parentPort.close();
+    } else if (value instanceof Buffer) {
+      worker.parentPort.postMessage(value);
+    } else {
+      var sum = 0;
+      for (var i = 0; i < value.numbers.length; ++i) {
+        sum += value.numbers[i];
+      }
+      worker.parentPort.postMessage({ sum: sum });
+    }
+  });
+}
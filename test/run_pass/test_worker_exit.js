@@ -0,0 +1,44 @@
+/* Copyright 2015 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+var assert = require('assert');
+var worker = require('worker');
+
+
+if (worker.isMainThread) {
+  var child = new worker.Worker(process.argv[1]);
+  var messages = [];
+  var exits = 0;
+
+  child.on('message', function(value) {
+    assert.equal(exits, 0);
+    messages.push(value);
+  });
+  child.on('exit', function(code, signal) {
+    // Messages sent just before exiting come first.
+    assert.equal(code, 0);
+    assert.equal(messages.length, 2);
+    exits++;
+  });
+
+  process.on('exit', function() {
+    assert.equal(exits, 1);
+    assert.equal(messages[0].length, 100000);
+    assert.equal(messages[1], 'bye');
+  });
+} else {
+  // Exits as soon as the messages are written.
+  worker.parentPort.postMessage(new Buffer(100000));
+  worker.parentPort.postMessage('bye');
+}